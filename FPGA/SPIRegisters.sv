@@ -17,66 +17,317 @@ module SPIRegisters (
 		     input  logic pllLocked,
 		     output logic txEnable,
 
+		     // Hardware sweep
+		     output logic [31:0] sweepStep = 0,
+		     output logic [31:0] sweepStop = 0,
+		     output logic [23:0] sweepInterval = 0,
+		     output logic sweepEnable,
+		     output logic sweepLoop,
+
+		     // Reference frequency correction
+		     output logic [23:0] freqCorr = 0,
+
+		     // Exciter waveform table
+		     output logic [1:0] waveTable = 0,
+		     output logic [1:0] waveSteps = 0,
+		     output logic wtWE = 0,
+		     output logic [6:0] wtAddr = 0,
+		     output logic [3:0] wtData = 0,
+		     output logic ditherEnable = 0,
+		     output logic [4:0] ditherWidth = 0,
+
+		     // RF self-measurement (from 180 MHz domain)
+		     output logic [1:0] rfWindow = 0,
+		     input logic [31:0] rfCount,
+		     input logic [7:0] rfGen,
+
+		     // Event log (ring read port clocked by SCLK)
+		     output logic tuningCommit = 0,
+		     output logic logRE,
+		     output logic [7:0] logRAddr,
+		     input logic [15:0] logRData,
+		     input logic [15:0] eventCount,
+
 		     // Frequency counter values (from 90 MHz domain)
 		     input logic [26:0] ppsCount,
-		     input logic [4:0] ppsGen
+		     input logic ppsHalf,
+		     input logic [3:0] ppsGen
 		     );
 
   // --- SPI Domain ---
-  logic [31:0] twRaw = 0;
+  // A frame is 40 bits, optionally followed by a CRC-8 (x^8+x^2+x+1,
+  // init 0) over those 40 bits. The SPI domain only captures the frame;
+  // writes are validated and committed in the 90 MHz domain when NCS
+  // rises, so a corrupted or truncated frame never reaches a register.
   logic [5:0] bitCount = 0;
+  logic [5:0] frameBits = 0;
   logic isWrite = 0;
   logic [6:0] selAddr = 0;
   logic [31:0] writeBuf = 0;
-  tWSPRControl ctrlSPI = initWSPRControl;
+  logic [31:0] frameData = 0;
+  logic [7:0] crc = 0;
+
+  function automatic logic [7:0] crcNext(input logic [7:0] c, input logic d);
+    crcNext = {c[6:0], 1'b0} ^ ((c[7] ^ d) ? 8'h07 : 8'h00);
+  endfunction
 
   always_ff @(posedge fpgaSCLK or posedge fpgaNCS) begin
     if (fpgaNCS) begin
       bitCount <= '0;
     end else begin
       writeBuf <= {writeBuf[30:0], fpgaMOSI};
+      crc <= (bitCount == 0) ? crcNext(8'h00, fpgaMOSI) : crcNext(crc, fpgaMOSI);
       if (bitCount == 0) begin
         isWrite <= fpgaMOSI;
       end else if (bitCount < 8) begin
         selAddr <= {selAddr[5:0], fpgaMOSI};
-      end else if (bitCount == 39 && isWrite) begin
-        if (selAddr == aWSPRControl) ctrlSPI <= {writeBuf[30:0], fpgaMOSI};
-        if (selAddr == aWSPRTuning)  twRaw   <= {writeBuf[30:0], fpgaMOSI};
+      end else if (bitCount == 39) begin
+        frameData <= {writeBuf[30:0], fpgaMOSI};
       end
-      bitCount <= bitCount + 1;
+      // Saturate so overlong frames are rejected rather than aliased
+      if (bitCount != 6'h3F) bitCount <= bitCount + 1;
+      frameBits <= (bitCount == 6'h3F) ? 6'h3F : bitCount + 1;
+    end
+  end
+
+  // --- Readback Shadow (SB_RAM40_4K) ---
+  // Every register has a copy in a pair of 256x16 BRAMs written from
+  // the 90 MHz domain. The SPI domain reads it on the SCLK edge that
+  // completes the address, so the 16-way readback mux is the BRAM's own
+  // decoder rather than a LUT tree. All BRAM writes pause while NCS is
+  // low, so the read never races a write.
+  logic [6:0] readAddr;
+  logic [15:0] rdLo, rdHi;
+  logic [31:0] readBuf;
+  logic        shWE = 0;
+  logic [6:0]  shAddr = 0;
+  logic [31:0] shData = 0;
+
+  assign readAddr = {selAddr[5:0], fpgaMOSI};
+  assign readBuf = {rdHi, rdLo};
+
+  SB_RAM40_4K #(.WRITE_MODE(0), .READ_MODE(0)) shadowLo (
+	.WADDR({4'h0, shAddr}), .WDATA(shData[15:0]), .MASK(16'h0),
+	.WE(shWE), .WCLKE(1'b1), .WCLK(clk_dest),
+	.RADDR({4'h0, readAddr}), .RDATA(rdLo),
+	.RE(bitCount == 7), .RCLKE(1'b1), .RCLK(fpgaSCLK));
+
+  SB_RAM40_4K #(.WRITE_MODE(0), .READ_MODE(0)) shadowHi (
+	.WADDR({4'h0, shAddr}), .WDATA(shData[31:16]), .MASK(16'h0),
+	.WE(shWE), .WCLKE(1'b1), .WCLK(clk_dest),
+	.RADDR({4'h0, readAddr}), .RDATA(rdHi),
+	.RE(bitCount == 7), .RCLKE(1'b1), .RCLK(fpgaSCLK));
+
+  // --- Event Log Burst ---
+  // A read of EventLog that keeps clocking past bit 40 streams the
+  // whole event ring as 16-bit words, ring word 0 first. Each word is
+  // fetched on the SCLK edge before its first bit is due.
+  logic [11:0] burstPos = 0;
+  always_ff @(posedge fpgaSCLK or posedge fpgaNCS) begin
+    if (fpgaNCS) begin
+      burstPos <= '0;
+    end else if (bitCount >= 40) begin
+      burstPos <= burstPos + 12'd1;
     end
   end
 
-  assign fpgaMISO = 1'b0;
+  assign logRE = (bitCount == 39) || (bitCount >= 40 && burstPos[3:0] == 4'hF);
+  assign logRAddr = (bitCount == 39) ? 8'h00 : burstPos[11:4] + 8'h01;
+
+  // MISO changes on the falling edge so it is stable at the next
+  // rising edge, where the master samples it (mode 0). bitCount is
+  // 8..39 during the data phase, selecting readBuf[31..0].
+  logic misoBit = 0;
+  always_ff @(negedge fpgaSCLK or posedge fpgaNCS) begin
+    if (fpgaNCS) begin
+      misoBit <= 1'b0;
+    end else if (isWrite) begin
+      misoBit <= 1'b0;
+    end else if (bitCount >= 8 && bitCount < 40) begin
+      misoBit <= readBuf[5'd7 - bitCount[4:0]];
+    end else if (bitCount >= 40 && selAddr == aWSPREventLog) begin
+      misoBit <= logRData[4'd15 - burstPos[3:0]];
+    end else begin
+      misoBit <= 1'b0;
+    end
+  end
+
+  assign fpgaMISO = misoBit;
+
+  // --- Register File (90 MHz domain) ---
+  tWSPRControl ctrlReg = initWSPRControl;
+  logic [31:0] twReg = 0;
+  logic [31:0] stepReg = 0, stopReg = 0;
+  tWSPRSweepRate rateReg = initWSPRSweepRate;
+  tWSPRFreqCorr corrReg = initWSPRFreqCorr;
+  tWSPRRFGate gateReg = initWSPRRFGate;
+  tWSPRSPIStatus spiReg = initWSPRSPIStatus;
+  tWSPRWaveSel waveReg = initWSPRWaveSel;
+  tWSPRDither ditherReg = initWSPRDither;
 
-  // --- Destination Domain Sync (90 MHz) ---
   logic ncs_s1, ncs_s2, ncs_s3;
-  logic [31:0] tw_sync;
-  logic [7:0]  pwr_sync;
-  logic        tx_sync;
+  logic commit, reject;
 
   always_ff @(posedge clk_dest) begin
     ncs_s1 <= fpgaNCS;
     ncs_s2 <= ncs_s1;
     ncs_s3 <= ncs_s2;
+  end
+
+  // Frame registers are stable from the last SCLK edge until the first
+  // SCLK edge of the next frame, so they can be sampled once NCS is
+  // seen high.
+  always_comb begin
+    commit = 1'b0;
+    reject = 1'b0;
+    if (ncs_s2 && !ncs_s3 && isWrite && frameBits != 0) begin
+      if (frameBits == 6'd48 && crc == 8'h00) commit = 1'b1;
+      else if (frameBits == 6'd40 && !spiReg.crcRequired) commit = 1'b1;
+      else reject = 1'b1;
+    end
+  end
 
+  always_ff @(posedge clk_dest) begin
+    if (reset) begin
+      ctrlReg <= initWSPRControl;
+      twReg <= 0;
+      stepReg <= 0;
+      stopReg <= 0;
+      rateReg <= initWSPRSweepRate;
+      corrReg <= initWSPRFreqCorr;
+      gateReg <= initWSPRRFGate;
+      spiReg <= initWSPRSPIStatus;
+      waveReg <= initWSPRWaveSel;
+      ditherReg <= initWSPRDither;
+    end else if (commit) begin
+      case (selAddr)
+        aWSPRControl:   ctrlReg <= frameData;
+        aWSPRTuning:    twReg <= frameData;
+        aWSPRSweepStep: stepReg <= frameData;
+        aWSPRSweepStop: stopReg <= frameData;
+        aWSPRSweepRate: rateReg <= frameData;
+        aWSPRFreqCorr:  corrReg <= frameData;
+        aWSPRRFGate:    gateReg <= frameData;
+        aWSPRSPIStatus: spiReg.crcRequired <= frameData[0];
+        aWSPRWaveSel:   waveReg <= frameData;
+        aWSPRDither:    ditherReg <= frameData;
+        default: ;
+      endcase
+    end else if (reject) begin
+      // Wraps: the driver compares it modulo 2^16 around each write
+      spiReg.crcErrors <= spiReg.crcErrors + 16'd1;
+    end
+  end
+
+  // --- Shadow Writer (90 MHz domain) ---
+  // After reset every address is rewritten with its reset value. From
+  // then on a committed write goes straight to the shadow, and registers
+  // with live or read-only fields are refreshed round-robin.
+  function automatic logic writable(input logic [6:0] addr);
+    case (addr)
+      aWSPRControl, aWSPRTuning, aWSPRSweepStep, aWSPRSweepStop,
+      aWSPRSweepRate, aWSPRFreqCorr, aWSPRRFGate, aWSPRSPIStatus,
+      aWSPRWaveSel, aWSPRWaveTable, aWSPRDither:
+        writable = 1'b1;
+      default:
+        writable = 1'b0;
+    endcase
+  endfunction
+
+  function automatic logic [31:0] initWord(input logic [6:0] addr);
+    case (addr)
+      aWSPRControl:   initWord = initWSPRControl;
+      aWSPRSweepRate: initWord = initWSPRSweepRate;
+      aWSPRFreqCorr:  initWord = initWSPRFreqCorr;
+      aWSPRRFGate:    initWord = initWSPRRFGate;
+      aWSPRSPIStatus: initWord = initWSPRSPIStatus;
+      aWSPRSig:       initWord = eWSPRSigVal;
+      default:        initWord = 32'h0;
+    endcase
+  endfunction
+
+  logic [4:0] initAddr = 0;          // [4] set when the init sweep is done
+  logic [2:0] statusSel = 0;
+  logic [6:0] statusAddr = 0;
+  logic [31:0] statusData = 0;
+  tWSPRControl liveCtrl;
+  tWSPRRFGate liveGate;
+
+  always_comb begin
+    liveCtrl = ctrlReg;
+    liveCtrl.pllLocked = pllLocked;
+    liveGate = gateReg;
+    liveGate.gen = rfGen;
+  end
+
+  always_ff @(posedge clk_dest) begin
+    // Stage 1: select the next live value
+    statusSel <= (statusSel == 3'd5) ? 3'd0 : statusSel + 3'd1;
+    case (statusSel)
+      3'd0: begin statusAddr <= aWSPRControl;   statusData <= liveCtrl; end
+      3'd1: begin statusAddr <= aWSPRPPS;       statusData <= {ppsCount, ppsHalf, ppsGen}; end
+      3'd2: begin statusAddr <= aWSPRRFCount;   statusData <= rfCount; end
+      3'd3: begin statusAddr <= aWSPRRFGate;    statusData <= liveGate; end
+      3'd4: begin statusAddr <= aWSPREventLog;  statusData <= {16'h0, eventCount}; end
+      default: begin statusAddr <= aWSPRSPIStatus; statusData <= spiReg; end
+    endcase
+
+    // Stage 2: write, init sweep first, then commits, then status
+    shWE <= 1'b0;
+    if (reset) begin
+      initAddr <= 0;
+    end else if (!initAddr[4]) begin
+      shWE <= 1'b1;
+      shAddr <= {3'h0, initAddr[3:0]};
+      shData <= initWord({3'h0, initAddr[3:0]});
+      initAddr <= initAddr + 5'd1;
+    end else if (commit && writable(selAddr)) begin
+      shWE <= 1'b1;
+      shAddr <= selAddr;
+      shData <= frameData;
+    end else if (ncs_s2 && ncs_s3) begin
+      shWE <= 1'b1;
+      shAddr <= statusAddr;
+      shData <= statusData;
+    end
+  end
+
+  // Waveform table entries go straight to the exciter's BRAM
+  tWSPRWaveTable wtEntry;
+  always_comb wtEntry = frameData;
+
+  always_ff @(posedge clk_dest) begin
+    wtWE <= commit && selAddr == aWSPRWaveTable;
+    wtAddr <= {wtEntry.table, wtEntry.step};
+    wtData <= wtEntry.gates;
+  end
+
+  always_ff @(posedge clk_dest) begin
+    tuningCommit <= commit && selAddr == aWSPRTuning;
+  end
+
+  // Registration stage
+  always_ff @(posedge clk_dest) begin
     if (reset) begin
-      tw_sync <= 0;
-      pwr_sync <= 8'hFF;
-      tx_sync <= 0;
       tuningWord <= 0;
       powerThresh <= 8'hFF;
       txEnable <= 0;
+      sweepEnable <= 0;
     end else begin
-      if (ncs_s2 && !ncs_s3) begin 
-        tw_sync <= twRaw;
-        pwr_sync <= ctrlSPI.powerThresh;
-        tx_sync <= ctrlSPI.txEnable;
-      end
-      // Registration stage
-      tuningWord <= tw_sync;
-      powerThresh <= pwr_sync;
-      txEnable <= tx_sync;
+      tuningWord <= twReg;
+      powerThresh <= ctrlReg.powerThresh;
+      txEnable <= ctrlReg.txEnable;
+      sweepStep <= stepReg;
+      sweepStop <= stopReg;
+      sweepInterval <= rateReg.interval;
+      sweepEnable <= ctrlReg.sweepEnable;
+      sweepLoop <= ctrlReg.sweepLoop;
+      freqCorr <= corrReg.corr;
+      rfWindow <= gateReg.window;
+      waveTable <= waveReg.table;
+      waveSteps <= waveReg.steps;
+      ditherEnable <= ditherReg.enable;
+      ditherWidth <= ditherReg.width;
     end
   end
 
@@ -3,153 +3,191 @@
 
 /**
  * WSPRExciter - High-purity RF synthesis for WSPR-ease.
- * 
+ *
  * Optimized Architecture:
- * - Single 33-bit pipelined NCO (adds 2*M per 90MHz clock).
- * - Fast 4-bit mid-cycle overflow prediction.
- * - Walking ring advances by 0, 1, or 2 steps.
+ * - Single 32-bit NCO running SDR at 180 MHz (adds M per clock).
+ * - 4-bit skewed segments, so every stage is one LUT plus one carry.
+ * - Optional LFSR phase dither, added to the tuning word as a first
+ *   difference so the phase is dithered without drifting.
+ * - Step counter advances by 0 or 1 step on the NCO overflow and
+ *   indexes a BRAM of gate patterns (6, 12 or 24 steps per RF cycle)
+ *   that can be reloaded over SPI to try other harmonic cancellation.
+ * - Reset and enable reach the datapath through register trees so no
+ *   control net drives more than a handful of sinks.
  */
 module WSPRExciter (
-    input  wire        clk90,
+    input  wire        clk180,
     input  wire        reset,
     input  wire [31:0] tuningWord,     // M
     input  wire [7:0]  powerThreshold,
     input  wire        txEnable,
 
+    // Waveform table (90 MHz domain, phase-aligned with clk180)
+    input  wire        clk90,
+    input  wire [1:0]  waveTable,
+    input  wire [1:0]  waveSteps,      // 0: 6, 1: 12, 2: 24
+    input  wire        wtWE,
+    input  wire [6:0]  wtAddr,         // {table, step}
+    input  wire [3:0]  wtData,
+
+    // Phase dither
+    input  wire        ditherEnable,
+    input  wire [4:0]  ditherWidth,    // Span is 2^width phase LSBs
+
     output wire        rfPushBase,
     output wire        rfPushPeak,
     output wire        rfPullBase,
-    output wire        rfPullPeak
+    output wire        rfPullPeak,
+    output reg         ringWrap        // Pulses once per RF cycle
     );
 
-  // --- Local Sync ---
+  // --- Local Sync and Control Trees ---
+  // One leaf per pair of NCO segments, one for the ring and one for the
+  // output stage. keep stops yosys merging the duplicates.
   reg rst_l, txEn_l;
-  always_ff @(posedge clk90) begin
-    rst_l  <= reset;
-    txEn_l <= txEnable;
+  (* keep *) reg [5:0] rstTree;
+  (* keep *) reg [1:0] txTree;
+  always_ff @(posedge clk180) begin
+    rst_l   <= reset;
+    txEn_l  <= txEnable;
+    rstTree <= {6{rst_l}};
+    txTree  <= {2{txEn_l}};
+  end
+
+  // --- 1. Dither Source ---
+  // 32-bit Galois LFSR, x^32 + x^22 + x^2 + x + 1. Successive states
+  // are one-bit shifts of each other, so the dither takes bit 7i mod 32
+  // as its bit i; neighbouring samples then share bits only at widely
+  // different weights.
+  reg [31:0] lfsr = 32'h1;
+  reg [31:0] dMask = 0;
+  reg [31:0] dither = 0;
+  reg        dEn_l;
+  reg [4:0]  dWidth_l;
+  always_ff @(posedge clk180) begin
+    dEn_l    <= ditherEnable;
+    dWidth_l <= ditherWidth;
+    lfsr <= {1'b0, lfsr[31:1]} ^ (lfsr[0] ? 32'h80200003 : 32'h0);
+    for (int i = 0; i < 32; i = i + 1) begin
+      dMask[i]  <= dEn_l && (i < dWidth_l);
+      dither[i] <= lfsr[(7 * i) % 32] & dMask[i];
+    end
   end
 
-  // --- 1. Pipelined Tuning Word Delay matching ---
-  wire [32:0] W = {tuningWord, 1'b0}; // 2*M
-  
+  // --- 2. Pipelined Tuning Word and Dither Delay matching ---
+  reg [31:0] M;
   reg [3:0] w_pipe[7:0][7:0];
-  reg [7:0] w_bit32_pipe;
+  reg [3:0] d_pipe[7:0][7:0];
 
-  always_ff @(posedge clk90) begin
+  always_ff @(posedge clk180) begin
+    M <= tuningWord;
     for (int s = 0; s < 8; s = s + 1) begin
-      w_pipe[s][0] <= W[s*4 +: 4];
+      w_pipe[s][0] <= M[s*4 +: 4];
+      d_pipe[s][0] <= dither[s*4 +: 4];
       for (int d = 1; d <= s; d = d + 1) begin
         w_pipe[s][d] <= w_pipe[s][d-1];
+        d_pipe[s][d] <= d_pipe[s][d-1];
       end
     end
-    w_bit32_pipe <= {w_bit32_pipe[6:0], W[32]};
   end
 
-  // --- 2. Segmented 33-bit Accumulator ---
-  reg [3:0] acc[7:0];
-  reg       c[8:0];
-  always_ff @(posedge clk90) begin
-    if (rst_l) begin
-      for (int s = 0; s < 8; s = s + 1) acc[s] <= 0;
-      for (int s = 0; s < 9; s = s + 1) c[s]   <= 0;
-    end else begin
-      {c[0], acc[0]} <= acc[0] + w_pipe[0][0]; 
-      for (int s = 1; s < 8; s = s + 1) begin
-        {c[s], acc[s]} <= acc[s] + w_pipe[s][s] + c[s-1];
-      end
-      c[8] <= w_bit32_pipe[7] + c[7];
+  // --- 3. Dithered Tuning Word ---
+  // W = M + d[n] - d[n-1], skewed like the accumulator. The firmware
+  // keeps the span below M and 2^32 - M, so W never wraps and the
+  // accumulator still carries at most once per sample.
+  reg [3:0] dLast[7:0], e[7:0], mE[7:0], W[7:0];
+  reg       bw[7:0], cw[7:0];
+  always_ff @(posedge clk180) begin
+    for (int s = 0; s < 8; s = s + 1) begin
+      dLast[s] <= d_pipe[s][s];
+      mE[s]    <= w_pipe[s][s];
+    end
+    {bw[0], e[0]} <= {1'b0, d_pipe[0][0]} - {1'b0, dLast[0]};
+    {cw[0], W[0]} <= {1'b0, mE[0]} + {1'b0, e[0]};
+    for (int s = 1; s < 8; s = s + 1) begin
+      {bw[s], e[s]} <= {1'b0, d_pipe[s][s]} - {1'b0, dLast[s]} - {4'h0, bw[s-1]};
+      {cw[s], W[s]} <= {1'b0, mE[s]} + {1'b0, e[s]} + {4'h0, cw[s-1]};
     end
   end
 
-  // Predictive mid-cycle overflow
-  reg comp_res;
-  always_ff @(posedge clk90) begin
-    comp_res <= (acc[7] >= {w_bit32_pipe[7], w_pipe[7][7][3:1]});
+  // --- 4. Segmented 32-bit Accumulator ---
+  reg [3:0] acc[7:0];
+  reg       c[7:0];
+  always_ff @(posedge clk180) begin
+    if (rstTree[0]) {c[0], acc[0]} <= 0;
+    else {c[0], acc[0]} <= acc[0] + W[0];
+    for (int s = 1; s < 8; s = s + 1) begin
+      if (rstTree[s/2]) {c[s], acc[s]} <= 0;
+      else {c[s], acc[s]} <= acc[s] + W[s] + c[s-1];
+    end
   end
 
-  reg [1:0] ovf_full_d1;
-  reg ovf_mid;
-  always_ff @(posedge clk90) begin
-    ovf_full_d1 <= {c[8], c[7]};
-    // c[8], c[7] are from the same cycle as acc[7]. 
-    // comp_res is from the cycle after acc[7].
-    // So we need to delay c bits to match comp_res.
-    ovf_mid <= ovf_full_d1[1] | (ovf_full_d1[0] & comp_res);
+  // --- 5. Step Counter ---
+  reg [1:0] table_l, steps_l;
+  reg [4:0] lastStep = 5'd5;
+  reg [4:0] step = 0;
+  always_ff @(posedge clk180) begin
+    table_l <= waveTable;
+    steps_l <= waveSteps;
+    case (steps_l)
+      2'd1:    lastStep <= 5'd11;
+      2'd2:    lastStep <= 5'd23;
+      default: lastStep <= 5'd5;
+    endcase
   end
 
-  reg [1:0] ovf_full; 
-  always_ff @(posedge clk90) begin
-    ovf_full <= ovf_full_d1;
-  end
+  always_ff @(posedge clk180) begin
+    // The counter wraps exactly once per RF cycle
+    ringWrap <= !rstTree[4] && txTree[0] && c[7] && (step >= lastStep);
 
-  // --- 3. Walking Ring ---
-  reg [5:0] ring = 6'b000001;
-  function [5:0] advance1(input [5:0] r);
-    advance1 = {r[4:0], r[5]};
-  endfunction
-  function [5:0] advance2(input [5:0] r);
-    advance2 = {r[3:0], r[5:4]};
-  endfunction
-
-  always_ff @(posedge clk90) begin
-    if (rst_l || !txEn_l) begin
-      ring <= 6'b000001;
-    end else begin
-      case (ovf_full)
-        2'd0: ring <= ring;
-        2'd1: ring <= advance1(ring);
-        2'd2: ring <= advance2(ring);
-        default: ring <= ring;
-      endcase
+    if (rstTree[4] || !txTree[0]) begin
+      step <= 0;
+    end else if (c[7]) begin
+      step <= (step >= lastStep) ? 5'd0 : step + 5'd1;
     end
   end
 
-  // --- 4. Power Control ---
-  reg [7:0] phaseEnd;
-  always_ff @(posedge clk90) begin
-    phaseEnd <= {acc[7], acc[6]};
-  end
-  
-  reg en1, en2;
+  // --- 6. Power Control ---
+  // Compared against the phase at the end of the current step, delayed
+  // to line up with the table lookup.
+  reg en, en_d;
   reg [7:0] pwrThresh_l;
-  always_ff @(posedge clk90) begin
+  always_ff @(posedge clk180) begin
     pwrThresh_l <= powerThreshold;
-    en1 <= (phaseEnd < pwrThresh_l); // Simplified: use end phase for both
-    en2 <= (phaseEnd < pwrThresh_l);
-  end
-
-  // --- 5. Output Mapping ---
-  function [3:0] ringToGates(input [5:0] r, input en);
-    logic [3:0] gates;
-    begin
-      gates[0] = r[0] | r[1] | r[2];
-      gates[1] = r[1];
-      gates[2] = r[3] | r[4] | r[5];
-      gates[3] = r[4];
-      ringToGates = gates & {4{en}};
-    end
-  endfunction
-
-  reg [3:0] outR, outF;
-  always_ff @(posedge clk90) begin
-    outF <= ringToGates(ovf_mid ? advance1(ring) : ring, en1);
-    case (ovf_full)
-      2'd0: outR <= ringToGates(ring, en2);
-      2'd1: outR <= ringToGates(advance1(ring), en2);
-      2'd2: outR <= ringToGates(advance2(ring), en2);
-      default: outR <= ringToGates(ring, en2);
-    endcase
+    en <= ({acc[7], acc[6]} < pwrThresh_l);
+    en_d <= en;
   end
 
-  reg [3:0] outR_reg, outF_reg;
-  always_ff @(posedge clk90) begin
-    outR_reg <= outR;
-    outF_reg <= outF;
+  // --- 7. Waveform Table ---
+  // Four tables of up to 32 steps, 4 gate bits per entry:
+  // {pullPeak, pullBase, pushPeak, pushBase}. Output voltage is
+  // pushBase + pushPeak - pullBase - pullPeak. Power-up contents:
+  //   0: 6-step 1-2-1 (nulls 3rd and 9th)
+  //   1: 12-step 1,2,2,2,2,1 (5th -37 dBc, 7th -40 dBc, 3rd -15 dBc)
+  //   2: 24-step 0,1,1,2,2,2,2,2,2,1,1,0 (nulls 3rd, 5th -25 dBc, 7th -28 dBc)
+  wire [15:0] tableOut;
+  SB_RAM40_4K #(
+		.WRITE_MODE(0), .READ_MODE(0),
+		.INIT_0(256'h00000000000000000000000000000000000000000004000C0004000100030001),
+		.INIT_2(256'h00000000000000000004000C000C000C000C0004000100030003000300030001),
+		.INIT_4(256'h000C000400040000000000010001000300030003000300030003000100010000),
+		.INIT_5(256'h00000000000000000000000000000000000000040004000C000C000C000C000C)
+		) waveRam (
+			   .WADDR({4'h0, wtAddr}), .WDATA({12'h0, wtData}), .MASK(16'h0),
+			   .WE(wtWE), .WCLKE(1'b1), .WCLK(clk90),
+			   .RADDR({4'h0, table_l, step}), .RDATA(tableOut),
+			   .RE(1'b1), .RCLKE(1'b1), .RCLK(clk180));
+
+  reg [3:0] outR;
+  always_ff @(posedge clk180) begin
+    if (rstTree[5] || !txTree[1]) outR <= 4'h0;
+    else outR <= tableOut[3:0] & {4{en_d}};
   end
 
-  SB_IO #(.PIN_TYPE(6'b011000)) ioPB (.PACKAGE_PIN(rfPushBase), .OUTPUT_CLK(clk90), .D_OUT_0(outR_reg[0]), .D_OUT_1(outF_reg[0]));
-  SB_IO #(.PIN_TYPE(6'b011000)) ioPP (.PACKAGE_PIN(rfPushPeak), .OUTPUT_CLK(clk90), .D_OUT_0(outR_reg[1]), .D_OUT_1(outF_reg[1]));
-  SB_IO #(.PIN_TYPE(6'b011000)) ioLB (.PACKAGE_PIN(rfPullBase), .OUTPUT_CLK(clk90), .D_OUT_0(outR_reg[2]), .D_OUT_1(outF_reg[2]));
-  SB_IO #(.PIN_TYPE(6'b011000)) ioLP (.PACKAGE_PIN(rfPullPeak), .OUTPUT_CLK(clk90), .D_OUT_0(outR_reg[3]), .D_OUT_1(outF_reg[3]));
+  // Registered SDR outputs: the final flop sits in the IOB
+  SB_IO #(.PIN_TYPE(6'b010101)) ioPB (.PACKAGE_PIN(rfPushBase), .OUTPUT_CLK(clk180), .D_OUT_0(outR[0]));
+  SB_IO #(.PIN_TYPE(6'b010101)) ioPP (.PACKAGE_PIN(rfPushPeak), .OUTPUT_CLK(clk180), .D_OUT_0(outR[1]));
+  SB_IO #(.PIN_TYPE(6'b010101)) ioLB (.PACKAGE_PIN(rfPullBase), .OUTPUT_CLK(clk180), .D_OUT_0(outR[2]));
+  SB_IO #(.PIN_TYPE(6'b010101)) ioLP (.PACKAGE_PIN(rfPullPeak), .OUTPUT_CLK(clk180), .D_OUT_0(outR[3]));
 
 endmodule
@@ -0,0 +1,103 @@
+`timescale 1ns / 100ps
+`default_nettype none
+
+/**
+ * EventLog - Timestamps Tuning register commits and GNSS PPS edges.
+ *
+ * Each event is stamped with the clk90 timebase and written to a
+ * 64-entry ring in one SB_RAM40_4K (256x16, four words per entry, most
+ * significant word first). An entry is
+ *
+ *   [63:62] kind: 1 = tuning commit, 2 = PPS, 3 = PPS seen half a
+ *           cycle late (see FreqCounter)
+ *   [61:0]  timebase
+ *
+ * The read port is clocked by SCLK so SPIRegisters can stream the ring
+ * after an EventLog register read. As with the register shadow, ring
+ * writes only start while NCS is high, and eventCount is bumped once
+ * the whole entry is in the RAM.
+ */
+module EventLog (
+    input  wire        clk90,
+    input  wire        reset,
+    input  wire        fpgaNCS,
+    input  wire [63:0] timebase,
+    input  wire        tuningCommit,
+    input  wire        ppsEdge,
+    input  wire        ppsHalf,
+
+    // Burst read port (SPI domain)
+    input  wire        fpgaSCLK,
+    input  wire        logRE,
+    input  wire [7:0]  logRAddr,
+    output wire [15:0] logRData,
+
+    output reg  [15:0] eventCount = 0
+    );
+
+  reg ncs_s1 = 1, ncs_s2 = 1;
+  reg [63:0] tb_d = 0;
+  always_ff @(posedge clk90) begin
+    ncs_s1 <= fpgaNCS;
+    ncs_s2 <= ncs_s1;
+    tb_d   <= timebase;
+  end
+
+  // --- Pending events and ring writer ---
+  // Commits only happen as NCS rises, so at most one of each kind can
+  // be waiting while an SPI transfer holds the writer off.
+  reg        commitPend = 0, ppsPend = 0;
+  reg [63:0] commitEntry = 0, ppsEntry = 0, wEntry = 0;
+  reg [2:0]  wPhase = 0;          // 0 idle, 1-4 write words, 5 publish
+  reg        logWE = 0;
+  reg [7:0]  logWAddr = 0;
+  reg [15:0] logWData = 0;
+
+  always_ff @(posedge clk90) begin
+    logWE <= 1'b0;
+    if (reset) begin
+      commitPend <= 1'b0;
+      ppsPend <= 1'b0;
+      wPhase <= 0;
+      eventCount <= 0;
+    end else begin
+      if (wPhase == 0) begin
+        if (ncs_s2 && commitPend) begin
+          wEntry <= commitEntry;
+          commitPend <= 1'b0;
+          wPhase <= 3'd1;
+        end else if (ncs_s2 && ppsPend) begin
+          wEntry <= ppsEntry;
+          ppsPend <= 1'b0;
+          wPhase <= 3'd1;
+        end
+      end else if (wPhase == 3'd5) begin
+        eventCount <= eventCount + 16'd1;
+        wPhase <= 0;
+      end else begin
+        logWE <= 1'b1;
+        logWAddr <= {eventCount[5:0], wPhase[1:0] - 2'd1};
+        logWData <= wEntry[63:48];
+        wEntry <= {wEntry[47:0], 16'h0};
+        wPhase <= wPhase + 3'd1;
+      end
+
+      // New events override the take above
+      if (tuningCommit) begin
+        commitPend <= 1'b1;
+        commitEntry <= {2'b01, tb_d[61:0]};
+      end
+      if (ppsEdge) begin
+        ppsPend <= 1'b1;
+        ppsEntry <= {1'b1, ppsHalf, tb_d[61:0]};
+      end
+    end
+  end
+
+  SB_RAM40_4K #(.WRITE_MODE(0), .READ_MODE(0)) ring (
+	.WADDR({3'h0, logWAddr}), .WDATA(logWData), .MASK(16'h0),
+	.WE(logWE), .WCLKE(1'b1), .WCLK(clk90),
+	.RADDR({3'h0, logRAddr}), .RDATA(logRData),
+	.RE(logRE), .RCLKE(1'b1), .RCLK(fpgaSCLK));
+
+endmodule
@@ -0,0 +1,87 @@
+`timescale 1ns / 100ps
+`default_nettype none
+
+/**
+ * FreqCorrect - Applies the TCXO frequency correction to the tuning word.
+ *
+ *   wordOut = wordIn + (wordIn * corr) / 2^32
+ *
+ * where `corr` is a signed 24-bit fraction in units of 2^-32
+ * (about 0.23 ppb per LSB, +/-1953 ppm range). The firmware keeps
+ * writing nominal tuning words and only updates `corr` when the
+ * reference is recalibrated.
+ *
+ * The multiply is done on the correction magnitude as four unsigned
+ * 16x16 partial products so each maps onto one SB_MAC16 (synth_ice40
+ * -dsp). Latency is 6 clk90 cycles.
+ */
+module FreqCorrect (
+    input  wire        clk90,
+    input  wire [31:0] wordIn,
+    input  wire [23:0] corr,          // Signed, units of 2^-32
+
+    output reg  [31:0] wordOut
+    );
+
+  // --- 1. Input registers and correction magnitude ---
+  reg [31:0] w1;
+  reg [23:0] mag1;
+  reg        neg1;
+  always_ff @(posedge clk90) begin
+    w1   <= wordIn;
+    neg1 <= corr[23];
+    mag1 <= corr[23] ? (~corr + 24'd1) : corr;
+  end
+
+  // --- 2. Partial products (one DSP each) ---
+  reg [31:0] pLL, pLH, pHL, pHH;
+  reg [31:0] w2;
+  reg        neg2;
+  always_ff @(posedge clk90) begin
+    pLL  <= w1[15:0]  * mag1[15:0];
+    pHL  <= w1[31:16] * mag1[15:0];
+    pLH  <= w1[15:0]  * {8'h0, mag1[23:16]};
+    pHH  <= w1[31:16] * {8'h0, mag1[23:16]};
+    w2   <= w1;
+    neg2 <= neg1;
+  end
+
+  // --- 3. Middle column sum ---
+  reg [32:0] mid3;
+  reg [15:0] llHi3;
+  reg [31:0] hh3, w3;
+  reg        neg3;
+  always_ff @(posedge clk90) begin
+    mid3  <= {1'b0, pHL} + {1'b0, pLH};
+    llHi3 <= pLL[31:16];
+    hh3   <= pHH;
+    w3    <= w2;
+    neg3  <= neg2;
+  end
+
+  // --- 4. Bits [63:16] of the product; only [55:32] can be non-zero ---
+  reg [33:0] midLo4;
+  reg [31:0] hh4, w4;
+  reg        neg4;
+  always_ff @(posedge clk90) begin
+    midLo4 <= {1'b0, mid3} + {18'h0, llHi3};
+    hh4    <= hh3;
+    w4     <= w3;
+    neg4   <= neg3;
+  end
+
+  reg [23:0] delta5;
+  reg [31:0] w5;
+  reg        neg5;
+  always_ff @(posedge clk90) begin
+    delta5 <= hh4[23:0] + {6'h0, midLo4[33:16]};
+    w5     <= w4;
+    neg5   <= neg4;
+  end
+
+  // --- 5. Apply ---
+  always_ff @(posedge clk90) begin
+    wordOut <= neg5 ? (w5 - {8'h0, delta5}) : (w5 + {8'h0, delta5});
+  end
+
+endmodule
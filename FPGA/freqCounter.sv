@@ -1,61 +1,71 @@
 `timescale 1ns / 100ps
 
+/**
+ * FreqCounter - Timestamps GNSS PPS edges against clk90.
+ *
+ * PPS is captured by a DDR input register in its I/O cell, on both
+ * clk90 edges, so each rising edge is placed to within half a clk90
+ * cycle (5.6 ns). ppsHalf is set when the edge was first seen by the
+ * falling-edge register, i.e. half a cycle after the ppsCount sample.
+ * Counts come from the shared Timebase, so they line up with the
+ * EventLog timestamps.
+ */
 module FreqCounter (
 		    input logic clk90,
 		    input logic reset,
 		    input logic fpgaNCS,
 		    input logic samplePPS,
+		    input logic [63:0] clocks,     // Timebase
 		    output logic [26:0] ppsCount,
-		    output logic [4:0] ppsGen
+		    output logic ppsHalf,
+		    output logic [3:0] ppsGen,
+		    output logic ppsLevel,      // Synchronized PPS for other users
+		    output logic ppsEdge,       // Pulses as ppsCount updates
+		    output logic ppsEdgeHalf
 		    );
 
-  // 4-stage pipelined counter to comfortably hit 90MHz
-  reg [6:0] c0 = 0, c1 = 0, c2 = 0, c3 = 0;
-  reg w0, w1, w2;
+  // D_IN_0 is sampled on the rising edge, D_IN_1 on the following
+  // falling edge, so each clk90 cycle yields {late, early} samples.
+  logic ppsRise, ppsFall;
+  SB_IO #(.PIN_TYPE(6'b000000)) ioPPS (.PACKAGE_PIN(samplePPS), .INPUT_CLK(clk90),
+				       .D_IN_0(ppsRise), .D_IN_1(ppsFall));
 
+  logic [1:0] pair_s1 = 0, pair_s2 = 0;
+  logic lastLate = 0;
+  logic risingPPS = 0, halfPPS = 0;
+  logic [26:0] count_d = 0;
   always_ff @(posedge clk90) begin
-    c0 <= c0 + 7'd1;
-    w0 <= (c0 == 7'h7E);
-    
-    if (w0) begin
-      c1 <= c1 + 7'd1;
-      w1 <= (c1 == 7'h7E);
-    end else begin
-      w1 <= 1'b0;
-    end
-
-    if (w1) begin
-      c2 <= c2 + 7'd1;
-      w2 <= (c2 == 7'h7E);
-    end else begin
-      w2 <= 1'b0;
-    end
+    pair_s1 <= {ppsFall, ppsRise};
+    pair_s2 <= pair_s1;
+    lastLate <= pair_s2[1];
 
-    if (w2) begin
-      c3 <= c3 + 7'd1;
-    end
+    // Early sample high after a low late sample: edge in the first half.
+    // Only the late sample high: edge in the second half.
+    risingPPS <= !lastLate && (pair_s2[0] || pair_s2[1]);
+    halfPPS <= !pair_s2[0];
+    count_d <= clocks[26:0];
   end
 
-  wire [27:0] currentCount = {c3, c2, c1, c0};
-
-  logic syncPPS;
-  logic risingPPS;
-  Synchronizer ppsSyncronizer (.clk(clk90), .dIn(samplePPS), .dOut(syncPPS));
-  edgeDetector ppsDetector (.clk(clk90), .sigIn(syncPPS), .risingOut(risingPPS));
+  assign ppsLevel = lastLate;
+  assign ppsEdge = risingPPS;
+  assign ppsEdgeHalf = halfPPS;
 
   // Initialize outputs
   initial begin
     ppsGen = 0;
     ppsCount = 0;
+    ppsHalf = 0;
   end
 
   always_ff @(posedge clk90) begin
     if (reset) begin
       ppsGen <= 0;
       ppsCount <= 0;
+      ppsHalf <= 0;
     end else if (risingPPS) begin
-      ppsGen <= ppsGen + 5'd1;
-      ppsCount <= currentCount[26:0];
+      ppsGen <= ppsGen + 4'd1;
+      ppsCount <= count_d;
+      ppsHalf <= halfPPS;
     end
   end
 
@@ -8,7 +8,9 @@ regs = RegisterSet("WSPR")
 class Control:
   txEnable:     Bit(0, "Enable RF output")
   pllLocked:    Bit(0, "PLL is locked to 180 MHz (Read Only)")
-  reserved:     UInt(0, 22, "Reserved")
+  sweepEnable:  Bit(0, "Run hardware sweep from Tuning word toward SweepStop")
+  sweepLoop:    Bit(0, "Restart sweep at Tuning word when SweepStop is reached")
+  reserved:     UInt(0, 20, "Reserved")
   powerThresh:  UInt(0xFF, 8, "Power Threshold for transmission")
 
 @regs.register(0x01, "32-bit NCO tuning word")
@@ -17,8 +19,72 @@ class Tuning:
 
 @regs.register(0x03, "PPS and GNSS edge tracking")
 class PPS:
-  gen:          UInt(0, 5, "Generation incremented at each PPS falling edge")
-  count:        UInt(0, 27, "FPGA clock count at last PPS falling edge")
+  gen:          UInt(0, 4, "Generation incremented at each PPS edge")
+  half:         Bit(0, "Edge seen half a clock after count (DDR input capture)")
+  count:        UInt(0, 27, "FPGA clock count at last PPS edge")
+
+@regs.register(0x04, "Hardware sweep increment")
+class SweepStep:
+  step:         Int(0, 32, "Signed Q16.16 tuning word increment per sweep step")
+
+@regs.register(0x05, "Hardware sweep end point")
+class SweepStop:
+  word:         UInt(0, 32, "Tuning word at which the sweep stops or restarts")
+
+@regs.register(0x06, "Hardware sweep step interval")
+class SweepRate:
+  interval:     UInt(0, 24, "clk90 cycles per sweep step (minimum 8)")
+  reserved:     UInt(0, 8, "Reserved")
+
+@regs.register(0x07, "Reference frequency correction")
+class FreqCorr:
+  corr:         Int(0, 24, "Signed tuning word correction in units of 2^-32 (~0.23 ppb)")
+  reserved:     UInt(0, 8, "Reserved")
+
+@regs.register(0x08, "RF output cycles in the last PPS window (Read Only)")
+class RFCount:
+  count:        UInt(0, 32, "Walking ring cycles counted over the last completed window")
+
+@regs.register(0x09, "RF self-measurement window")
+class RFGate:
+  window:       Enum(0, 2, [("sec1", 0), ("sec10", 1), ("sec100", 2)], "PPS periods per measurement window")
+  reserved:     UInt(0, 6, "Reserved")
+  gen:          UInt(0, 8, "Incremented when RFCount is updated (Read Only)")
+  reserved2:    UInt(0, 16, "Reserved")
+
+@regs.register(0x0A, "SPI link integrity")
+class SPIStatus:
+  crcRequired:  Bit(0, "Discard write frames without a valid CRC-8 trailer")
+  reserved:     UInt(0, 15, "Reserved")
+  crcErrors:    UInt(0, 16, "Write frames discarded for bad CRC or length, wrapping (Read Only)")
+
+@regs.register(0x0B, "Exciter waveform selection")
+class WaveSel:
+  table:        UInt(0, 2, "Waveform table used by the exciter")
+  reserved:     UInt(0, 6, "Reserved")
+  steps:        Enum(0, 2, [("n6", 0), ("n12", 1), ("n24", 2)], "Steps per RF cycle (tuning word scales with this)")
+  reserved2:    UInt(0, 22, "Reserved")
+
+@regs.register(0x0C, "Exciter waveform table entry write")
+class WaveTable:
+  gates:        UInt(0, 4, "Gate pattern {pullPeak, pullBase, pushPeak, pushBase}")
+  reserved:     UInt(0, 4, "Reserved")
+  step:         UInt(0, 5, "Step within the RF cycle")
+  reserved2:    UInt(0, 3, "Reserved")
+  table:        UInt(0, 2, "Table to write")
+  reserved3:    UInt(0, 14, "Reserved")
+
+@regs.register(0x0D, "Exciter NCO phase dither")
+class Dither:
+  enable:       Bit(0, "Add LFSR phase dither to the NCO to spread truncation spurs")
+  reserved:     UInt(0, 7, "Reserved")
+  width:        UInt(0, 5, "Dither span is 2^width phase LSBs; must stay below M and 2^32 - M")
+  reserved2:    UInt(0, 19, "Reserved")
+
+@regs.register(0x0E, "Event log of tuning commits and PPS edges")
+class EventLog:
+  count:        UInt(0, 16, "Events logged since reset; reading on past bit 40 streams the ring (Read Only)")
+  reserved:     UInt(0, 16, "Reserved")
 
 @regs.register(0x0F, "FPGA Hardware Signature")
 class Sig:
@@ -0,0 +1,111 @@
+`timescale 1ns / 100ps
+`default_nettype none
+
+/**
+ * RFCounter - Self-measurement of the synthesized RF frequency.
+ *
+ * Counts complete walking-ring cycles (one per RF output cycle) over
+ * a window of 1, 10 or 100 GNSS PPS periods. The count runs freely
+ * and each window is the difference of two snapshots, so no RF
+ * cycles are lost at window boundaries.
+ *
+ * Runs in the exciter's 180 MHz domain. The 32-bit counter is built
+ * from 4-bit segments whose carries are registered, so segment s lags
+ * segment 0 by s cycles. Snapshot and subtraction walk the segments
+ * with the same skew, which keeps every carry chain at 4 bits.
+ */
+module RFCounter (
+    input  wire        clk180,
+    input  wire        reset,
+    input  wire        ringWrap,       // One pulse per RF cycle
+    input  wire        samplePPS,
+    input  wire [1:0]  window,         // 0: 1 s, 1: 10 s, 2: 100 s
+
+    output reg  [31:0] rfCount = 0,
+    output reg  [7:0]  rfGen = 0
+    );
+
+  localparam int NSEG = 8;
+
+  // --- Local Sync ---
+  reg rst_l;
+  reg [1:0] win_s = 0, win_l = 0, win_d = 0;
+  always_ff @(posedge clk180) begin
+    rst_l <= reset;
+    win_s <= window;   // From the 90 MHz domain
+    win_l <= win_s;
+    win_d <= win_l;
+  end
+
+  logic syncPPS;
+  logic risingPPS;
+  Synchronizer ppsSyncronizer (.clk(clk180), .dIn(samplePPS), .dOut(syncPPS));
+  edgeDetector ppsDetector (.clk(clk180), .sigIn(syncPPS), .risingOut(risingPPS));
+
+  // --- 1. Skewed free-running cycle counter ---
+  reg [3:0] seg[NSEG-1:0];
+  reg       cy[NSEG-1:0];
+  reg       inc;
+  always_ff @(posedge clk180) begin
+    inc <= ringWrap;
+    {cy[0], seg[0]} <= {1'b0, seg[0]} + {4'h0, inc};
+    for (int s = 1; s < NSEG; s = s + 1) begin
+      {cy[s], seg[s]} <= {1'b0, seg[s]} + {4'h0, cy[s-1]};
+    end
+  end
+
+  // --- 2. PPS window ---
+  reg [6:0] ppsCnt = 0, ppsLast = 0;
+  reg       gate = 0;
+  always_ff @(posedge clk180) begin
+    gate <= 1'b0;
+    case (win_l)
+      2'd1:    ppsLast <= 7'd9;
+      2'd2:    ppsLast <= 7'd99;
+      default: ppsLast <= 7'd0;
+    endcase
+
+    if (rst_l || win_l != win_d) begin
+      ppsCnt <= 0;
+    end else if (risingPPS) begin
+      if (ppsCnt >= ppsLast) begin
+        ppsCnt <= 0;
+        gate <= 1'b1;
+      end else begin
+        ppsCnt <= ppsCnt + 7'd1;
+      end
+    end
+  end
+
+  // --- 3. Skew-aligned snapshot and subtract ---
+  // snap[s] selects segment s; each borrow is consumed one cycle after
+  // it is produced, matching the counter's carry skew.
+  reg [NSEG:0] snap = 0;
+  reg [3:0] prev[NSEG-1:0];
+  reg [3:0] diff[NSEG-1:0];
+  reg       bw[NSEG-1:0];
+  reg       primed = 0;
+  always_ff @(posedge clk180) begin
+    snap <= {snap[NSEG-1:0], gate};
+    if (snap[0]) {bw[0], diff[0]} <= {1'b0, seg[0]} - {1'b0, prev[0]};
+    for (int s = 1; s < NSEG; s = s + 1) begin
+      if (snap[s]) {bw[s], diff[s]} <= {1'b0, seg[s]} - {1'b0, prev[s]} - {4'h0, bw[s-1]};
+    end
+    for (int s = 0; s < NSEG; s = s + 1) begin
+      if (snap[s]) prev[s] <= seg[s];
+    end
+
+    if (rst_l || win_l != win_d) begin
+      rfGen <= 0;
+      primed <= 1'b0;
+    end else if (snap[NSEG]) begin
+      // The first window after reset or a window change only primes prev
+      if (primed) begin
+        for (int s = 0; s < NSEG; s = s + 1) rfCount[s*4 +: 4] <= diff[s];
+        rfGen <= rfGen + 8'd1;
+      end
+      primed <= 1'b1;
+    end
+  end
+
+endmodule
@@ -1,5 +1,5 @@
 `timescale 1ns / 100ps
-// Behavioral model for Lattice SB_IO (Registered DDR Output)
+// Behavioral model for Lattice SB_IO (Registered DDR Output, DDR Input)
 module SB_IO #(
     parameter [5:0] PIN_TYPE = 6'b000000,
     parameter [0:0] PULLUP = 1'b0,
@@ -31,10 +31,22 @@ module SB_IO #(
     // Bits 3:2 == 2'b10 means DDR.
     // However, many Lattice users use 2'b11 for Registered Inverted.
     // For simulation we just check if OUTPUT_CLK is used.
-    wire out_val = (PIN_TYPE[3:2] == 2'b10) ? (OUTPUT_CLK ? r0 : r1) : D_OUT_0;
+    // Bits 3:2 == 2'b01 is a registered SDR output.
+    wire out_val = (PIN_TYPE[3:2] == 2'b10) ? (OUTPUT_CLK ? r0 : r1) :
+                   (PIN_TYPE[3:2] == 2'b01) ? r0 : D_OUT_0;
     
-    // For simulation, assume OUTPUT_ENABLE is 1 if not connected
-    assign PACKAGE_PIN = out_val;
+    // For simulation, assume OUTPUT_ENABLE is 1 if not connected.
+    // PIN_TYPE[5:2] == 4'b0000 has no output driver.
+    generate
+        if (PIN_TYPE[5:2] != 4'b0000) begin : gOut
+            assign PACKAGE_PIN = out_val;
+        end
+    endgenerate
     assign PACKAGE_PIN_OUT = PACKAGE_PIN;
 
+    // Registered DDR input: D_IN_0 on the rising edge, D_IN_1 on the
+    // falling edge of INPUT_CLK
+    always @(posedge INPUT_CLK) D_IN_0 <= PACKAGE_PIN;
+    always @(negedge INPUT_CLK) D_IN_1 <= PACKAGE_PIN;
+
 endmodule
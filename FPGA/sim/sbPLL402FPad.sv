@@ -0,0 +1,43 @@
+`timescale 1ns / 100ps
+// Simulation-only behavioral model for Lattice SB_PLL40_2F_PAD
+module SB_PLL40_2F_PAD #(
+    parameter FEEDBACK_PATH = "SIMPLE",
+    parameter PLLOUT_SELECT_PORTA = "GENCLK",
+    parameter PLLOUT_SELECT_PORTB = "GENCLK_HALF",
+    parameter [3:0] DIVR = 4'b0000,
+    parameter [6:0] DIVF = 7'b0000000,
+    parameter [2:0] DIVQ = 3'b000,
+    parameter [2:0] FILTER_RANGE = 3'b000
+) (
+    input  logic PACKAGEPIN,
+    output logic PLLOUTCOREA,
+    output logic PLLOUTGLOBALA,
+    output logic PLLOUTCOREB,
+    output logic PLLOUTGLOBALB,
+    output logic LOCK,
+    input  logic RESETB,
+    input  logic BYPASS
+);
+
+    // Port A passes the reference through, as in the SB_PLL40_PAD
+    // model. Port B is GENCLK_HALF: port A divided by two with
+    // coincident rising edges.
+    reg lock_reg = 0;
+    reg half = 0;
+    assign LOCK = lock_reg;
+    assign PLLOUTCOREA = PACKAGEPIN;
+    assign PLLOUTGLOBALA = PACKAGEPIN;
+    assign PLLOUTCOREB = half;
+    assign PLLOUTGLOBALB = half;
+
+    always @(posedge PACKAGEPIN or negedge RESETB) begin
+        if (!RESETB) begin
+            lock_reg <= 0;
+            half <= 0;
+        end else begin
+            lock_reg <= 1;
+            half <= !half;
+        end
+    end
+
+endmodule
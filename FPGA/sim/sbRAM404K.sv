@@ -2,10 +2,27 @@
 // Behavioral model for Lattice SB_RAM40_4K (Dual-Port RAM)
 module SB_RAM40_4K #(
     parameter [1:0] WRITE_MODE = 2'b00,
-    parameter [1:0] READ_MODE = 2'b00
+    parameter [1:0] READ_MODE = 2'b00,
+    parameter [255:0] INIT_0 = 256'h0,
+    parameter [255:0] INIT_1 = 256'h0,
+    parameter [255:0] INIT_2 = 256'h0,
+    parameter [255:0] INIT_3 = 256'h0,
+    parameter [255:0] INIT_4 = 256'h0,
+    parameter [255:0] INIT_5 = 256'h0,
+    parameter [255:0] INIT_6 = 256'h0,
+    parameter [255:0] INIT_7 = 256'h0,
+    parameter [255:0] INIT_8 = 256'h0,
+    parameter [255:0] INIT_9 = 256'h0,
+    parameter [255:0] INIT_A = 256'h0,
+    parameter [255:0] INIT_B = 256'h0,
+    parameter [255:0] INIT_C = 256'h0,
+    parameter [255:0] INIT_D = 256'h0,
+    parameter [255:0] INIT_E = 256'h0,
+    parameter [255:0] INIT_F = 256'h0
 ) (
     input  logic [10:0] WADDR,
     input  logic [15:0] WDATA,
+    input  logic [15:0] MASK,
     input  logic WE,
     input  logic WCLKE,
     input  logic WCLK,
@@ -17,10 +34,34 @@ module SB_RAM40_4K #(
 );
 
     logic [15:0] mem [2047:0];
+
+    // Power-up contents, 256x16 mode: word w is INIT_(w/16)[(w%16)*16 +: 16]
+    initial begin
+        for (int w = 0; w < 2048; w++) mem[w] = 16'h0;
+        for (int w = 0; w < 16; w++) begin
+            mem[w]       = INIT_0[w*16 +: 16];
+            mem[16 + w]  = INIT_1[w*16 +: 16];
+            mem[32 + w]  = INIT_2[w*16 +: 16];
+            mem[48 + w]  = INIT_3[w*16 +: 16];
+            mem[64 + w]  = INIT_4[w*16 +: 16];
+            mem[80 + w]  = INIT_5[w*16 +: 16];
+            mem[96 + w]  = INIT_6[w*16 +: 16];
+            mem[112 + w] = INIT_7[w*16 +: 16];
+            mem[128 + w] = INIT_8[w*16 +: 16];
+            mem[144 + w] = INIT_9[w*16 +: 16];
+            mem[160 + w] = INIT_A[w*16 +: 16];
+            mem[176 + w] = INIT_B[w*16 +: 16];
+            mem[192 + w] = INIT_C[w*16 +: 16];
+            mem[208 + w] = INIT_D[w*16 +: 16];
+            mem[224 + w] = INIT_E[w*16 +: 16];
+            mem[240 + w] = INIT_F[w*16 +: 16];
+        end
+    end
     
     always @(posedge WCLK) begin
         if (WCLKE && WE) begin
-            mem[WADDR] <= WDATA;
+            // MASK bit set = keep the existing bit
+            mem[WADDR] <= (mem[WADDR] & MASK) | (WDATA & ~MASK);
         end
     end
 
@@ -49,9 +49,10 @@ public:
       }
     }
 
-    // Deassert CS
+    // Deassert CS long enough for the 90 MHz side (clk40 / 2 in
+    // simulation) to see the rising edge and commit the frame
     top->fpgaNCS = 1;
-    advanceClock(2);
+    advanceClock(16);
   }
 
   // Helper for 5-byte register write
@@ -65,6 +66,35 @@ public:
     write(buf, 5);
   }
 
+  // CRC-8 (x^8+x^2+x+1, init 0) as checked by SPIRegisters
+  static uint8_t crc8(const uint8_t* data, size_t len) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+      crc ^= data[i];
+      for (int b = 0; b < 8; b++) {
+        crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+      }
+    }
+    return crc;
+  }
+
+  // Helper for 6-byte CRC-protected register write. flipBit >= 0
+  // inverts that bit of the frame (0 = MSB of byte 0) after the CRC is
+  // computed, to exercise error detection.
+  void writeRegCrc(uint8_t reg, uint32_t value, int flipBit = -1) {
+    uint8_t buf[6];
+    buf[0] = 0x80 | (reg & 0x7F);
+    buf[1] = (value >> 24) & 0xFF;
+    buf[2] = (value >> 16) & 0xFF;
+    buf[3] = (value >> 8) & 0xFF;
+    buf[4] = value & 0xFF;
+    buf[5] = crc8(buf, 5);
+    if (flipBit >= 0 && flipBit < 48) {
+      buf[flipBit / 8] ^= 0x80 >> (flipBit % 8);
+    }
+    write(buf, 6);
+  }
+
   // Helper for 5-byte register read
   uint32_t readReg(uint8_t reg) {
     uint8_t tx[5] = { (uint8_t)(reg & 0x7F), 0, 0, 0, 0 };
@@ -74,6 +104,13 @@ public:
            ((uint32_t)rx[3] << 8) | (uint32_t)rx[4];
   }
 
+  // Burst read: the command byte, then len - 1 bytes clocked out
+  void readBurst(uint8_t reg, uint8_t* rx, size_t len) {
+    std::vector<uint8_t> tx(len, 0);
+    tx[0] = reg & 0x7F;
+    transceive(tx.data(), rx, len);
+  }
+
 private:
   VTop* top;
   vluint64_t* simTime;
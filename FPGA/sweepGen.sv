@@ -0,0 +1,108 @@
+`timescale 1ns / 100ps
+`default_nettype none
+
+/**
+ * SweepGen - Hardware linear frequency sweep for WSPR-ease.
+ *
+ * Holds a Q32.16 tuning word that advances by a signed Q16.16 step
+ * once every `interval` clk90 cycles, starting at `startWord` (the
+ * Tuning register) and ending at `stopWord`. When not sweeping the
+ * output simply follows `startWord`.
+ *
+ * The 48-bit add and the end-point compare are split into 16-bit
+ * segments on successive cycles, so the interval is clamped to a
+ * minimum of 8 cycles.
+ */
+module SweepGen (
+    input  wire        clk90,
+    input  wire        reset,
+    input  wire        enable,
+    input  wire        loopSweep,
+    input  wire [31:0] startWord,
+    input  wire [31:0] stopWord,
+    input  wire [31:0] step,           // Signed Q16.16
+    input  wire [23:0] interval,       // clk90 cycles per step
+
+    output reg  [31:0] tuningWord,
+    output reg         active
+    );
+
+  // --- Local Sync ---
+  reg rst_l, en_l, loop_l;
+  reg [31:0] stop_l, step_l;
+  reg [23:0] ivl_l;
+  always_ff @(posedge clk90) begin
+    rst_l  <= reset;
+    en_l   <= enable;
+    loop_l <= loopSweep;
+    stop_l <= stopWord;
+    step_l <= step;
+    ivl_l  <= (interval < 24'd8) ? 24'd8 : interval;
+  end
+
+  wire up = !step_l[31];
+
+  // --- 1. Step Interval Divider ---
+  reg [23:0] divCount, divTarget;
+  reg divHit, tick;
+  always_ff @(posedge clk90) begin
+    divTarget <= ivl_l - 24'd2;  // divHit lags divCount by one cycle
+    divHit <= (divCount == divTarget);
+    tick <= 1'b0;
+
+    if (rst_l || !en_l) begin
+      divCount <= 24'd0;
+    end else if (divHit) begin
+      divCount <= 24'd0;
+      tick <= 1'b1;
+    end else begin
+      divCount <= divCount + 24'd1;
+    end
+  end
+
+  // --- 2. Segmented Q32.16 Accumulator ---
+  // acc[0] holds the fraction, acc[2:1] the 32-bit tuning word.
+  reg [15:0] acc[2:0];
+  reg        c0, c1;
+  reg [4:0]  seq;                // One-hot add/compare sequence
+  reg        hiGt, hiLt, hiEq, loGe, loLe;
+
+  always_ff @(posedge clk90) begin
+    seq <= {seq[3:0], tick};
+
+    if (rst_l || !en_l) begin
+      acc[0] <= 16'h0;
+      acc[1] <= startWord[15:0];
+      acc[2] <= startWord[31:16];
+      active <= 1'b0;
+    end else begin
+      active <= 1'b1;
+      if (seq[0]) {c0, acc[0]} <= {1'b0, acc[0]} + {1'b0, step_l[15:0]};
+      if (seq[1]) {c1, acc[1]} <= {1'b0, acc[1]} + {1'b0, step_l[31:16]} + {16'h0, c0};
+      if (seq[2]) acc[2] <= acc[2] + {16{step_l[31]}} + {15'h0, c1};
+
+      if (seq[3]) begin
+        hiGt <= acc[2] >  stop_l[31:16];
+        hiLt <= acc[2] <  stop_l[31:16];
+        hiEq <= acc[2] == stop_l[31:16];
+        loGe <= acc[1] >= stop_l[15:0];
+        loLe <= acc[1] <= stop_l[15:0];
+      end
+
+      // End point reached: restart or park on the stop word
+      if (seq[4] && (up ? (hiGt | (hiEq & loGe)) : (hiLt | (hiEq & loLe)))) begin
+        acc[0] <= 16'h0;
+        acc[1] <= loop_l ? startWord[15:0]  : stop_l[15:0];
+        acc[2] <= loop_l ? startWord[31:16] : stop_l[31:16];
+      end
+    end
+  end
+
+  // --- 3. Output ---
+  // Hold the output while the halves are out of step and until the
+  // end-point check has parked any overshoot.
+  always_ff @(posedge clk90) begin
+    if (!(|seq[4:2])) tuningWord <= {acc[2], acc[1]};
+  end
+
+endmodule
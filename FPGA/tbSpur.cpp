@@ -0,0 +1,141 @@
+// Spur analysis for the exciter NCO: plays every WSPR dial frequency
+// in the band table with phase dither off and on, and reports the worst spur
+// within +/-1 MHz of the carrier. Cycle based, so the captured samples
+// are taken to be at the real 180 MHz exciter rate.
+#include "verilated.h"
+#include "VTop.h"
+#include "simHAL.hpp"
+#include <cstring>
+#include "lib/bandTable.hpp"
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <algorithm>
+
+static const double sampleHz = 180e6;
+static const int fftSize = 65536;
+static const int nSegments = 8;		// Welch averages, steadies the dithered floor
+static const double spanHz = 1e6;
+static const int guardBins = 16;	// Carrier main lobe and close-in dither skirt
+
+static vluint64_t mainTime = 0;
+
+static void tick(VTop* top) {
+  top->clk40 = !top->clk40;
+  top->eval();
+  mainTime += 12500;
+}
+
+static void fft(std::vector<std::complex<double>>& a) {
+  size_t n = a.size();
+  for (size_t i = 1, j = 0; i < n; i++) {
+    size_t bit = n >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) std::swap(a[i], a[j]);
+  }
+  for (size_t len = 2; len <= n; len <<= 1) {
+    std::complex<double> wl = std::polar(1.0, -2.0 * M_PI / len);
+    for (size_t i = 0; i < n; i += len) {
+      std::complex<double> w = 1;
+      for (size_t k = 0; k < len / 2; k++) {
+        std::complex<double> u = a[i + k], t = w * a[i + k + len / 2];
+        a[i + k] = u + t;
+        a[i + k + len / 2] = u - t;
+        w *= wl;
+      }
+    }
+  }
+}
+
+// Averaged Blackman-Harris spectrum, returns worst spur in dBc
+static double worstSpurDbc(const std::vector<int>& v, double carrierHz) {
+  std::vector<double> power(fftSize, 0.0);
+  std::vector<std::complex<double>> a(fftSize);
+  for (int seg = 0; seg < nSegments; seg++) {
+    for (int i = 0; i < fftSize; i++) {
+      double x = 2.0 * M_PI * i / fftSize;
+      double w = 0.35875 - 0.48829 * cos(x) + 0.14128 * cos(2 * x) - 0.01168 * cos(3 * x);
+      a[i] = v[seg * fftSize + i] * w;
+    }
+    fft(a);
+    for (int i = 0; i < fftSize; i++) power[i] += std::norm(a[i]);
+  }
+
+  double binHz = sampleHz / fftSize;
+  int c = (int)lround(carrierHz / binHz);
+  int half = (int)(spanHz / binHz);
+  double carrier = 0, worst = 0;
+  for (int k = c - 4; k <= c + 4; k++) carrier = std::max(carrier, power[k]);
+  for (int k = c - half; k <= c + half; k++) {
+    if (abs(k - c) <= guardBins || k <= 0 || k >= fftSize / 2) continue;
+    worst = std::max(worst, power[k]);
+  }
+  return 10.0 * log10(worst / carrier);
+}
+
+// Same span rule as FPGA::ditherWidthFor()
+static uint32_t ditherWidthFor(uint32_t word) {
+  uint32_t room = word < 0x80000000u ? word : (uint32_t)(0u - word);
+  room -= room >> 8;
+  return room ? 31 - __builtin_clz(room) : 0;
+}
+
+int main(int argc, char** argv) {
+  Verilated::commandArgs(argc, argv);
+  VTop* top = new VTop;
+
+  top->clk40 = 0;
+  top->fpgaNCS = 1;
+  top->fpgaSCLK_pin = 0;
+  top->fpgaMOSI = 0;
+  top->gnssPPS = 0;
+  top->fpgaNRESET = 1;
+  for (int i = 0; i < 100; i++) tick(top);
+
+  SimSpi spi(top, &mainTime);
+  spi.writeReg(0x00, 0xFF000001);	// TX EN = 1, Power Threshold = 255
+
+  std::cout << "NCO spur analysis, worst spur within +/-" << spanHz / 1e6
+            << " MHz of the carrier (" << nSegments << " x " << fftSize << " samples)" << std::endl;
+  std::cout << " Band  Dial Hz    Width  Off dBc  On dBc  Change" << std::endl;
+
+  int worse = 0;
+  for (int b = 0; b < wspr::BandTable::count; b++) {
+    const wspr::BandTable::Entry& band = wspr::BandTable::get(b);
+    uint32_t freqHz = band.dialHz;
+    uint32_t word = band.wsprWords[0];
+    uint32_t width = ditherWidthFor(word);
+    double dbc[2];
+
+    spi.writeReg(0x01, word);
+    for (int on = 0; on < 2; on++) {
+      spi.writeReg(0x0D, on ? (1 | width << 8) : 0);
+      for (int i = 0; i < 2000; i++) tick(top);
+
+      std::vector<int> v;
+      v.reserve(fftSize * nSegments);
+      while ((int)v.size() < fftSize * nSegments) {
+        tick(top);
+        if (top->clk40) {
+          v.push_back(top->rfPushBase + top->rfPushPeak - top->rfPullBase - top->rfPullPeak);
+        }
+      }
+      dbc[on] = worstSpurDbc(v, freqHz);
+    }
+
+    if (dbc[1] > dbc[0]) worse++;
+    std::cout << std::setw(5) << band.name << "  " << std::setw(8) << freqHz
+              << "  " << std::setw(5) << width << std::fixed << std::setprecision(1)
+              << "  " << std::setw(7) << dbc[0] << "  " << std::setw(6) << dbc[1]
+              << "  " << std::setw(6) << dbc[1] - dbc[0] << std::defaultfloat << std::endl;
+  }
+
+  std::cout << "Dither " << (worse ? "(FAIL)" : "(OK)") << std::endl;
+  top->final();
+  delete top;
+  return worse ? 1 : 0;
+}
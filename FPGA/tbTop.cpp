@@ -6,6 +6,9 @@
 #include <cstdint>
 #include <memory>
 #include <iomanip>
+#include <cmath>
+#include <complex>
+#include <vector>
 
 int main(int argc, char** argv) {
   Verilated::commandArgs(argc, argv);
@@ -48,19 +51,144 @@ int main(int argc, char** argv) {
   // Set Frequency: 5.555555 MHz
   uint32_t freqHz = 5555555;
   // Update rate in simulation:
-  // clk40 is passed through to clk90 (40MHz).
-  // DDR means 2 updates per clk90 cycle = 80Msps.
-  uint32_t tuningWord = ((uint64_t)freqHz << 32) / 80000000ULL;
+  // clk40 is passed through to clk180 (40 MHz) and the exciter runs
+  // SDR, so 40 Msps. The ring takes 6 NCO overflows per RF cycle.
+  uint32_t tuningWord = ((uint64_t)freqHz * 6 << 32) / 40000000ULL;
 
-  std::cout << "Setting Tuning Word: 0x" << std::hex << tuningWord << std::dec << " for " << freqHz << " Hz at 80 Msps" << std::endl;
+  std::cout << "Setting Tuning Word: 0x" << std::hex << tuningWord << std::dec << " for " << freqHz << " Hz at 40 Msps" << std::endl;
   spi.writeReg(0x01, tuningWord);
 
   uint32_t rb = spi.readReg(0x01);
-  std::cout << "Readback Tuning: 0x" << std::hex << rb << std::dec << std::endl;
+  std::cout << "Readback Tuning: 0x" << std::hex << rb << std::dec
+            << (rb == tuningWord ? " (OK)" : " (FAIL)") << std::endl;
+
+  uint32_t sig = spi.readReg(0x0F);
+  std::cout << "Signature: 0x" << std::hex << sig << std::dec
+            << (sig == 0x52505357 ? " (OK)" : " (FAIL)") << std::endl;
+
+  // PPS capture: two rising edges 4001 clk40 periods apart are 2000.5
+  // clk90 cycles apart in simulation, which the DDR input must resolve
+  // as 4001 half cycles.
+  std::cout << "Checking PPS half-cycle capture..." << std::endl;
+  auto runUntil = [&](vluint64_t t) {
+    while (mainTime < t) {
+      top->clk40 = !top->clk40;
+      top->eval();
+      if (tfp) tfp->dump(mainTime);
+      mainTime += 12500;
+    }
+  };
+  auto ppsStamp = [&]() {
+    uint32_t r = spi.readReg(0x03);
+    return (int64_t)(r >> 5) * 2 + ((r >> 4) & 1);
+  };
+  vluint64_t ppsT0 = mainTime;
+  int64_t stamps[2];
+  for (int k = 0; k < 2; k++) {
+    runUntil(ppsT0 + k * 4001 * 25000);
+    top->gnssPPS = 1;
+    runUntil(mainTime + 100 * 25000);
+    top->gnssPPS = 0;
+    stamps[k] = ppsStamp();
+  }
+  int64_t ppsHalfCycles = stamps[1] - stamps[0];
+  std::cout << "PPS interval: " << ppsHalfCycles / 2.0 << " clk90 cycles"
+            << (ppsHalfCycles == 4001 ? " (OK)" : " (FAIL)") << std::endl;
+
+  // Event log: the newest entry is the second PPS edge, stamped on the
+  // same timebase as the PPS register, and the initial tuning commit
+  // precedes both edges.
+  std::cout << "Checking event log..." << std::endl;
+  uint8_t logBuf[5 + 64 * 8];
+  spi.readBurst(0x0E, logBuf, sizeof(logBuf));
+  uint16_t eventCount = ((uint16_t)logBuf[3] << 8) | logBuf[4];
+  auto logEntry = [&](int n) {
+    uint64_t raw = 0;
+    for (int b = 0; b < 8; b++) raw = (raw << 8) | logBuf[5 + (n % 64) * 8 + b];
+    return raw;
+  };
+  int logFails = 0;
+  if (eventCount != 3) logFails++;
+  uint64_t tuneEv = logEntry(0), ppsEv = logEntry(eventCount - 1);
+  uint32_t ppsReg = spi.readReg(0x03);
+  if ((tuneEv >> 62) != 1 || (ppsEv >> 62) < 2) logFails++;
+  if ((ppsEv & 0x7FFFFFF) != (ppsReg >> 5)) logFails++;
+  if (((ppsEv >> 62) & 1) != ((ppsReg >> 4) & 1)) logFails++;
+  if ((tuneEv & ((1ULL << 62) - 1)) >= (ppsEv & ((1ULL << 62) - 1))) logFails++;
+  std::cout << "Events logged: " << eventCount
+            << (logFails ? " (FAIL)" : " (OK)") << std::endl;
+
+  // CRC-protected writes: with crcRequired set, plain frames and
+  // frames with any single bit error must be discarded and counted.
+  std::cout << "Checking SPI CRC..." << std::endl;
+  spi.writeRegCrc(0x0A, 0x00000001);
+  uint32_t errors0 = spi.readReg(0x0A) >> 16;
+  spi.writeReg(0x01, 0x12345678);
+  int crcFails = 0;
+  for (int bit = 1; bit < 48; bit += 7) {
+    spi.writeRegCrc(0x01, 0x12345678, bit);
+  }
+  uint32_t errors1 = spi.readReg(0x0A) >> 16;
+  if (spi.readReg(0x01) != tuningWord) crcFails++;
+  if (errors1 - errors0 != 1 + 7) crcFails++;
+  spi.writeRegCrc(0x01, 0x12345678);
+  if (spi.readReg(0x01) != 0x12345678) crcFails++;
+  spi.writeRegCrc(0x01, tuningWord);
+  spi.writeRegCrc(0x0A, 0x00000000);
+  std::cout << "CRC errors counted: " << (errors1 - errors0)
+            << (crcFails ? " (FAIL)" : " (OK)") << std::endl;
 
   std::cout << "Enabling TX..." << std::endl;
   spi.writeReg(0x00, 0xFF000001); // TX EN = 1, Power Threshold = 255
   
+  // Waveform tables: play each power-up table at f = 40 MHz / 256 so
+  // one RF cycle is exactly 256 samples, and measure the harmonics of
+  // pushBase + pushPeak - pullBase - pullPeak.
+  std::cout << "Checking waveform tables..." << std::endl;
+  struct { uint32_t table, stepsSel, steps; int h; double limit; } waves[] = {
+    { 0, 0, 6, 3, -30.0 },	// 1-2-1 nulls the 3rd
+    { 1, 1, 12, 5, -30.0 },	// 12-step suppresses the 5th and 7th
+    { 2, 2, 24, 3, -30.0 },	// 24-step nulls the 3rd
+  };
+  int waveFails = 0;
+  for (auto& w : waves) {
+    spi.writeReg(0x0B, w.table | (w.stepsSel << 8));
+    spi.writeReg(0x01, w.steps << 24);
+
+    // Skip one period for the new word to reach the pins
+    const int period = 256, nPeriods = 4;
+    std::vector<int> v;
+    while ((int)v.size() < period * (nPeriods + 1)) {
+      top->clk40 = !top->clk40;
+      top->eval();
+      if (tfp) tfp->dump(mainTime);
+      mainTime += 12500;
+      if (top->clk40) {
+        v.push_back(top->rfPushBase + top->rfPushPeak - top->rfPullBase - top->rfPullPeak);
+      }
+    }
+
+    v.erase(v.begin(), v.begin() + period);
+    double mag[8] = {};
+    for (int h : {1, 3, 5, 7}) {
+      std::complex<double> sum = 0;
+      for (size_t i = 0; i < v.size(); i++) {
+        sum += (double)v[i] * std::polar(1.0, -2.0 * M_PI * h * i / period);
+      }
+      mag[h] = std::abs(sum);
+    }
+    auto dBc = [&](int h) { return 20.0 * std::log10(std::max(mag[h], 1e-9) / mag[1]); };
+    bool ok = mag[1] > 0 && dBc(w.h) < w.limit;
+    if (!ok) waveFails++;
+    std::cout << "  Table " << w.table << " (" << w.steps << " steps): "
+              << std::fixed << std::setprecision(1)
+              << "H3 " << dBc(3) << " dBc, H5 " << dBc(5) << " dBc, H7 " << dBc(7) << " dBc"
+              << std::defaultfloat << (ok ? " (OK)" : " (FAIL)") << std::endl;
+  }
+  spi.writeReg(0x0B, 0);
+  spi.writeReg(0x01, tuningWord);
+  std::cout << "Waveform tables" << (waveFails ? " (FAIL)" : " (OK)") << std::endl;
+
   // Simulation loop
   std::cout << "Running RF simulation for 5000 cycles..." << std::endl;
   for (int i = 0; i < 10000; i++) {
@@ -0,0 +1,37 @@
+`timescale 1ns / 100ps
+`default_nettype none
+
+/**
+ * Timebase - Free-running 64-bit clk90 cycle counter.
+ *
+ * Four 16-bit segments with registered carries, so segment s lags
+ * segment 0 by s cycles. The output re-aligns them with matching
+ * delays and is therefore a consistent count, 3 cycles late.
+ */
+module Timebase (
+    input  wire        clk90,
+    output wire [63:0] clocks
+    );
+
+  reg [15:0] s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+  reg        k0 = 0, k1 = 0, k2 = 0;
+  always_ff @(posedge clk90) begin
+    {k0, s0} <= {1'b0, s0} + 17'd1;
+    {k1, s1} <= {1'b0, s1} + {16'h0, k0};
+    {k2, s2} <= {1'b0, s2} + {16'h0, k1};
+    s3 <= s3 + {15'h0, k2};
+  end
+
+  reg [15:0] s0_d[2:0], s1_d[1:0], s2_d;
+  always_ff @(posedge clk90) begin
+    s0_d[0] <= s0;
+    s0_d[1] <= s0_d[0];
+    s0_d[2] <= s0_d[1];
+    s1_d[0] <= s1;
+    s1_d[1] <= s1_d[0];
+    s2_d    <= s2;
+  end
+
+  assign clocks = {s3, s2_d, s1_d[1], s0_d[2]};
+
+endmodule
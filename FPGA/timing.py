@@ -1,3 +1,4 @@
+ctx.addClock("clk180", 180.0)
 ctx.addClock("clk90", 90.0)
 ctx.addClock("fpgaSCLK", 12.0)
 
@@ -15,26 +15,31 @@ module Top (
 	    output logic driverNEN
 	    );
 
-  logic clk90_pre, clk90;
+  logic clk180_pre, clk180, clk90_pre, clk90;
   logic fpgaSCLK, pllLocked;
 
   SB_GB sclkGbuf (.USER_SIGNAL_TO_GLOBAL_BUFFER(fpgaSCLK_pin), .GLOBAL_BUFFER_OUTPUT(fpgaSCLK));
 
-  // 90 MHz System Clock
-  SB_PLL40_PAD #(
-		 .FEEDBACK_PATH("SIMPLE"),
-		 .DIVR(4'b0000),       
-		 .DIVF(7'b0100001),    
-		 .DIVQ(3'b011),        
-		 .FILTER_RANGE(3'b010) 
-		 ) sysPll (
-			   .PACKAGEPIN(clk40), 
-			   .PLLOUTGLOBAL(clk90_pre),
-			   .LOCK(pllLocked),
-			   .RESETB(1'b1),
-			   .BYPASS(1'b0)
-			   );
+  // 180 MHz RF clock and phase-aligned 90 MHz control clock.
+  // 40 MHz * (DIVF+1) = 720 MHz VCO, / 2^DIVQ = 180 MHz.
+  SB_PLL40_2F_PAD #(
+		    .FEEDBACK_PATH("SIMPLE"),
+		    .PLLOUT_SELECT_PORTA("GENCLK"),
+		    .PLLOUT_SELECT_PORTB("GENCLK_HALF"),
+		    .DIVR(4'b0000),
+		    .DIVF(7'b0010001),
+		    .DIVQ(3'b010),
+		    .FILTER_RANGE(3'b011)
+		    ) sysPll (
+			      .PACKAGEPIN(clk40),
+			      .PLLOUTCOREA(clk180_pre),
+			      .PLLOUTCOREB(clk90_pre),
+			      .LOCK(pllLocked),
+			      .RESETB(1'b1),
+			      .BYPASS(1'b0)
+			      );
 
+  SB_GB clk180Gbuf (.USER_SIGNAL_TO_GLOBAL_BUFFER(clk180_pre), .GLOBAL_BUFFER_OUTPUT(clk180));
   SB_GB clk90Gbuf (.USER_SIGNAL_TO_GLOBAL_BUFFER(clk90_pre), .GLOBAL_BUFFER_OUTPUT(clk90));
 
   logic rst90_s1, rst90;
@@ -53,6 +58,28 @@ module Top (
   logic [7:0] powerThresh, powerThresh_d1;
   logic [31:0] tuningWord, tuningWord_d1;
   logic txEnable, txEnable_d1;
+  logic [31:0] sweepStep, sweepStop, sweepWord;
+  logic [23:0] sweepInterval;
+  logic sweepEnable, sweepLoop, sweepActive;
+  logic [23:0] freqCorr;
+  logic [31:0] correctedWord;
+  logic [26:0] ppsCount;
+  logic ppsHalf, ppsLevel, ppsEdge, ppsEdgeHalf;
+  logic [63:0] clocks;
+  logic tuningCommit, logRE;
+  logic [7:0] logRAddr;
+  logic [15:0] logRData, eventCount;
+  logic [3:0] ppsGen;
+  logic [1:0] rfWindow;
+  logic [31:0] rfCount;
+  logic [7:0] rfGen;
+  logic ringWrap;
+  logic [1:0] waveTable, waveSteps;
+  logic wtWE;
+  logic [6:0] wtAddr;
+  logic [3:0] wtData;
+  logic ditherEnable;
+  logic [4:0] ditherWidth;
 
   SPIRegisters spiCore (
 			.reset(rst90),
@@ -65,30 +92,137 @@ module Top (
 			.powerThresh(powerThresh),
 			.pllLocked(pllLocked_s2),
 			.txEnable(txEnable),
-			.ppsCount(27'h0),
-			.ppsGen(5'h0)
+			.sweepStep(sweepStep),
+			.sweepStop(sweepStop),
+			.sweepInterval(sweepInterval),
+			.sweepEnable(sweepEnable),
+			.sweepLoop(sweepLoop),
+			.freqCorr(freqCorr),
+			.waveTable(waveTable),
+			.waveSteps(waveSteps),
+			.wtWE(wtWE),
+			.wtAddr(wtAddr),
+			.wtData(wtData),
+			.ditherEnable(ditherEnable),
+			.ditherWidth(ditherWidth),
+			.rfWindow(rfWindow),
+			.rfCount(rfCount),
+			.rfGen(rfGen),
+			.tuningCommit(tuningCommit),
+			.logRE(logRE),
+			.logRAddr(logRAddr),
+			.logRData(logRData),
+			.eventCount(eventCount),
+			.ppsCount(ppsCount),
+			.ppsHalf(ppsHalf),
+			.ppsGen(ppsGen)
+			);
+
+  Timebase timebase (
+		     .clk90(clk90),
+		     .clocks(clocks)
+		     );
+
+  FreqCounter ppsCounter (
+			  .clk90(clk90),
+			  .reset(rst90),
+			  .fpgaNCS(fpgaNCS),
+			  .samplePPS(gnssPPS),
+			  .clocks(clocks),
+			  .ppsCount(ppsCount),
+			  .ppsHalf(ppsHalf),
+			  .ppsGen(ppsGen),
+			  .ppsLevel(ppsLevel),
+			  .ppsEdge(ppsEdge),
+			  .ppsEdgeHalf(ppsEdgeHalf)
+			  );
+
+  // Tuning commits and PPS edges on the same timebase, for checking
+  // on-air symbol timing against UTC
+  EventLog eventLog (
+		     .clk90(clk90),
+		     .reset(rst90),
+		     .fpgaNCS(fpgaNCS),
+		     .timebase(clocks),
+		     .tuningCommit(tuningCommit),
+		     .ppsEdge(ppsEdge),
+		     .ppsHalf(ppsEdgeHalf),
+		     .fpgaSCLK(fpgaSCLK),
+		     .logRE(logRE),
+		     .logRAddr(logRAddr),
+		     .logRData(logRData),
+		     .eventCount(eventCount)
+		     );
+
+  // Tuning word passes through the sweep generator, which follows
+  // the Tuning register unless a sweep is enabled.
+  SweepGen sweepCore (
+		      .clk90(clk90),
+		      .reset(rst90),
+		      .enable(sweepEnable),
+		      .loopSweep(sweepLoop),
+		      .startWord(tuningWord),
+		      .stopWord(sweepStop),
+		      .step(sweepStep),
+		      .interval(sweepInterval),
+		      .tuningWord(sweepWord),
+		      .active(sweepActive)
+		      );
+
+  // Reference (TCXO) error correction is applied to every tuning
+  // word, including sweep output, so the firmware always writes
+  // nominal words.
+  FreqCorrect corrCore (
+			.clk90(clk90),
+			.wordIn(sweepWord),
+			.corr(freqCorr),
+			.wordOut(correctedWord)
 			);
 
   always_ff @(posedge clk90) begin
-    tuningWord_d1 <= tuningWord;
+    tuningWord_d1 <= correctedWord;
     powerThresh_d1 <= powerThresh;
     txEnable_d1 <= txEnable;
   end
 
+  // The control plane stays at 90 MHz. Its clock is GENCLK_HALF of the
+  // 180 MHz clock with coincident rising edges, so the exciter and RF
+  // counter sample clk90 registers synchronously.
   WSPRExciter exciterCore (
 			   .reset(rst90),
-			   .clk90(clk90), 
+			   .clk180(clk180),
 			   .tuningWord(tuningWord_d1),
 			   .powerThreshold(powerThresh_d1),
 			   .txEnable(txEnable_d1 & pllLocked_s2), 
+			   .clk90(clk90),
+			   .waveTable(waveTable),
+			   .waveSteps(waveSteps),
+			   .wtWE(wtWE),
+			   .wtAddr(wtAddr),
+			   .wtData(wtData),
+			   .ditherEnable(ditherEnable),
+			   .ditherWidth(ditherWidth),
 			   .rfPushBase(rfPushBase),
 			   .rfPushPeak(rfPushPeak),
 			   .rfPullBase(rfPullBase),
-			   .rfPullPeak(rfPullPeak)
+			   .rfPullPeak(rfPullPeak),
+			   .ringWrap(ringWrap)
 			   );
 
+  // Count live RF output cycles over a PPS-gated window. The PPS pin
+  // feeds a DDR input register, so this takes its synchronized level.
+  RFCounter rfCounter (
+		       .clk180(clk180),
+		       .reset(rst90),
+		       .ringWrap(ringWrap),
+		       .samplePPS(ppsLevel),
+		       .window(rfWindow),
+		       .rfCount(rfCount),
+		       .rfGen(rfGen)
+		       );
+
   logic dEn;
   always_ff @(posedge clk90) dEn <= !(txEnable & pllLocked_s2);
-  SB_IO #(.PIN_TYPE(6'b010101)) ioD (.PACKAGE_PIN(driverNEN), .D_OUT_0(dEn));
+  SB_IO #(.PIN_TYPE(6'b010101)) ioD (.PACKAGE_PIN(driverNEN), .OUTPUT_CLK(clk90), .D_OUT_0(dEn));
 
 endmodule
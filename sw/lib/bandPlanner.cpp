@@ -0,0 +1,202 @@
+/*
+ * Band Planner Implementation for WSPR-ease
+ */
+
+#include "bandPlanner.hpp"
+#include "bandTable.hpp"
+
+namespace wspr {
+
+  // Candidate slots examined per refill when few or none are eligible
+  static const int maxScanMinutes = 2 * BandPlanner::minutesPerDay;
+
+  uint8_t BandPlanner::lpfForHz(uint32_t hz) {
+    return BandTable::lpfForHz(hz);
+  }
+
+  const char* BandPlanner::messageName(Message m) {
+    switch (m) {
+    case Message::Type1: return "type1";
+    case Message::Type2: return "type2";
+    case Message::Type3: return "type3";
+    }
+    return "";
+  }
+
+  static int wrapMinute(int m) {
+    m %= BandPlanner::minutesPerDay;
+    return m < 0 ? m + BandPlanner::minutesPerDay : m;
+  }
+
+  // UTC minute of day, or -1 when the base is not known
+  static int resolve(BandPlanner::TimeBase base, int offset, int tzMin, const BandPlanner::SunTimes& sun) {
+    switch (base) {
+    case BandPlanner::TimeBase::Utc: return wrapMinute(offset);
+    case BandPlanner::TimeBase::Local: return wrapMinute(offset - tzMin);
+    case BandPlanner::TimeBase::Sunrise: return sun.known ? wrapMinute(sun.sunriseMin + offset) : -1;
+    case BandPlanner::TimeBase::Sunset: return sun.known ? wrapMinute(sun.sunsetMin + offset) : -1;
+    }
+    return -1;
+  }
+
+  static bool isSun(BandPlanner::TimeBase base) {
+    return base == BandPlanner::TimeBase::Sunrise || base == BandPlanner::TimeBase::Sunset;
+  }
+
+  void BandPlanner::compile(const Config& c, const SunTimes& sun) {
+    cfg = c;
+    if (cfg.nBands > maxBands) cfg.nBands = maxBands;
+    if (cfg.listLen > maxList) cfg.listLen = maxList;
+    if (cfg.dutyCycle < 1) cfg.dutyCycle = 1;
+    periodMin = Modulation::get(cfg.txMode).periodMin();
+    intervalMin = cfg.slotIntervalMin < periodMin ? periodMin
+      : (cfg.slotIntervalMin + periodMin - 1) / periodMin * periodMin;
+
+    for (int m = 0; m < minutesPerDay; m++) mask[m] = 0;
+    for (int b = 0; b < cfg.nBands; b++) {
+      const BandSetup& bs = cfg.bands[b];
+      if (!bs.enabled) continue;
+
+      int start = 0, end = 0;
+      if (bs.window.enabled) {
+        const Window& w = bs.window;
+        start = resolve(w.startBase, w.startOffsetMin, cfg.timezoneOffsetMin, sun);
+        end = resolve(w.endBase, w.endOffsetMin, cfg.timezoneOffsetMin, sun);
+        if (start < 0 || end < 0) {
+          start = end = 0;
+        } else if (isSun(w.startBase) && isSun(w.endBase)) {
+          // Length from the events, which may cover all or none of the
+          // day. In polar day or night a daylight or darkness window is
+          // simply open or shut, whatever its offsets.
+          bool polar = sun.daylightMin <= 0 || sun.daylightMin >= minutesPerDay;
+          bool dayWindow = w.startBase == TimeBase::Sunrise && w.endBase == TimeBase::Sunset;
+          bool nightWindow = w.startBase == TimeBase::Sunset && w.endBase == TimeBase::Sunrise;
+          int len = w.endOffsetMin - w.startOffsetMin;
+          if (dayWindow) len = polar ? (sun.daylightMin > 0 ? minutesPerDay : 0) : len + sun.daylightMin;
+          if (nightWindow) len = polar ? (sun.daylightMin > 0 ? 0 : minutesPerDay) : len + minutesPerDay - sun.daylightMin;
+          if (len <= 0) continue;
+          end = len >= minutesPerDay ? start : wrapMinute(start + len);
+        }
+      }
+      for (int m = 0; m < minutesPerDay; m++) {
+        bool in = start == end || (start < end ? m >= start && m < end : m >= start || m < end);
+        if (in) mask[m] |= (uint16_t)(1u << b);
+      }
+    }
+
+    if (rrNext >= cfg.nBands) rrNext = 0;
+    if (listPos >= cfg.listLen) listPos = 0;
+    head = count = 0;
+    nextMinute = 0;
+  }
+
+  uint16_t BandPlanner::eligible(int minuteOfDay) const {
+    // A transmission runs into the last minute of its period
+    int m = wrapMinute(minuteOfDay);
+    uint16_t elig = mask[m];
+    for (int i = 1; i < periodMin; i++) elig &= mask[(m + i) % minutesPerDay];
+    return elig;
+  }
+
+  static uint32_t mix(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7feb352d;
+    x ^= x >> 15;
+    x *= 0x846ca68b;
+    x ^= x >> 16;
+    return x;
+  }
+
+  int BandPlanner::pick(uint16_t elig, int64_t slotNo) {
+    switch (cfg.mode) {
+    case Mode::Manual:
+      return -1;
+
+    case Mode::Random: {
+      int n = 0;
+      for (int b = 0; b < cfg.nBands; b++) n += (elig >> b) & 1;
+      int k = (int)(mix((uint32_t)slotNo ^ cfg.seed) % (uint32_t)n);
+      for (int b = 0; b < cfg.nBands; b++) {
+        if ((elig >> b) & 1 && k-- == 0) return b;
+      }
+      return -1;
+    }
+
+    case Mode::RoundRobin:
+      for (int i = 0; i < cfg.nBands; i++) {
+        int b = (rrNext + i) % cfg.nBands;
+        if ((elig >> b) & 1) {
+          rrNext = (uint8_t)((b + 1) % cfg.nBands);
+          return b;
+        }
+      }
+      return -1;
+
+    case Mode::List:
+      for (int i = 0; i < cfg.listLen; i++) {
+        int pos = (listPos + i) % cfg.listLen;
+        int b = cfg.list[pos];
+        if (b < cfg.nBands && (elig >> b) & 1) {
+          listPos = (uint8_t)((pos + 1) % cfg.listLen);
+          return b;
+        }
+      }
+      return -1;
+    }
+    return -1;
+  }
+
+  int BandPlanner::refill(int64_t fromUnix) {
+    if (cfg.mode == Mode::Manual) return 0;
+
+    int64_t m = (fromUnix + 59) / 60;
+    if (m < nextMinute) m = nextMinute;
+    m = (m + intervalMin - 1) / intervalMin * intervalMin;
+
+    int64_t scanEnd = m + maxScanMinutes;
+    for (; count < maxPlan && m < scanEnd; m += intervalMin) {
+      int64_t slotNo = m / intervalMin;
+      if (slotNo % cfg.dutyCycle != 0) continue;
+
+      uint16_t elig = eligible((int)(m % minutesPerDay));
+      if (!elig) continue;
+      int b = pick(elig, slotNo);
+      if (b < 0) continue;
+
+      Message msg = Message::Type1;
+      if (cfg.compoundCall) msg = planned % 2 ? Message::Type3 : Message::Type2;
+      else if (cfg.longLocator) msg = planned % 2 ? Message::Type3 : Message::Type1;
+      planned++;
+
+      Slot& s = plan[(head + count) % maxPlan];
+      s.startUnix = m * 60;
+      s.band = (uint8_t)b;
+      s.freqHz = cfg.bands[b].freqHz;
+      s.lpf = lpfForHz(s.freqHz);
+      s.mode = cfg.txMode;
+      s.message = msg;
+      count++;
+    }
+    nextMinute = m;
+    return count;
+  }
+
+  bool BandPlanner::take(int64_t slotUnix, Slot& out) {
+    while (count > 0 && plan[head].startUnix < slotUnix) {
+      head = (head + 1) % maxPlan;
+      count--;
+    }
+    if (count == 0 || plan[head].startUnix != slotUnix) return false;
+    out = plan[head];
+    head = (head + 1) % maxPlan;
+    count--;
+    return true;
+  }
+
+  int BandPlanner::upcoming(Slot* out, int max) const {
+    int n = count < max ? count : max;
+    for (int i = 0; i < n; i++) out[i] = plan[(head + i) % maxPlan];
+    return n;
+  }
+
+} // namespace wspr
@@ -0,0 +1,132 @@
+/*
+ * Band Planner for WSPR-ease
+ * Compiles the band schedule into a per-minute eligibility mask and
+ * plans the next transmit slots ahead of time, so the decision at a
+ * slot boundary is a lookup.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "modulation.hpp"
+
+namespace wspr {
+
+  class BandPlanner {
+  public:
+    static const int maxBands = 16;
+    static const int maxList = 32;
+    static const int maxPlan = 8;
+    static const int minutesPerDay = 1440;
+
+    enum class Mode : uint8_t {
+      Manual,		// Only on a manual trigger; nothing is planned
+      Random,		// Any eligible band, chosen per slot
+      RoundRobin,	// Next eligible band in band order
+      List,		// Next eligible entry of the band list
+    };
+
+    enum class TimeBase : uint8_t { Utc, Local, Sunrise, Sunset };
+
+    // WSPR message types: 1 for a plain call and 4-character locator;
+    // a 6-character locator alternates 1 and 3, a compound call 2 and 3.
+    enum class Message : uint8_t { Type1, Type2, Type3 };
+
+    // Minutes from a base; a disabled window leaves the band eligible
+    // all day, as does one with start == end. A window between two sun
+    // events runs for the time between them plus the offsets; in polar
+    // day a sunrise to sunset window is open all day and a sunset to
+    // sunrise one shut, and the other way round in polar night.
+    struct Window {
+      bool enabled = false;
+      TimeBase startBase = TimeBase::Utc;
+      int16_t startOffsetMin = 0;
+      TimeBase endBase = TimeBase::Utc;
+      int16_t endOffsetMin = minutesPerDay;
+    };
+
+    struct BandSetup {
+      uint32_t freqHz = 0;
+      bool enabled = false;
+      Window window;
+    };
+
+    struct Config {
+      Mode mode = Mode::RoundRobin;
+      Modulation::Mode txMode = Modulation::Mode::Wspr2;
+      int slotIntervalMin = 2;		// Rounded up to whole periods of txMode
+      int dutyCycle = 1;		// Transmit in 1 of N slots
+      int timezoneOffsetMin = 0;	// For TimeBase::Local
+      bool compoundCall = false;
+      bool longLocator = false;
+      uint32_t seed = 0;		// Random mode
+      int nBands = 0;
+      BandSetup bands[maxBands];
+      int listLen = 0;
+      uint8_t list[maxList] = {};	// Band indices, repeats for weighting
+    };
+
+    // UTC minute of day of sunrise and sunset at the station, and the
+    // length of the day (1440 in polar day, 0 in polar night). Windows
+    // based on them are not applied while unknown.
+    struct SunTimes {
+      bool known = false;
+      int16_t sunriseMin = 0;
+      int16_t sunsetMin = 0;
+      int16_t daylightMin = 0;
+    };
+
+    struct Slot {
+      int64_t startUnix;
+      uint8_t band;
+      uint8_t lpf;
+      Modulation::Mode mode;
+      Message message;
+      uint32_t freqHz;
+    };
+
+    // Low-pass filter for a frequency (BandTable::lpfForHz)
+    static uint8_t lpfForHz(uint32_t hz);
+    static const char* messageName(Message m);
+
+    // Build the eligibility masks and drop the plan. Rotation state is
+    // kept, so recompiling does not restart a round robin. Recompile
+    // when the configuration or the day's sun times change.
+    void compile(const Config& c, const SunTimes& sun);
+
+    // Bands eligible throughout a transmit period starting at this UTC
+    // minute
+    uint16_t eligible(int minuteOfDay) const;
+
+    // Plan ahead up to maxPlan slots starting at or after fromUnix.
+    // Returns the number planned. Call away from the slot boundary.
+    int refill(int64_t fromUnix);
+
+    // At a slot boundary: the planned slot starting at slotUnix, if
+    // any. Earlier planned slots are dropped.
+    bool take(int64_t slotUnix, Slot& out);
+
+    int upcoming(Slot* out, int max) const;
+    int interval() const { return intervalMin; }
+    Modulation::Mode txMode() const { return cfg.txMode; }
+
+  private:
+    int pick(uint16_t elig, int64_t slotNo);
+
+    Config cfg;
+    uint16_t mask[minutesPerDay] = {};
+    int intervalMin = 2;
+    int periodMin = 2;
+
+    Slot plan[maxPlan];
+    int head = 0;
+    int count = 0;
+    int64_t nextMinute = 0;	// First epoch minute not yet considered
+
+    uint8_t rrNext = 0;
+    uint8_t listPos = 0;
+    uint32_t planned = 0;	// Slots planned so far, for the message mix
+  };
+
+} // namespace wspr
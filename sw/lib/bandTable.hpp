@@ -0,0 +1,132 @@
+/*
+ * Band Table for WSPR-ease
+ * The WSPR bands the transmitter covers, in one table the firmware and
+ * the web UI mock server both build from: name, dial frequency, the
+ * low-pass filter and the WSPR-2 tone words at the default NCO setup,
+ * all computed at compile time. Lookups by index, name and dial
+ * frequency are constant time.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "modulation.hpp"
+
+namespace wspr {
+
+  class BandTable {
+  public:
+    // Table order, by frequency. Indices are stored in the configuration
+    // (AppConfig::bandEnabled): a change needs a ConfigSchema migration.
+    enum class Id : uint8_t {
+      Band160m, Band80m, Band60m, Band40m, Band30m, Band20m, Band17m, Band15m, Band12m, Band10m,
+    };
+    static const int count = 10;
+
+    // The NCO the tone words are computed for: the FPGA's exciter clock
+    // and its power-on wave table
+    static const uint32_t exciterClkHz = 180*1000*1000;
+    static const uint8_t defaultSteps = 6;
+
+    struct Entry {
+      const char* name;
+      uint8_t meters;
+      uint32_t dialHz;
+      uint8_t lpf;			// lpfForHz(dialHz)
+      uint32_t wsprWords[Modulation::toneCount];	// [0] is the dial frequency
+    };
+
+    // Low-pass filter for a frequency: 0 below 6 MHz, 1 below 16 MHz,
+    // 2 above
+    static constexpr uint8_t lpfForHz(uint32_t hz) {
+      return hz < 6000000 ? 0 : hz < 16000000 ? 1 : 2;
+    }
+
+    static constexpr int index(Id id) { return (int)id; }
+    static constexpr const Entry& get(int index) { return tables.entries[index]; }
+    static constexpr const Entry& get(Id id) { return get(index(id)); }
+
+    // "20m" and the like; -1 when not a band of the table
+    static constexpr int fromName(const char* name) {
+      if (!name) return -1;
+      unsigned m = 0;
+      int i = 0;
+      for (; i < 4 && name[i] >= '0' && name[i] <= '9'; i++) m = m * 10 + (unsigned)(name[i] - '0');
+      if (i == 0 || name[i] != 'm' || name[i + 1] != '\0' || m > maxMeters) return -1;
+      return tables.byMeters[m];
+    }
+
+    // Band dialled exactly at hz, or -1
+    static constexpr int fromDialHz(uint32_t hz) {
+      uint32_t mhz = hz / 1000000;
+      if (mhz > maxMHz) return -1;
+      int b = tables.byMHz[mhz];
+      return b >= 0 && tables.entries[b].dialHz == hz ? b : -1;
+    }
+
+    // WSPR-2 tone words for the default NCO, or nullptr when freqHz is
+    // not a dial frequency or the NCO differs
+    static constexpr const uint32_t* wsprWords(uint32_t freqHz, uint8_t steps, uint32_t clockHz) {
+      int b = fromDialHz(freqHz);
+      return b >= 0 && steps == defaultSteps && clockHz == exciterClkHz ? tables.entries[b].wsprWords : nullptr;
+    }
+
+  private:
+    static const unsigned maxMeters = 160;
+    static const uint32_t maxMHz = 29;
+
+    struct Tables {
+      Entry entries[count];
+      int8_t byMeters[maxMeters + 1];
+      int8_t byMHz[maxMHz + 1];
+    };
+
+    static constexpr Tables build() {
+      struct Band { const char* name; uint8_t meters; uint32_t dialHz; };
+      constexpr Band bands[count] = {
+	{ "160m", 160, 1836600 },
+	{ "80m",  80,  3568600 },
+	{ "60m",  60,  5287200 },
+	{ "40m",  40,  7038600 },
+	{ "30m",  30,  10138700 },
+	{ "20m",  20,  14095600 },
+	{ "17m",  17,  18104600 },
+	{ "15m",  15,  21094600 },
+	{ "12m",  12,  24924600 },
+	{ "10m",  10,  28124600 },
+      };
+
+      Tables t = {};
+      for (unsigned m = 0; m <= maxMeters; m++) t.byMeters[m] = -1;
+      for (uint32_t mhz = 0; mhz <= maxMHz; mhz++) t.byMHz[mhz] = -1;
+      for (int b = 0; b < count; b++) {
+	Entry& e = t.entries[b];
+	e.name = bands[b].name;
+	e.meters = bands[b].meters;
+	e.dialHz = bands[b].dialHz;
+	e.lpf = lpfForHz(e.dialHz);
+	for (int tone = 0; tone < Modulation::toneCount; tone++) {
+	  e.wsprWords[tone] = Modulation::toneWord(e.dialHz, tone, Modulation::wspr2SamplesPerSymbol,
+						   defaultSteps, exciterClkHz);
+	}
+	t.byMeters[e.meters] = (int8_t)b;
+	t.byMHz[e.dialHz / 1000000] = (int8_t)b;
+      }
+      return t;
+    }
+
+    static const Tables tables;
+  };
+
+  inline constexpr BandTable::Tables BandTable::tables = BandTable::build();
+
+  // Every band keeps to its own megahertz and below the NCO's limit at
+  // the default steps, so the lookups above stay one probe
+  static_assert(BandTable::fromDialHz(BandTable::get(BandTable::Id::Band160m).dialHz) == 0 &&
+		BandTable::fromDialHz(BandTable::get(BandTable::Id::Band10m).dialHz) == BandTable::count - 1,
+		"band table lookups");
+  static_assert(BandTable::get(BandTable::count - 1).dialHz < BandTable::exciterClkHz / BandTable::defaultSteps,
+		"bands within NCO range");
+
+} // namespace wspr
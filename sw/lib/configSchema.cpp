@@ -0,0 +1,174 @@
+/*
+ * Configuration Schema Implementation for WSPR-ease
+ */
+
+#include "configSchema.hpp"
+
+#include <cstring>
+
+namespace wspr {
+
+#define CONFIG_FIELD(key, name, kind) \
+  { key, #name, ConfigSchema::Kind::kind, offsetof(AppConfig, name), sizeof(AppConfig::name) }
+
+  // Keys are permanent: retire a key with its field, never renumber
+  const ConfigSchema::Field ConfigSchema::fields[nFields] = {
+    CONFIG_FIELD(1, callsign, Text),
+    CONFIG_FIELD(2, gridSquare, Text),
+    CONFIG_FIELD(3, powerDbm, Int),
+    CONFIG_FIELD(4, mode, Text),
+    CONFIG_FIELD(5, slotIntervalMin, Int),
+    CONFIG_FIELD(6, bandList, Text),
+    CONFIG_FIELD(7, bandEnabled, Flags),
+    CONFIG_FIELD(8, txMode, Text),
+  };
+
+#undef CONFIG_FIELD
+
+  // Run in order on a store older than `version`
+  const ConfigSchema::Migration ConfigSchema::migrations[] = {
+    { 0, fromV0 },
+    { 1, fromV1 },
+  };
+
+  // The version 0 record: AppConfig as it was, copied whole
+  struct AppConfigV0 {
+    char callsign[16];
+    char gridSquare[8];
+    int powerDbm;
+    char mode[16];
+    int slotIntervalMin;
+    char bandList[128];
+    bool bandEnabled[10];
+  };
+
+  static void copyText(char* dst, size_t size, const char* src, size_t srcSize) {
+    size_t n = strnlen(src, srcSize);
+    if (n >= size) n = size - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+  }
+
+  void ConfigSchema::fromV0(ReadFn read, void* ctx, AppConfig& cfg, LoadInfo& info) {
+    AppConfigV0 old;
+    if (read(legacyKey, &old, sizeof(old), ctx) != (int)sizeof(old)) return;
+
+    copyText(cfg.callsign, sizeof(cfg.callsign), old.callsign, sizeof(old.callsign));
+    copyText(cfg.gridSquare, sizeof(cfg.gridSquare), old.gridSquare, sizeof(old.gridSquare));
+    cfg.powerDbm = old.powerDbm;
+    copyText(cfg.mode, sizeof(cfg.mode), old.mode, sizeof(old.mode));
+    cfg.slotIntervalMin = old.slotIntervalMin;
+    copyText(cfg.bandList, sizeof(cfg.bandList), old.bandList, sizeof(old.bandList));
+    memcpy(cfg.bandEnabled, old.bandEnabled, sizeof(old.bandEnabled));
+    info.migrated = true;
+  }
+
+  // Band flags up to version 1 were 160, 80, 40, 30, 20, 17, 15, 12 and
+  // 10 m. BandTable put 60 m after 80 m; it starts disabled.
+  static const int bandsV1 = 9;
+  static const BandTable::Id bandV1[bandsV1] = {
+    BandTable::Id::Band160m, BandTable::Id::Band80m, BandTable::Id::Band40m,
+    BandTable::Id::Band30m, BandTable::Id::Band20m, BandTable::Id::Band17m,
+    BandTable::Id::Band15m, BandTable::Id::Band12m, BandTable::Id::Band10m,
+  };
+
+  static const uint16_t bandEnabledKey = 7;
+
+  void ConfigSchema::fromV1(ReadFn read, void* ctx, AppConfig& cfg, LoadInfo& info) {
+    // Flags taken from the version 0 record or a version 1 field are in
+    // the old order; without either they are already this layout's
+    // defaults
+    bool stored = info.migrated;
+    if (info.storedVersion > 0) {
+      uint8_t buf[maxRecord];
+      int n = read(bandEnabledKey, buf, sizeof(buf), ctx);
+      stored = n > 0 && n <= (int)sizeof(cfg.bandEnabled);
+    }
+    if (!stored) return;
+
+    bool old[bandsV1];
+    memcpy(old, cfg.bandEnabled, sizeof(old));
+    memset(cfg.bandEnabled, 0, sizeof(cfg.bandEnabled));
+    for (int i = 0; i < bandsV1; i++) cfg.bandEnabled[BandTable::index(bandV1[i])] = old[i];
+    info.migrated = true;
+  }
+
+  void ConfigSchema::load(ReadFn read, void* ctx, AppConfig& cfg, LoadInfo& info) {
+    cfg = AppConfig();
+    info = {};
+
+    uint16_t v;
+    if (read(versionKey, &v, sizeof(v), ctx) == (int)sizeof(v)) info.storedVersion = v;
+
+    // Version 0 had no field records. A newer version's records are
+    // still read; fields this firmware does not know stay untouched.
+    if (info.storedVersion > 0) {
+      uint8_t buf[maxRecord];
+      for (const Field& f : fields) {
+        int n = read(f.key, buf, sizeof(buf), ctx);
+        if (n >= 0 && decode(f, buf, (size_t)n, cfg)) info.fieldsRead++;
+      }
+    }
+
+    for (const Migration& m : migrations) {
+      if (m.from >= info.storedVersion && m.from < version) m.apply(read, ctx, cfg, info);
+    }
+  }
+
+  size_t ConfigSchema::encode(const Field& f, const AppConfig& cfg, uint8_t* buf) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&cfg) + f.offset;
+    switch (f.kind) {
+    case Kind::Text: {
+      size_t n = strnlen(reinterpret_cast<const char*>(p), f.size - 1);
+      memcpy(buf, p, n);
+      buf[n] = '\0';
+      return n + 1;
+    }
+    case Kind::Int: {
+      int32_t v = *reinterpret_cast<const int*>(p);
+      memcpy(buf, &v, sizeof(v));
+      return sizeof(v);
+    }
+    case Kind::Flags:
+      for (size_t i = 0; i < f.size; i++) buf[i] = p[i] ? 1 : 0;
+      return f.size;
+    }
+    return 0;
+  }
+
+  bool ConfigSchema::decode(const Field& f, const void* data, size_t len, AppConfig& cfg) {
+    uint8_t* p = reinterpret_cast<uint8_t*>(&cfg) + f.offset;
+    const uint8_t* d = static_cast<const uint8_t*>(data);
+    switch (f.kind) {
+    case Kind::Text:
+      if (len == 0 || len > f.size) return false;
+      copyText(reinterpret_cast<char*>(p), f.size, reinterpret_cast<const char*>(d), len);
+      return true;
+    case Kind::Int: {
+      int32_t v;
+      if (len != sizeof(v)) return false;
+      memcpy(&v, d, sizeof(v));
+      *reinterpret_cast<int*>(p) = v;
+      return true;
+    }
+    case Kind::Flags:
+      if (len == 0 || len > f.size) return false;
+      for (size_t i = 0; i < len; i++) p[i] = d[i] != 0;
+      return true;
+    }
+    return false;
+  }
+
+  bool ConfigSchema::differs(const Field& f, const AppConfig& a, const AppConfig& b) {
+    uint8_t ea[maxRecord], eb[maxRecord];
+    size_t na = encode(f, a, ea);
+    size_t nb = encode(f, b, eb);
+    return na != nb || memcmp(ea, eb, na) != 0;
+  }
+
+  void ConfigSchema::copy(const Field& f, const AppConfig& from, AppConfig& to) {
+    memcpy(reinterpret_cast<uint8_t*>(&to) + f.offset,
+           reinterpret_cast<const uint8_t*>(&from) + f.offset, f.size);
+  }
+
+} // namespace wspr
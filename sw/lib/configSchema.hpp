@@ -0,0 +1,96 @@
+/*
+ * Configuration Schema for WSPR-ease
+ * The user settings, stored one record per field under a schema
+ * version, with the migrations that bring older layouts forward.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include "bandTable.hpp"
+
+namespace wspr {
+
+  // Application configuration state (persisted to flash)
+  struct AppConfig {
+    char callsign[16] = "N0CALL";
+    char gridSquare[8] = "AA00";
+    int powerDbm = 23;
+    char mode[16] = "round-robin";
+    int slotIntervalMin = 10;
+    char bandList[128] = "";
+    bool bandEnabled[BandTable::count] = {false, false, false, false, false, true, false, false, false, false};	// 20m
+    char txMode[16] = "wspr2";	// Modulation name
+  };
+
+  class ConfigSchema {
+  public:
+    // Layout of the stored records. 0 was the whole struct in one record,
+    // 1 had the band flags without 60 m.
+    static const uint16_t version = 2;
+
+    // Record keys, mapped onto storage IDs by the caller. Field keys are
+    // 1..nFields and are never reused for a different field.
+    static const uint16_t versionKey = 0;
+    static const uint16_t legacyKey = 0xff;	// Version 0 struct
+
+    enum class Kind : uint8_t {
+      Text,	// NUL-terminated, stored without the unused tail
+      Int,	// int32_t
+      Flags,	// bool array, one byte each; a shorter record keeps the tail
+    };
+
+    struct Field {
+      uint16_t key;
+      const char* name;
+      Kind kind;
+      size_t offset;
+      size_t size;
+    };
+
+    static const int nFields = 8;
+    static const Field fields[nFields];
+
+    // Largest encoded field
+    static const size_t maxRecord = 128;
+
+    // Reads a record into buf; returns its length, or < 0 when missing
+    typedef int (*ReadFn)(uint16_t key, void* buf, size_t len, void* ctx);
+
+    struct LoadInfo {
+      uint16_t storedVersion;	// 0 when there was no version record
+      int fieldsRead;		// Field records found and accepted
+      bool migrated;		// Older layout converted; write all fields back
+    };
+
+    // Build a configuration from whatever is stored: defaults, then
+    // field records, then each migration from the stored version up.
+    static void load(ReadFn read, void* ctx, AppConfig& cfg, LoadInfo& info);
+
+    // Field value as stored; returns the record length
+    static size_t encode(const Field& f, const AppConfig& cfg, uint8_t* buf);
+
+    // Set the field from a record; false when its size does not fit
+    static bool decode(const Field& f, const void* data, size_t len, AppConfig& cfg);
+
+    // Whether the field would be stored differently
+    static bool differs(const Field& f, const AppConfig& a, const AppConfig& b);
+
+    // Copy one field across
+    static void copy(const Field& f, const AppConfig& from, AppConfig& to);
+
+  private:
+    struct Migration {
+      uint16_t from;	// Brings a store at this version to from + 1
+      void (*apply)(ReadFn read, void* ctx, AppConfig& cfg, LoadInfo& info);
+    };
+
+    static const Migration migrations[];
+
+    static void fromV0(ReadFn read, void* ctx, AppConfig& cfg, LoadInfo& info);
+    static void fromV1(ReadFn read, void* ctx, AppConfig& cfg, LoadInfo& info);
+  };
+
+} // namespace wspr
@@ -0,0 +1,98 @@
+/*
+ * Message Cache Implementation for WSPR-ease
+ */
+
+#include "messageCache.hpp"
+#include "bandTable.hpp"
+#include "wsprEncoder.hpp"
+
+#include <cstring>
+
+namespace wspr {
+
+  static void copyUpper(char* dst, size_t size, const char* src, size_t maxLen) {
+    size_t i = 0;
+    for (; src && src[i] && i < maxLen && i < size - 1; i++) {
+      char c = src[i];
+      dst[i] = (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : c;
+    }
+    memset(dst + i, 0, size - i);
+  }
+
+  MessageCache::Key MessageCache::keyFor(Modulation::Mode mode, BandPlanner::Message type,
+					 const char* callsign, const char* grid, int powerDbm) {
+    Key k;
+    memset(&k, 0, sizeof(k));
+    k.mode = mode;
+    k.type = type;
+    copyUpper(k.callsign, sizeof(k.callsign), callsign, sizeof(k.callsign));
+    switch (type) {
+    case BandPlanner::Message::Type1: copyUpper(k.grid, sizeof(k.grid), grid, 4); break;
+    case BandPlanner::Message::Type2: break;
+    case BandPlanner::Message::Type3: copyUpper(k.grid, sizeof(k.grid), grid, 6); break;
+    }
+    k.powerDbm = (int8_t)WsprEncoder::legalPower(powerDbm);
+    return k;
+  }
+
+  MessageCache::Entry* MessageCache::lookup(const Key& key) {
+    for (Entry& e : cache) {
+      if (e.used && memcmp(&e.key, &key, sizeof(key)) == 0) {
+	e.lastUse = ++uses;
+	return &e;
+      }
+    }
+    return nullptr;
+  }
+
+  const uint8_t* MessageCache::find(const Key& key) {
+    Entry* e = lookup(key);
+    if (e) counts.hits++;
+    return e ? e->symbols : nullptr;
+  }
+
+  const uint8_t* MessageCache::get(const Key& key) {
+    if (Entry* e = lookup(key)) {
+      counts.hits++;
+      return e->symbols;
+    }
+
+    Entry* victim = &cache[0];
+    for (Entry& e : cache) {
+      if (!e.used || (victim->used && e.lastUse < victim->lastUse)) victim = &e;
+    }
+
+    // Encoded aside so a refused message leaves the victim intact
+    uint8_t symbols[Modulation::maxSymbols];
+    bool ok = key.mode == Modulation::Mode::Wspr2 &&
+      WsprEncoder::encode(key.type, key.callsign, key.grid, key.powerDbm, symbols);
+    counts.misses++;
+    if (!ok) {
+      counts.failures++;
+      return nullptr;
+    }
+    memcpy(victim->symbols, symbols, sizeof(symbols));
+    victim->used = true;
+    victim->key = key;
+    victim->lastUse = ++uses;
+    return victim->symbols;
+  }
+
+  const uint32_t* MessageCache::tones(int band, Modulation::Mode mode, uint32_t freqHz, uint8_t steps,
+				     uint32_t clockHz) {
+    if (band < 0 || band >= BandPlanner::maxBands) return nullptr;
+    ToneTable& t = toneTables[band];
+    if (t.mode != mode || t.freqHz != freqHz || t.steps != steps || t.clockHz != clockHz) {
+      // The band table has WSPR-2 at the dial frequencies worked out
+      const uint32_t* pre = mode == Modulation::Mode::Wspr2 ? BandTable::wsprWords(freqHz, steps, clockHz) : nullptr;
+      const Modulation& m = Modulation::get(mode);
+      for (int i = 0; i < Modulation::toneCount; i++) t.words[i] = pre ? pre[i] : m.toneWord(freqHz, i, steps, clockHz);
+      t.mode = mode;
+      t.freqHz = freqHz;
+      t.steps = steps;
+      t.clockHz = clockHz;
+    }
+    return t.words;
+  }
+
+} // namespace wspr
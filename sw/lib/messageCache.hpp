@@ -0,0 +1,80 @@
+/*
+ * Message Cache for WSPR-ease
+ * Encoded WSPR messages keyed by what they carry, and the NCO
+ * tuning words of each band's four tones, so preparing a slot is a
+ * lookup.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "bandPlanner.hpp"
+#include "modulation.hpp"
+
+namespace wspr {
+
+  class MessageCache {
+  public:
+    // Type 1 and 3 of one station, with room for a locator change
+    static const int cacheSize = 4;
+
+    // The content of a message and nothing else: type 2 carries no
+    // locator and type 1 only four characters of it, so a finer GNSS
+    // locator does not re-encode those.
+    struct Key {
+      Modulation::Mode mode;
+      BandPlanner::Message type;
+      char callsign[16];
+      char grid[8];
+      int8_t powerDbm;
+    };
+
+    struct Stats {
+      uint32_t hits;
+      uint32_t misses;
+      uint32_t failures;	// Messages that cannot be encoded
+    };
+
+    static Key keyFor(Modulation::Mode mode, BandPlanner::Message type, const char* callsign,
+		      const char* grid, int powerDbm);
+
+    // The symbols of a message (Modulation::get(key.mode).symbolCount),
+    // encoded on a miss; nullptr when it cannot be encoded. Valid until
+    // the next get().
+    const uint8_t* get(const Key& key);
+
+    // Lookup only, never encodes
+    const uint8_t* find(const Key& key);
+
+    // The four tone words of a band, computed when its frequency, the
+    // mode or the step count changes
+    const uint32_t* tones(int band, Modulation::Mode mode, uint32_t freqHz, uint8_t steps, uint32_t clockHz);
+
+    Stats stats() const { return counts; }
+
+  private:
+    struct Entry {
+      bool used;
+      uint32_t lastUse;
+      Key key;
+      uint8_t symbols[Modulation::maxSymbols];
+    };
+
+    struct ToneTable {
+      Modulation::Mode mode;
+      uint32_t freqHz;
+      uint8_t steps;
+      uint32_t clockHz;
+      uint32_t words[Modulation::toneCount];
+    };
+
+    Entry* lookup(const Key& key);
+
+    Entry cache[cacheSize] = {};
+    ToneTable toneTables[BandPlanner::maxBands] = {};
+    uint32_t uses = 0;
+    Stats counts = {};
+  };
+
+} // namespace wspr
@@ -0,0 +1,31 @@
+/*
+ * Modulation Parameters Implementation for WSPR-ease
+ */
+
+#include "modulation.hpp"
+
+#include <cstring>
+
+namespace wspr {
+
+  static constexpr Modulation modulations[Modulation::modeCount] = {
+    { Modulation::Mode::Wspr2,     "wspr2",      120,  162, 8192 },
+  };
+  static_assert(modulations[0].samplesPerSymbol == Modulation::wspr2SamplesPerSymbol, "WSPR-2 symbol length");
+
+  const Modulation& Modulation::get(Mode mode) {
+    int i = (int)mode;
+    return modulations[i < modeCount ? i : 0];
+  }
+
+  bool Modulation::fromName(const char* name, Mode& out) {
+    for (const Modulation& m : modulations) {
+      if (name && strcmp(m.name, name) == 0) {
+	out = m.mode;
+	return true;
+      }
+    }
+    return false;
+  }
+
+} // namespace wspr
@@ -0,0 +1,64 @@
+/*
+ * Modulation Parameters for WSPR-ease
+ * The transmit modes and what the symbol engine needs of each: slot
+ * period, symbol count and length, and tone spacing. All are 4-FSK with
+ * tones one symbol rate apart, timed in samples of the 12 kHz rate the
+ * WSJT-X modes are defined at. Only WSPR-2 so far; FST4W waits for its
+ * LDPC tables and reference vectors.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace wspr {
+
+  struct Modulation {
+    enum class Mode : uint8_t { Wspr2 };
+    static const int modeCount = 1;
+    static const uint32_t sampleRate = 12000;
+    static const int maxSymbols = 162;
+    static const int toneCount = 4;
+    static const uint32_t wspr2SamplesPerSymbol = 8192;
+
+    Mode mode;
+    const char* name;
+    uint16_t periodSec;		// Slots start on multiples of this from 00:00 UTC
+    uint16_t symbolCount;
+    uint32_t samplesPerSymbol;	// At sampleRate
+
+    double toneSpacingHz() const { return (double)sampleRate / samplesPerSymbol; }
+    double symbolSec() const { return (double)samplesPerSymbol / sampleRate; }
+    double airtimeSec() const { return symbolSec() * symbolCount; }
+    int periodMin() const { return periodSec / 60; }
+
+    // Tuning word of a tone for an NCO taking steps per RF cycle from a
+    // clockHz exciter clock; tone 0 is the dial frequency. Exact to the
+    // truncation the FPGA driver uses for whole hertz.
+    uint32_t toneWord(uint32_t freqHz, int tone, uint8_t steps, uint32_t clockHz) const {
+      return toneWord(freqHz, tone, samplesPerSymbol, steps, clockHz);
+    }
+
+    // Same for a symbol length, at compile time
+    static constexpr uint32_t toneWord(uint32_t freqHz, int tone, uint32_t nsps, uint8_t steps,
+				       uint32_t clockHz) {
+      // (freq + tone * 12000 / nsps) * steps / clock * 2^32
+      //   = (nsps freq + 12000 tone) * steps * 2^32 / (nsps clock)
+      // The numerator and denominator fit 64 bits for every mode; the
+      // 2^32 is brought in 16 bits at a time by long division.
+      uint64_t num = ((uint64_t)freqHz * nsps + (uint64_t)tone * sampleRate) * steps;
+      uint64_t den = (uint64_t)nsps * clockHz;
+      uint64_t q = num / den, r = num % den;
+      uint64_t hi = (r << 16) / den;
+      r = (r << 16) % den;
+      uint64_t lo = (r << 16) / den;
+      return (uint32_t)((q << 32) | (hi << 16) | lo);
+    }
+
+    static const Modulation& get(Mode mode);
+
+    // "wspr2"; false for an unknown name
+    static bool fromName(const char* name, Mode& out);
+  };
+
+} // namespace wspr
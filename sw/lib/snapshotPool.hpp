@@ -0,0 +1,100 @@
+/*
+ * Snapshot Pool for WSPR-ease
+ * Immutable copies of a value shared between threads, RCU style: a
+ * writer fills a free slot and publishes it with one pointer swap,
+ * readers take a counted reference without locking and keep a
+ * consistent copy for as long as they hold it.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace wspr {
+
+  // N slots: one current, the rest for references still held to older
+  // snapshots while a new one is written
+  template <typename T, int N>
+  class SnapshotPool {
+    struct Slot {
+      T value;
+      uint32_t generation = 0;
+      mutable std::atomic<int> readers{0};
+    };
+
+  public:
+    static_assert(N >= 2, "a snapshot pool needs a spare slot");
+
+    // Counted reference to one snapshot; the slot is not reused while
+    // it is held
+    class Ref {
+    public:
+      Ref() = default;
+      Ref(Ref&& o) : slot(o.slot) { o.slot = nullptr; }
+      Ref& operator=(Ref&& o) {
+        if (this != &o) {
+          release();
+          slot = o.slot;
+          o.slot = nullptr;
+        }
+        return *this;
+      }
+      Ref(const Ref&) = delete;
+      Ref& operator=(const Ref&) = delete;
+      ~Ref() { release(); }
+
+      explicit operator bool() const { return slot != nullptr; }
+      const T& operator*() const { return slot->value; }
+      const T* operator->() const { return &slot->value; }
+      // Counts publications, so a holder can tell that it changed
+      uint32_t generation() const { return slot ? slot->generation : 0; }
+
+    private:
+      friend class SnapshotPool;
+      explicit Ref(const Slot* s) : slot(s) {}
+      void release() {
+        if (slot) slot->readers.fetch_sub(1);
+        slot = nullptr;
+      }
+      const Slot* slot = nullptr;
+    };
+
+    // Lock-free; empty until the first publish()
+    Ref acquire() const {
+      for (;;) {
+        Slot* s = current.load();
+        if (!s) return Ref();
+        s->readers.fetch_add(1);
+        // Still current, so the writer cannot have been refilling it
+        if (current.load() == s) return Ref(s);
+        s->readers.fetch_sub(1);
+      }
+    }
+
+    // Publish a copy of value. Writers must be serialized by the caller.
+    // Returns false when every other slot is still referenced.
+    bool publish(const T& value) {
+      Slot* cur = current.load();
+      for (Slot& s : slots) {
+        if (&s == cur || s.readers.load() != 0) continue;
+        // A reader that took s before it stopped being current backs
+        // off at its second look, so s is ours to fill
+        s.value = value;
+        s.generation = published.load() + 1;
+        published.store(s.generation);
+        current.store(&s);
+        return true;
+      }
+      return false;
+    }
+
+    uint32_t generation() const { return published.load(); }
+
+  private:
+    Slot slots[N];
+    std::atomic<Slot*> current{nullptr};
+    std::atomic<uint32_t> published{0};
+  };
+
+} // namespace wspr
@@ -0,0 +1,151 @@
+/*
+ * Solar Calculator Implementation for WSPR-ease
+ * Follows the NOAA solar calculator spreadsheet: Meeus' low-precision
+ * solar coordinates, the equation of time and a 90.833 degree zenith
+ * for refraction and the solar disc.
+ */
+
+#include "solarCalc.hpp"
+
+#include <cmath>
+
+namespace wspr {
+
+  static const double degToRad = M_PI / 180.0;
+  static const double minutesPerDay = 1440.0;
+
+  struct SolarPosition {
+    double declRad;
+    double eqTimeMin;
+  };
+
+  // Declination and equation of time at a Julian day
+  static SolarPosition position(double jd) {
+    double t = (jd - 2451545.0) / 36525.0;
+
+    double l0 = fmod(280.46646 + t * (36000.76983 + t * 0.0003032), 360.0);
+    double m = 357.52911 + t * (35999.05029 - 0.0001537 * t);
+    double e = 0.016708634 - t * (0.000042037 + 0.0000001267 * t);
+    double mr = m * degToRad;
+    double c = sin(mr) * (1.914602 - t * (0.004817 + 0.000014 * t))
+      + sin(2 * mr) * (0.019993 - 0.000101 * t) + sin(3 * mr) * 0.000289;
+
+    double omega = (125.04 - 1934.136 * t) * degToRad;
+    double lambda = (l0 + c - 0.00569 - 0.00478 * sin(omega)) * degToRad;
+    double eps0 = 23.0 + (26.0 + (21.448 - t * (46.815 + t * (0.00059 - t * 0.001813))) / 60.0) / 60.0;
+    double eps = (eps0 + 0.00256 * cos(omega)) * degToRad;
+
+    double y = tan(eps / 2) * tan(eps / 2);
+    double l0r = l0 * degToRad;
+    double eq = y * sin(2 * l0r) - 2 * e * sin(mr) + 4 * e * y * sin(mr) * cos(2 * l0r)
+      - 0.5 * y * y * sin(4 * l0r) - 1.25 * e * e * sin(2 * mr);
+
+    return { asin(sin(eps) * sin(lambda)), 4.0 * eq / degToRad };
+  }
+
+  // Hour angle of sunrise in degrees; > 180 or < 0 flag polar day/night
+  static double sunriseHourAngle(double latRad, double declRad) {
+    double cosHa = cos(90.833 * degToRad) / (cos(latRad) * cos(declRad)) - tan(latRad) * tan(declRad);
+    if (cosHa < -1.0) return 180.0 + 1.0;	// Polar day
+    if (cosHa > 1.0) return -1.0;		// Polar night
+    return acos(cosHa) / degToRad;
+  }
+
+  static int16_t wrapMinute(double m) {
+    int v = (int)lround(m) % (int)minutesPerDay;
+    return (int16_t)(v < 0 ? v + (int)minutesPerDay : v);
+  }
+
+  SolarCalc::Day SolarCalc::compute(int32_t utcDay, double latDeg, double lonDeg) {
+    if (latDeg > 89.99) latDeg = 89.99;
+    if (latDeg < -89.99) latDeg = -89.99;
+    double latRad = latDeg * degToRad;
+    double jd0 = utcDay + 2440587.5;
+
+    // Solar noon, refined once at its own time
+    double noon = 720.0 - 4.0 * lonDeg - position(jd0 + 0.5).eqTimeMin;
+    SolarPosition atNoon = position(jd0 + noon / minutesPerDay);
+    noon = 720.0 - 4.0 * lonDeg - atNoon.eqTimeMin;
+
+    Day d = {};
+    d.noonMin = wrapMinute(noon);
+
+    double ha = sunriseHourAngle(latRad, atNoon.declRad);
+    if (ha > 180.0 || ha < 0.0) {
+      d.sky = ha > 180.0 ? Sky::PolarDay : Sky::PolarNight;
+      d.daylightMin = ha > 180.0 ? (int16_t)minutesPerDay : 0;
+      d.sunriseMin = wrapMinute(noon - d.daylightMin / 2);
+      d.sunsetMin = wrapMinute(noon + d.daylightMin / 2);
+      return d;
+    }
+
+    // Each event again with the sun's position at that event
+    double rise = noon - 4.0 * ha;
+    double set = noon + 4.0 * ha;
+    SolarPosition p = position(jd0 + rise / minutesPerDay);
+    double haRise = sunriseHourAngle(latRad, p.declRad);
+    if (haRise >= 0.0 && haRise <= 180.0) rise = 720.0 - 4.0 * (lonDeg + haRise) - p.eqTimeMin;
+    p = position(jd0 + set / minutesPerDay);
+    double haSet = sunriseHourAngle(latRad, p.declRad);
+    if (haSet >= 0.0 && haSet <= 180.0) set = 720.0 - 4.0 * (lonDeg - haSet) - p.eqTimeMin;
+
+    d.sky = Sky::Normal;
+    d.sunriseMin = wrapMinute(rise);
+    d.sunsetMin = wrapMinute(set);
+    d.daylightMin = (int16_t)lround(set - rise);
+    return d;
+  }
+
+  bool SolarCalc::gridToLatLon(const char* grid, double& latDeg, double& lonDeg) {
+    auto upper = [](char c) { return (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : c; };
+    if (!grid) return false;
+    int len = 0;
+    while (grid[len] && len < 7) len++;
+    if (len != 4 && len != 6) return false;
+
+    char f0 = upper(grid[0]), f1 = upper(grid[1]);
+    if (f0 < 'A' || f0 > 'R' || f1 < 'A' || f1 > 'R') return false;
+    if (grid[2] < '0' || grid[2] > '9' || grid[3] < '0' || grid[3] > '9') return false;
+
+    lonDeg = -180.0 + (f0 - 'A') * 20.0 + (grid[2] - '0') * 2.0;
+    latDeg = -90.0 + (f1 - 'A') * 10.0 + (grid[3] - '0') * 1.0;
+    if (len == 4) {
+      lonDeg += 1.0;
+      latDeg += 0.5;
+      return true;
+    }
+
+    char s0 = upper(grid[4]), s1 = upper(grid[5]);
+    if (s0 < 'A' || s0 > 'X' || s1 < 'A' || s1 > 'X') return false;
+    lonDeg += (s0 - 'A') * (2.0 / 24) + 1.0 / 24;
+    latDeg += (s1 - 'A') * (1.0 / 24) + 0.5 / 24;
+    return true;
+  }
+
+  const SolarCalc::Day& SolarCalc::get(int64_t unixTime, double latDeg, double lonDeg) {
+    int32_t day = (int32_t)(unixTime >= 0 ? unixTime / 86400 : (unixTime - 86399) / 86400);
+    int16_t cellLat = (int16_t)floor(latDeg / cellDeg);
+    int16_t cellLon = (int16_t)floor(lonDeg / cellDeg);
+    uses++;
+
+    Entry* victim = &cache[0];
+    for (Entry& e : cache) {
+      if (e.used && e.day == day && e.cellLat == cellLat && e.cellLon == cellLon) {
+        e.lastUse = uses;
+        counts.hits++;
+        return e.result;
+      }
+      if (!e.used || (victim->used && e.lastUse < victim->lastUse)) victim = &e;
+    }
+
+    counts.misses++;
+    victim->used = true;
+    victim->day = day;
+    victim->cellLat = cellLat;
+    victim->cellLon = cellLon;
+    victim->lastUse = uses;
+    victim->result = compute(day, (cellLat + 0.5) * cellDeg, (cellLon + 0.5) * cellDeg);
+    return victim->result;
+  }
+
+} // namespace wspr
@@ -0,0 +1,68 @@
+/*
+ * Solar Calculator for WSPR-ease
+ * Sunrise and sunset by the NOAA (Meeus) method, memoized per UTC day
+ * and location cell so band windows never redo the trigonometry.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace wspr {
+
+  class SolarCalc {
+  public:
+    enum class Sky : uint8_t {
+      Normal,
+      PolarDay,		// Sun above the horizon all day
+      PolarNight,	// Sun below it all day
+    };
+
+    // Times are UTC minutes of day. In polar day and night sunrise and
+    // sunset are solar noon -/+ half of daylightMin (1440 or 0).
+    struct Day {
+      Sky sky;
+      int16_t sunriseMin;
+      int16_t sunsetMin;
+      int16_t noonMin;
+      int16_t daylightMin;
+    };
+
+    struct Stats {
+      uint32_t hits;
+      uint32_t misses;
+    };
+
+    // Positions within a cell share one result, computed at its centre;
+    // 0.1 degree moves sunrise by well under a minute
+    static constexpr double cellDeg = 0.1;
+    static const int cacheSize = 4;
+
+    // Direct computation for a day (days since 1970-01-01), latitude
+    // north and longitude east in degrees
+    static Day compute(int32_t utcDay, double latDeg, double lonDeg);
+
+    // Centre of a 4 or 6 character Maidenhead locator
+    static bool gridToLatLon(const char* grid, double& latDeg, double& lonDeg);
+
+    // Memoized: the UTC day of unixTime at the cell holding the position
+    const Day& get(int64_t unixTime, double latDeg, double lonDeg);
+
+    Stats stats() const { return counts; }
+
+  private:
+    struct Entry {
+      bool used;
+      int32_t day;
+      int16_t cellLat;
+      int16_t cellLon;
+      uint32_t lastUse;
+      Day result;
+    };
+
+    Entry cache[cacheSize] = {};
+    uint32_t uses = 0;
+    Stats counts = {};
+  };
+
+} // namespace wspr
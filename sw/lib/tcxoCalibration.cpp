@@ -0,0 +1,59 @@
+/*
+ * TCXO Calibration Record Implementation for WSPR-ease
+ */
+
+#include "tcxoCalibration.hpp"
+
+namespace wspr {
+
+  static const double secPerDay = 86400.0;
+  // No prediction reaches further than this past the last save
+  static const double maxPredictDays = 365.0;
+
+  bool TcxoCalibration::load(const Record& r) {
+    if (r.version != recordVersion) return false;
+    rec = r;
+    return true;
+  }
+
+  double TcxoCalibration::predict(int64_t unixTime) const {
+    if (!valid()) return 0.0;
+    if (unixTime <= rec.unixTime) return rec.ppm;
+
+    double days = (unixTime - rec.unixTime) / secPerDay;
+    if (days > maxPredictDays) days = maxPredictDays;
+    return rec.ppm + rec.ratePpmPerDay * days;
+  }
+
+  bool TcxoCalibration::update(double ppm, int64_t unixTime) {
+    if (unixTime <= 0) return false;
+
+    if (!valid()) {
+      rec = {};
+      rec.version = recordVersion;
+      rec.anchorPpm = ppm;
+      rec.anchorTime = unixTime;
+    } else {
+      bool moved = ppm - rec.ppm > savePpm || rec.ppm - ppm > savePpm;
+      if (!moved && unixTime - rec.unixTime < saveIntervalSec) return false;
+    }
+
+    // Slope from the anchor once it is old enough, averaged with the
+    // previous slope; the anchor then moves up to this point
+    double days = (unixTime - rec.anchorTime) / secPerDay;
+    if (days >= minRateDays) {
+      double rate = (ppm - rec.anchorPpm) / days;
+      if (rate > maxRatePpmPerDay) rate = maxRatePpmPerDay;
+      if (rate < -maxRatePpmPerDay) rate = -maxRatePpmPerDay;
+      rec.ratePpmPerDay = rec.ratePpmPerDay != 0.0 ? (rec.ratePpmPerDay + rate) / 2 : rate;
+      rec.anchorPpm = ppm;
+      rec.anchorTime = unixTime;
+    }
+
+    rec.ppm = ppm;
+    rec.unixTime = unixTime;
+    rec.saves++;
+    return true;
+  }
+
+} // namespace wspr
@@ -0,0 +1,54 @@
+/*
+ * TCXO Calibration Record for WSPR-ease
+ * The last measured reference error and a linear aging model, kept in
+ * NVS so a cold boot starts close to the right frequency.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace wspr {
+
+  class TcxoCalibration {
+  public:
+    static const uint32_t recordVersion = 1;
+
+    // Stored as is, so only append fields and bump recordVersion
+    struct Record {
+      uint32_t version;
+      uint32_t saves;
+      double ppm;		// Reference error when last saved
+      int64_t unixTime;		// When ppm was measured
+      double ratePpmPerDay;	// Aging, 0 until two saves are far enough apart
+      double anchorPpm;		// Older point the rate is measured from
+      int64_t anchorTime;
+    };
+
+    // Aging is only measured over at least this long, and clamped, so
+    // temperature swings between two saves do not pass for aging
+    static constexpr double minRateDays = 2.0;
+    static constexpr double maxRatePpmPerDay = 0.01;
+    // Save when the error moved this far, or this long after the last
+    // save so the aging baseline keeps up
+    static constexpr double savePpm = 0.02;
+    static const int64_t saveIntervalSec = 6 * 3600;
+
+    bool valid() const { return rec.version == recordVersion; }
+    const Record& record() const { return rec; }
+
+    // Returns false for a record from another firmware version
+    bool load(const Record& r);
+
+    // Expected error at unixTime (0 when the time is not known yet)
+    double predict(int64_t unixTime) const;
+
+    // Take a measurement. Returns true when the record changed enough
+    // that it should be written back.
+    bool update(double ppm, int64_t unixTime);
+
+  private:
+    Record rec = {};
+  };
+
+} // namespace wspr
@@ -0,0 +1,173 @@
+/*
+ * TCXO Frequency Estimator Implementation for WSPR-ease
+ */
+
+#include "tcxoEstimator.hpp"
+
+#include <cmath>
+#include <errno.h>
+
+namespace wspr {
+
+  // Intervals averaged before the tracked frequency is trusted, and
+  // the time constant it then follows the reference with
+  static const uint32_t trackWarmup = 4;
+  static const uint32_t trackSpan = 16;
+  // Consecutive rejections taken as a real frequency step
+  static const uint32_t maxRejectRun = 8;
+
+  void TcxoEstimator::Gate::add(uint64_t intervalCounts, uint32_t n, double nominal) {
+    if (sec + n > tau) {
+      // A missed edge on the gate boundary: no exact gate ends here, so
+      // start a fresh one from this edge
+      restart();
+      return;
+    }
+
+    sec += n;
+    counts += intervalCounts;
+    if (sec < tau) return;
+
+    double y = counts / (tau * nominal) - 1.0;
+    if (chained) {
+      sumSq += (y - lastY) * (y - lastY);
+      pairs++;
+    }
+    lastY = y;
+    haveLast = true;
+    chained = true;
+    sec = 0;
+    counts = 0;
+  }
+
+  // Non-overlapping Allan deviation, in ppm
+  double TcxoEstimator::Gate::adev() const {
+    return pairs ? sqrt(sumSq / (2.0 * pairs)) * 1e6 : 0.0;
+  }
+
+  TcxoEstimator::TcxoEstimator(double countsPerSec, uint8_t stampBits, uint8_t genBits)
+    : nominal(countsPerSec),
+      stampMask(stampBits >= 32 ? 0xFFFFFFFFu : (1u << stampBits) - 1),
+      stampWrap((uint64_t)stampMask + 1),
+      genMask((uint8_t)((1u << genBits) - 1)) {
+    for (int i = 0; i < nTableGates; i++) gates[i].tau = tableGates[i];
+    estGate.tau = 100;
+  }
+
+  void TcxoEstimator::addStamp(uint32_t stamp, uint8_t gen, int64_t uptimeMs) {
+    if (!primed) {
+      lastStamp = stamp;
+      lastGen = gen;
+      lastEdgeMs = uptimeMs;
+      primed = true;
+      return;
+    }
+
+    uint32_t n = (uint8_t)(gen - lastGen) & genMask;
+    if (n == 0) return;
+
+    // gen counts the seconds modulo its wrap; the local clock picks the
+    // multiple when the readings were far apart
+    double elapsed = (uptimeMs - lastEdgeMs) / 1000.0;
+    uint32_t genWrap = (uint32_t)genMask + 1;
+    while (elapsed - n > genWrap / 2.0) n += genWrap;
+
+    // Likewise the stamp only holds the counts modulo its wrap
+    double expect = n * nominal;
+    uint32_t d = (stamp - lastStamp) & stampMask;
+    int64_t k = llround((expect - d) / (double)stampWrap);
+    uint64_t total = d + (uint64_t)(k > 0 ? k : 0) * stampWrap;
+    double y = total / expect - 1.0;
+
+    lastStamp = stamp;
+    lastGen = gen;
+    lastEdgeMs = uptimeMs;
+
+    // A glitch on the PPS line spoils the intervals either side of it.
+    // Both are rejected and every gate restarts from the next good
+    // edge, so no gate ever contains a bad edge.
+    bool outlier = fabs(y) * 1e6 > limitPpm
+      || (trackN >= trackWarmup && fabs(y - trackY) * 1e6 > outlierPpm);
+    if (outlier) {
+      counts.rejected++;
+      resync();
+      if (++rejectRun >= maxRejectRun) trackN = 0;
+      return;
+    }
+
+    rejectRun = 0;
+    counts.edges++;
+    counts.missed += n - 1;
+
+    if (trackN < trackSpan) trackN++;
+    trackY += (y - trackY) / trackN;
+
+    for (int i = 0; i < nTableGates; i++) gates[i].add(total, n, nominal);
+    estGate.add(total, n, nominal);
+  }
+
+  int TcxoEstimator::setGate(uint16_t seconds) {
+    if (seconds < 1 || seconds > maxGateSec) return -EINVAL;
+    estGate = Gate();
+    estGate.tau = seconds;
+    return 0;
+  }
+
+  TcxoEstimator::Estimate TcxoEstimator::estimate() const {
+    Estimate e = {};
+    if (estGate.haveLast) {
+      e.tauSec = estGate.tau;
+      e.ppm = estGate.lastY * 1e6;
+    } else if (estGate.sec > 0) {
+      e.tauSec = estGate.sec;
+      e.ppm = (estGate.counts / (estGate.sec * nominal) - 1.0) * 1e6;
+    } else {
+      return e;
+    }
+    e.valid = true;
+    e.uncertaintyPpm = uncertaintyAt(e.tauSec);
+    return e;
+  }
+
+  // One gate of tau seconds scatters by the Allan deviation at tau.
+  // Until that is measured, use the deviation at the longest shorter
+  // gate (the curve falls with tau until the flicker floor, so this is
+  // conservative), or failing that one count in tau seconds.
+  double TcxoEstimator::uncertaintyAt(uint16_t tau) const {
+    if (estGate.tau == tau && estGate.pairs) return estGate.adev();
+    for (int i = nTableGates - 1; i >= 0; i--) {
+      if (gates[i].tau <= tau && gates[i].pairs) return gates[i].adev();
+    }
+    return 1e6 / (tau * nominal);
+  }
+
+  int TcxoEstimator::adevTable(AdevPoint* out, int maxOut) const {
+    int n = 0;
+    for (int i = 0; i < nTableGates && n < maxOut; i++, n++) {
+      out[n].tauSec = gates[i].tau;
+      out[n].pairs = gates[i].pairs;
+      out[n].adevPpm = gates[i].adev();
+    }
+    return n;
+  }
+
+  void TcxoEstimator::resync() {
+    for (int i = 0; i < nTableGates; i++) gates[i].restart();
+    estGate.restart();
+  }
+
+  void TcxoEstimator::reset() {
+    for (int i = 0; i < nTableGates; i++) {
+      uint16_t tau = gates[i].tau;
+      gates[i] = Gate();
+      gates[i].tau = tau;
+    }
+    setGate(estGate.tau);
+    primed = false;
+    trackN = 0;
+    trackY = 0;
+    rejectRun = 0;
+    counts = {};
+  }
+
+} // namespace wspr
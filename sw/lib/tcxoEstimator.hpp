@@ -0,0 +1,108 @@
+/*
+ * TCXO Frequency Estimator for WSPR-ease
+ * Long-gate reference error estimate and Allan deviation from GNSS PPS
+ * timestamps. Plain C++ with no Zephyr dependencies so it can be
+ * tested on the host.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace wspr {
+
+  class TcxoEstimator {
+  public:
+    // Gates of the Allan deviation table, in seconds
+    static constexpr int nTableGates = 10;
+    static constexpr uint16_t tableGates[nTableGates] = {1, 2, 5, 10, 20, 50, 100, 200, 500, 1000};
+    static constexpr uint16_t maxGateSec = 1000;
+
+    struct Estimate {
+      bool valid;
+      double ppm;		// Positive when the reference runs fast
+      double uncertaintyPpm;	// One sigma
+      uint16_t tauSec;		// Seconds actually averaged
+    };
+
+    struct AdevPoint {
+      uint16_t tauSec;
+      uint32_t pairs;		// Adjacent gate pairs averaged
+      double adevPpm;
+    };
+
+    struct Stats {
+      uint32_t edges;		// PPS edges accepted
+      uint32_t missed;		// Edges skipped over between readings
+      uint32_t rejected;	// Intervals rejected as outliers
+    };
+
+    // countsPerSec is the nominal stamp rate (half clocks for the FPGA
+    // PPS register); stamps wrap at 2^stampBits and gen at 2^genBits.
+    TcxoEstimator(double countsPerSec, uint8_t stampBits, uint8_t genBits);
+
+    // Feed one reading of the PPS stamp and generation, taken at
+    // uptimeMs. Readings with an unchanged gen are ignored; poll at
+    // least twice a second so the local clock can count the seconds
+    // between edges when some were missed.
+    void addStamp(uint32_t stamp, uint8_t gen, int64_t uptimeMs);
+
+    // Gate averaged for estimate(), 1 to maxGateSec seconds
+    int setGate(uint16_t seconds);
+    uint16_t gate() const { return estGate.tau; }
+
+    // The last complete gate, or the part gate before the first one
+    // completes
+    Estimate estimate() const;
+    int adevTable(AdevPoint* out, int maxOut) const;
+    Stats stats() const { return counts; }
+
+    void reset();
+
+    // Rejection limits: any interval beyond limitPpm, and once tracking,
+    // any interval further than outlierPpm from the tracked frequency
+    double limitPpm = 100.0;
+    double outlierPpm = 1.0;
+
+  private:
+    // One gate length. Sums the counts of whole PPS intervals and
+    // compares each complete gate with the one before it.
+    struct Gate {
+      uint16_t tau = 0;
+      uint16_t sec = 0;
+      uint64_t counts = 0;
+      bool haveLast = false;	// lastY holds a complete gate
+      bool chained = false;	// and the next one will be adjacent
+      double lastY = 0;
+      double sumSq = 0;
+      uint32_t pairs = 0;
+
+      void add(uint64_t intervalCounts, uint32_t n, double nominal);
+      void restart() { sec = 0; counts = 0; chained = false; }
+      double adev() const;
+    };
+
+    void resync();
+    double uncertaintyAt(uint16_t tau) const;
+
+    double nominal;
+    uint32_t stampMask;
+    uint64_t stampWrap;
+    uint8_t genMask;
+
+    bool primed = false;
+    uint32_t lastStamp = 0;
+    uint8_t lastGen = 0;
+    int64_t lastEdgeMs = 0;
+
+    // Per-second frequency tracked for outlier rejection
+    uint32_t trackN = 0;
+    double trackY = 0;
+    uint32_t rejectRun = 0;
+
+    Gate gates[nTableGates];
+    Gate estGate;
+    Stats counts = {};
+  };
+
+} // namespace wspr
@@ -0,0 +1,265 @@
+/*
+ * WSPR Encoder Implementation for WSPR-ease
+ * Follows the WSPR-2 protocol as implemented by WSJT-X (wsprcode) and
+ * described by G4JNT: 50 source bits, a K=32 rate 1/2 convolutional
+ * code, bit-reversed interleaving and a fixed sync vector.
+ */
+
+#include "wsprEncoder.hpp"
+
+#include <cstdlib>
+
+namespace wspr {
+
+  static const uint8_t syncVector[WsprEncoder::symbolCount] = {
+    1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0, 1, 0, 0, 1, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0,
+    0, 1, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 0, 1, 1, 0, 1, 0, 0, 0,
+    0, 1, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 0, 1, 0, 0, 1, 0, 1, 1, 0, 0, 0, 1, 1, 0, 1, 0, 1, 0, 0, 0, 1,
+    0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 1, 1, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0,
+    0, 1, 0, 1, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 0, 1, 1, 0, 0, 0, 1, 1, 0, 0, 0,
+  };
+
+  static const uint32_t poly1 = 0xf2d05351;
+  static const uint32_t poly2 = 0xe4613c47;
+
+  static char upper(char c) {
+    return (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : c;
+  }
+
+  static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+  static bool isLetter(char c) { return c >= 'A' && c <= 'Z'; }
+
+  static int length(const char* s) {
+    int n = 0;
+    while (s[n]) n++;
+    return n;
+  }
+
+  // 0-9, A-Z, then space
+  static int charCode(char c) {
+    if (isDigit(c)) return c - '0';
+    if (isLetter(c)) return c - 'A' + 10;
+    return 36;
+  }
+
+  // 28 bits for a callsign of at most 6 characters whose third (or,
+  // with a single-character prefix, second) character is a digit
+  static bool packCall(const char* call, int len, uint32_t& n) {
+    char c[6];
+    if (len < 2 || len > 6) return false;
+    int pad = isDigit(upper(call[2])) ? 0 : isDigit(upper(call[1])) ? 1 : -1;
+    if (pad < 0 || len + pad > 6) return false;
+    for (int i = 0; i < 6; i++) {
+      int k = i - pad;
+      c[i] = k >= 0 && k < len ? upper(call[k]) : ' ';
+    }
+
+    if (!(isDigit(c[0]) || isLetter(c[0]) || c[0] == ' ')) return false;
+    if (!(isDigit(c[1]) || isLetter(c[1])) || !isDigit(c[2])) return false;
+    for (int i = 3; i < 6; i++) {
+      if (!(isLetter(c[i]) || c[i] == ' ')) return false;
+    }
+    // Trailing characters only: "K1 BC" is not a callsign
+    for (int i = 4; i < 6; i++) {
+      if (c[i - 1] == ' ' && c[i] != ' ') return false;
+    }
+
+    n = (uint32_t)charCode(c[0]);
+    n = n * 36 + (uint32_t)charCode(c[1]);
+    n = n * 10 + (uint32_t)charCode(c[2]);
+    for (int i = 3; i < 6; i++) n = n * 27 + (uint32_t)(charCode(c[i]) - 10);
+    return true;
+  }
+
+  // 15 bits for a 4-character locator
+  static bool packGrid(const char* grid, uint32_t& ng) {
+    char g0 = upper(grid[0]), g1 = upper(grid[1]);
+    if (g0 < 'A' || g0 > 'R' || g1 < 'A' || g1 > 'R' || !isDigit(grid[2]) || !isDigit(grid[3])) {
+      return false;
+    }
+    ng = (uint32_t)((179 - 10 * (g0 - 'A') - (grid[2] - '0')) * 180 + 10 * (g1 - 'A') + (grid[3] - '0'));
+    return true;
+  }
+
+  // Base callsign and the 15-bit add-on of a type 2 message. A prefix
+  // or suffix number of 32768 or more moves its top bit into the power
+  // field (nadd).
+  static bool packCompound(const char* call, uint32_t& n, uint32_t& ng, int& nadd) {
+    int len = length(call);
+    int slash = -1;
+    for (int i = 0; i < len; i++) {
+      if (call[i] != '/') continue;
+      if (slash >= 0) return false;
+      slash = i;
+    }
+    if (slash < 0) return false;
+
+    const char* after = call + slash + 1;
+    int afterLen = len - slash - 1;
+    uint32_t full;
+    if (afterLen == 1 && (isDigit(upper(after[0])) || isLetter(upper(after[0])))) {
+      if (!packCall(call, slash, n)) return false;
+      full = 60000 + (uint32_t)charCode(upper(after[0]));
+    } else if (afterLen == 2 && isDigit(after[0]) && isDigit(after[1])) {
+      if (!packCall(call, slash, n)) return false;
+      full = 60000 + 26 + (uint32_t)(10 * (after[0] - '0') + (after[1] - '0'));
+    } else if (slash >= 1 && slash <= 3) {
+      if (!packCall(after, afterLen, n)) return false;
+      full = 0;
+      for (int i = 0; i < 3; i++) {
+	int k = i - (3 - slash);
+	char c = k >= 0 ? upper(call[k]) : ' ';
+	if (c != ' ' && !isDigit(c) && !isLetter(c)) return false;
+	full = 37 * full + (uint32_t)charCode(c);
+      }
+    } else {
+      return false;
+    }
+
+    nadd = full >= 32768 ? 1 : 0;
+    ng = full - 32768u * (uint32_t)nadd;
+    return true;
+  }
+
+  // Bob Jenkins' lookup3 hashlittle(), byte at a time
+  static uint32_t rot(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+
+  static uint32_t hashLittle(const char* key, int len, uint32_t initval) {
+    const uint8_t* k = (const uint8_t*)key;
+    uint32_t a, b, c;
+    a = b = c = 0xdeadbeef + (uint32_t)len + initval;
+
+    while (len > 12) {
+      a += k[0] + ((uint32_t)k[1] << 8) + ((uint32_t)k[2] << 16) + ((uint32_t)k[3] << 24);
+      b += k[4] + ((uint32_t)k[5] << 8) + ((uint32_t)k[6] << 16) + ((uint32_t)k[7] << 24);
+      c += k[8] + ((uint32_t)k[9] << 8) + ((uint32_t)k[10] << 16) + ((uint32_t)k[11] << 24);
+      a -= c; a ^= rot(c, 4); c += b;
+      b -= a; b ^= rot(a, 6); a += c;
+      c -= b; c ^= rot(b, 8); b += a;
+      a -= c; a ^= rot(c, 16); c += b;
+      b -= a; b ^= rot(a, 19); a += c;
+      c -= b; c ^= rot(b, 4); b += a;
+      len -= 12;
+      k += 12;
+    }
+
+    switch (len) {
+    case 12: c += (uint32_t)k[11] << 24; [[fallthrough]];
+    case 11: c += (uint32_t)k[10] << 16; [[fallthrough]];
+    case 10: c += (uint32_t)k[9] << 8; [[fallthrough]];
+    case 9:  c += k[8]; [[fallthrough]];
+    case 8:  b += (uint32_t)k[7] << 24; [[fallthrough]];
+    case 7:  b += (uint32_t)k[6] << 16; [[fallthrough]];
+    case 6:  b += (uint32_t)k[5] << 8; [[fallthrough]];
+    case 5:  b += k[4]; [[fallthrough]];
+    case 4:  a += (uint32_t)k[3] << 24; [[fallthrough]];
+    case 3:  a += (uint32_t)k[2] << 16; [[fallthrough]];
+    case 2:  a += (uint32_t)k[1] << 8; [[fallthrough]];
+    case 1:  a += k[0]; break;
+    case 0:  return c;
+    }
+
+    c ^= b; c -= rot(b, 14);
+    a ^= c; a -= rot(c, 11);
+    b ^= a; b -= rot(a, 25);
+    c ^= b; c -= rot(b, 16);
+    a ^= c; a -= rot(c, 4);
+    b ^= a; b -= rot(a, 14);
+    c ^= b; c -= rot(b, 24);
+    return c;
+  }
+
+  uint16_t WsprEncoder::callHash(const char* callsign) {
+    char call[16];
+    int len = 0;
+    while (callsign[len] && len < (int)sizeof(call) - 1) {
+      call[len] = upper(callsign[len]);
+      len++;
+    }
+    return (uint16_t)(hashLittle(call, len, 146) & 32767);
+  }
+
+  int WsprEncoder::legalPower(int dBm) {
+    if (dBm < 0) return 0;
+    if (dBm > 60) return 60;
+    static const int steps[] = { 0, 3, 7, 10 };
+    int base = dBm / 10 * 10, unit = dBm % 10;
+    int best = 0;
+    for (int s : steps) {
+      if (abs(unit - s) < abs(unit - best)) best = s;
+    }
+    return base + best > 60 ? 60 : base + best;
+  }
+
+  bool WsprEncoder::encode(BandPlanner::Message type, const char* callsign, const char* grid,
+			   int powerDbm, uint8_t symbols[symbolCount]) {
+    if (!callsign) return false;
+    int power = legalPower(powerDbm);
+    uint32_t n, ng;
+
+    switch (type) {
+    case BandPlanner::Message::Type1:
+      if (!packCall(callsign, length(callsign), n)) return false;
+      if (!grid || length(grid) < 4 || !packGrid(grid, ng)) return false;
+      ng = ng * 128 + (uint32_t)power + 64;
+      break;
+
+    case BandPlanner::Message::Type2: {
+      int nadd;
+      if (!packCompound(callsign, n, ng, nadd)) return false;
+      ng = ng * 128 + (uint32_t)(power + 1 + nadd) + 64;
+      break;
+    }
+
+    case BandPlanner::Message::Type3: {
+      // The locator rotated left by one ("IO91NP" as "O91NPI") packs as
+      // a callsign
+      if (!grid || length(grid) != 6) return false;
+      char rotated[6];
+      for (int i = 0; i < 6; i++) rotated[i] = grid[(i + 1) % 6];
+      char g0 = upper(grid[0]), g1 = upper(grid[1]), s0 = upper(grid[4]), s1 = upper(grid[5]);
+      if (g0 < 'A' || g0 > 'R' || g1 < 'A' || g1 > 'R' || s0 < 'A' || s0 > 'X' || s1 < 'A' || s1 > 'X') {
+	return false;
+      }
+      if (!packCall(rotated, 6, n)) return false;
+      ng = (uint32_t)callHash(callsign) * 128 - (uint32_t)(power + 1) + 64;
+      break;
+    }
+
+    default:
+      return false;
+    }
+
+    // 28 + 22 source bits, MSB first
+    uint8_t data[11] = {};
+    data[0] = (uint8_t)(n >> 20);
+    data[1] = (uint8_t)(n >> 12);
+    data[2] = (uint8_t)(n >> 4);
+    data[3] = (uint8_t)(((n & 0x0f) << 4) | ((ng >> 18) & 0x0f));
+    data[4] = (uint8_t)(ng >> 10);
+    data[5] = (uint8_t)(ng >> 2);
+    data[6] = (uint8_t)((ng & 0x03) << 6);
+
+    // Rate 1/2 code over the 50 bits and a 31-bit zero tail
+    uint8_t coded[symbolCount];
+    uint32_t reg = 0;
+    int out = 0;
+    for (int i = 0; i < 81; i++) {
+      reg = (reg << 1) | ((data[i / 8] >> (7 - i % 8)) & 1);
+      coded[out++] = (uint8_t)(__builtin_parity(reg & poly1));
+      coded[out++] = (uint8_t)(__builtin_parity(reg & poly2));
+    }
+
+    // Bit-reversed address interleaving
+    int p = 0;
+    for (int i = 0; p < symbolCount; i++) {
+      uint8_t j = (uint8_t)i;
+      j = (uint8_t)(((j & 0xf0) >> 4) | ((j & 0x0f) << 4));
+      j = (uint8_t)(((j & 0xcc) >> 2) | ((j & 0x33) << 2));
+      j = (uint8_t)(((j & 0xaa) >> 1) | ((j & 0x55) << 1));
+      if (j < symbolCount) symbols[j] = (uint8_t)(syncVector[j] + 2 * coded[p++]);
+    }
+    return true;
+  }
+
+} // namespace wspr
@@ -0,0 +1,40 @@
+/*
+ * WSPR Encoder for WSPR-ease
+ * Packs a WSPR-2 message, convolutionally codes and interleaves it and
+ * merges the sync vector into the 162 four-level channel symbols.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "bandPlanner.hpp"
+
+namespace wspr {
+
+  class WsprEncoder {
+  public:
+    static const int symbolCount = 162;
+    static const int toneCount = 4;
+
+    // 12000/8192 Hz apart, each symbol 8192/12000 s long
+    static constexpr double toneSpacingHz = 12000.0 / 8192.0;
+    static constexpr double symbolSec = 8192.0 / 12000.0;
+
+    // Reported powers end in 0, 3 or 7; others round to the nearest
+    static int legalPower(int dBm);
+
+    // Type 1: plain callsign, 4-character locator, power.
+    // Type 2: callsign with a prefix (up to 3 characters) or a suffix
+    // (one character or two digits) and power; no locator.
+    // Type 3: hash of the callsign, 6-character locator, power.
+    // Returns false when the callsign or locator cannot be sent as that
+    // type.
+    static bool encode(BandPlanner::Message type, const char* callsign, const char* grid,
+		       int powerDbm, uint8_t symbols[symbolCount]);
+
+    // 15-bit callsign hash that type 3 messages carry
+    static uint16_t callHash(const char* callsign);
+  };
+
+} // namespace wspr
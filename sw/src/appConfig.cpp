@@ -0,0 +1,203 @@
+/*
+ * Application Configuration Implementation for WSPR-ease
+ */
+
+#include "appConfig.hpp"
+
+#include <zephyr/kernel.h>
+
+#include "nvstore.hpp"
+#include "flashScheduler.hpp"
+#include "logmanager.hpp"
+
+namespace wspr {
+
+// Register subsystem with LogManager
+static Logger& logger = LogManager::instance().registerSubsystem("config",
+    {"init", "save"});
+
+// Retry interval after a failed write
+#define CONFIG_RETRY_MS 10000
+// How often a publish retries while every spare snapshot is held
+#define CONFIG_PUBLISH_POLL_MS 1
+
+ConfigStore& ConfigStore::instance() {
+    static ConfigStore inst;
+    return inst;
+}
+
+ConfigStore::ConfigStore() {
+    k_mutex_init(&mutex);
+    k_work_init_delayable(&saveWork, saveWorkFn);
+    snapshots.publish(AppConfig());
+}
+
+// Caller holds the mutex
+void ConfigStore::publish(const AppConfig& c) {
+    bool warned = false;
+    while (!snapshots.publish(c)) {
+        if (!warned) {
+            logger.wrn("save", "All configuration snapshots in use, waiting for a reader");
+            warned = true;
+        }
+        k_msleep(CONFIG_PUBLISH_POLL_MS);
+    }
+}
+
+// Storage ID of a ConfigSchema record key
+static NVStore::Id recordId(uint16_t key) {
+    if (key == ConfigSchema::versionKey) return NVStore::ConfigVersion;
+    if (key == ConfigSchema::legacyKey) return NVStore::AppConfigV0;
+    return (NVStore::Id)(NVStore::ConfigFields + key);
+}
+
+static int readRecord(uint16_t key, void* buf, size_t len, void* ctx) {
+    ARG_UNUSED(ctx);
+    return (int)NVStore::instance().read(recordId(key), buf, len);
+}
+
+int ConfigStore::load() {
+    auto& nvs = NVStore::instance();
+
+    logger.inf("init", "Loading configuration from NVS...");
+
+    int ret = nvs.mount();
+    if (ret != 0) return ret;
+
+    AppConfig loaded;
+    ConfigSchema::LoadInfo info;
+    ConfigSchema::load(readRecord, nullptr, loaded, info);
+
+    k_mutex_lock(&mutex, K_FOREVER);
+    publish(loaded);
+    stored = loaded;
+    k_mutex_unlock(&mutex);
+
+    if (info.storedVersion > ConfigSchema::version) {
+        logger.wrn("init", "Configuration schema %u is newer than %u, kept %d known fields",
+                info.storedVersion, ConfigSchema::version, info.fieldsRead);
+        return 0;
+    }
+    if (info.storedVersion == ConfigSchema::version) {
+        logger.inf("init", "Configuration loaded from flash (%d fields): Callsign=%s Grid=%s",
+                info.fieldsRead, loaded.callsign, loaded.gridSquare);
+        return 0;
+    }
+
+    // Older or no records. This runs at boot, before any transmission,
+    // so the scheduler writes through at once.
+    auto& sched = FlashScheduler::instance();
+    if (info.migrated) {
+        logger.inf("init", "Migrating configuration from schema %u: Callsign=%s Grid=%s",
+                info.storedVersion, loaded.callsign, loaded.gridSquare);
+        uint8_t buf[ConfigSchema::maxRecord];
+        for (const auto& f : ConfigSchema::fields) {
+            size_t n = ConfigSchema::encode(f, loaded, buf);
+            int rc = sched.writeRecord(recordId(f.key), buf, n);
+            if (rc < 0) {
+                // The old records stay, so the next boot tries again
+                logger.err("init", "Failed to write field %s: %d", f.name, rc);
+                return 0;
+            }
+        }
+    } else {
+        logger.inf("init", "No configuration found in flash, using defaults");
+    }
+
+    // The version record goes last: until it is written the old layout
+    // is still the one that counts
+    uint16_t v = ConfigSchema::version;
+    int rc = sched.writeRecord(NVStore::ConfigVersion, &v, sizeof(v));
+    if (rc < 0) {
+        logger.err("init", "Failed to write configuration schema version: %d", rc);
+    } else if (info.migrated && info.storedVersion == 0) {
+        nvs.remove(NVStore::AppConfigV0);
+    }
+    return 0;
+}
+
+void ConfigStore::update(const AppConfig& c) {
+    k_mutex_lock(&mutex, K_FOREVER);
+    publish(c);
+    int64_t now = k_uptime_get();
+    if (!unsaved) firstUnsavedMs = now;
+    unsaved = true;
+
+    // Each change pushes the write back, up to maxDelayMs in all
+    int64_t delay = firstUnsavedMs + maxDelayMs - now;
+    if (delay > debounceMs) delay = debounceMs;
+    if (delay < 0) delay = 0;
+    k_work_reschedule(&saveWork, K_MSEC(delay));
+    k_mutex_unlock(&mutex);
+}
+
+int ConfigStore::flush() {
+    // Waits out a save already running, which may still be writing
+    // fields after it has cleared unsaved
+    struct k_work_sync sync;
+    k_work_cancel_delayable_sync(&saveWork, &sync);
+    return save();
+}
+
+// Write the fields that changed since the last save
+int ConfigStore::save() {
+    k_mutex_lock(&mutex, K_FOREVER);
+    if (!unsaved) {
+        k_mutex_unlock(&mutex);
+        return 0;
+    }
+    AppConfig c = *current();
+    AppConfig prev = stored;
+    unsaved = false;
+    k_mutex_unlock(&mutex);
+
+    auto& sched = FlashScheduler::instance();
+    uint8_t buf[ConfigSchema::maxRecord];
+    int rc = 0, written = 0;
+    bool deferred = false;
+    for (const auto& f : ConfigSchema::fields) {
+        if (!ConfigSchema::differs(f, c, prev)) continue;
+
+        size_t n = ConfigSchema::encode(f, c, buf);
+        rc = sched.writeRecord(recordId(f.key), buf, n);
+        if (rc < 0) {
+            logger.err("save", "Failed to save field %s to NVS: %d", f.name, rc);
+            break;
+        }
+        if (rc == FlashScheduler::queued) deferred = true;
+        written++;
+
+        k_mutex_lock(&mutex, K_FOREVER);
+        ConfigSchema::copy(f, c, stored);
+        k_mutex_unlock(&mutex);
+    }
+
+    if (rc < 0) {
+        // Unless a newer change is already on its way, try again later;
+        // the fields already written are not written again
+        k_mutex_lock(&mutex, K_FOREVER);
+        if (!unsaved) {
+            unsaved = true;
+            firstUnsavedMs = k_uptime_get();
+            k_work_reschedule(&saveWork, K_MSEC(CONFIG_RETRY_MS));
+        }
+        k_mutex_unlock(&mutex);
+        return rc;
+    }
+
+    if (written == 0) {
+        logger.dbg("save", "Configuration unchanged, nothing written");
+    } else if (deferred) {
+        logger.inf("save", "Configuration save of %d fields deferred until after TX", written);
+    } else {
+        logger.inf("save", "Configuration saved to flash (%d fields)", written);
+    }
+    return 0;
+}
+
+void ConfigStore::saveWorkFn(struct k_work* work) {
+    ARG_UNUSED(work);
+    instance().save();
+}
+
+} // namespace wspr
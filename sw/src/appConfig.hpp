@@ -0,0 +1,69 @@
+/*
+ * Application Configuration for WSPR-ease
+ * The user settings, published as immutable snapshots that readers
+ * share without locking, and written to NVS behind a debounce, one
+ * record per changed field
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <zephyr/kernel.h>
+
+#include "configSchema.hpp"
+#include "snapshotPool.hpp"
+
+namespace wspr {
+
+class ConfigStore {
+public:
+    static ConfigStore& instance();
+
+    // Saved this long after the last change, and never more than
+    // maxDelayMs after the first unsaved one
+    static const int debounceMs = 2000;
+    static const int maxDelayMs = 10000;
+
+    // Read the stored configuration (defaults if there is none),
+    // converting records left by older firmware
+    int load();
+
+    // Consistent, read-only view of the configuration. Hold it for as
+    // long as the settings must not change under you (the main loop
+    // keeps one from one slot boundary to the next and the slot planner
+    // plans and encodes from it, so an edit applies from the next
+    // boundary); every holder pins one of the pool slots.
+    typedef SnapshotPool<AppConfig, 6>::Ref Snapshot;
+    Snapshot current() const { return snapshots.acquire(); }
+
+    // Copy of the current configuration, to edit and pass to update()
+    AppConfig get() const { return *current(); }
+
+    // Publishes a new snapshot at once; the flash write follows in the
+    // background
+    void update(const AppConfig& cfg);
+
+    // Write an unsaved change now (before a reboot or shutdown). Not
+    // from the system workqueue: it waits for a save in progress there.
+    int flush();
+    bool dirty() const { return unsaved; }
+
+private:
+    ConfigStore();
+
+    void publish(const AppConfig& cfg);
+    int save();
+    static void saveWorkFn(struct k_work* work);
+
+    SnapshotPool<AppConfig, 6> snapshots;
+    AppConfig stored;	// As written to flash, to find the changed fields
+    bool unsaved = false;
+    int64_t firstUnsavedMs = 0;
+
+    // Serializes publishing and guards the save state; readers of the
+    // snapshots never take it
+    mutable struct k_mutex mutex;
+    struct k_work_delayable saveWork;
+};
+
+} // namespace wspr
@@ -0,0 +1,43 @@
+/*
+ * Flash Scheduler Storage Backend for WSPR-ease
+ * NVStore records and LittleFS files, as run by FlashScheduler
+ */
+
+#include "flashScheduler.hpp"
+#include "nvstore.hpp"
+
+#include <zephyr/fs/fs.h>
+
+namespace wspr {
+
+static int writeRecord(uint16_t id, const void* data, size_t len) {
+    ssize_t rc = NVStore::instance().write((NVStore::Id)id, data, len);
+    return rc < 0 ? (int)rc : 0;
+}
+
+static int writeFile(const char* path, const void* data, size_t len) {
+    struct fs_file_t file;
+    fs_file_t_init(&file);
+
+    int ret = fs_open(&file, path, FS_O_CREATE | FS_O_WRITE);
+    if (ret < 0) return ret;
+
+    ssize_t n = fs_write(&file, data, len);
+    // Drop the tail of a longer file it replaces
+    if (n == (ssize_t)len) ret = fs_truncate(&file, len);
+    else ret = n < 0 ? (int)n : -EIO;
+    fs_close(&file);
+    return ret;
+}
+
+static int deleteFile(const char* path) {
+    return fs_unlink(path);
+}
+
+const FlashScheduler::Backend storageBackend = {
+    writeRecord,
+    writeFile,
+    deleteFile,
+};
+
+} // namespace wspr
@@ -0,0 +1,219 @@
+/*
+ * Flash Write Scheduler Implementation for WSPR-ease
+ */
+
+#include "flashScheduler.hpp"
+
+#include <zephyr/kernel.h>
+#include <cstring>
+#include <errno.h>
+
+#include "logmanager.hpp"
+
+namespace wspr {
+
+// Register subsystem with LogManager
+static Logger& logger = LogManager::instance().registerSubsystem("flash",
+    {"init", "ops"});
+
+#define FLASH_STACK_SIZE 2048
+static K_THREAD_STACK_DEFINE(flashStack, FLASH_STACK_SIZE);
+
+FlashScheduler& FlashScheduler::instance() {
+    static FlashScheduler inst;
+    return inst;
+}
+
+int FlashScheduler::init(const Backend* backend) {
+    if (running) return 0;
+
+    ops = backend;
+    k_mutex_init(&lock);
+    k_sem_init(&wake, 0, 1);
+
+    running = true;
+    k_thread_create(&threadData, flashStack, K_THREAD_STACK_SIZEOF(flashStack),
+                    threadFn, this, NULL, NULL,
+                    K_PRIO_PREEMPT(14), 0, K_NO_WAIT);
+    k_thread_name_set(&threadData, "flashWriter");
+    return 0;
+}
+
+int FlashScheduler::writeRecord(uint16_t id, const void* data, size_t len, Urgency u) {
+    Job job = {};
+    job.kind = Job::Record;
+    job.id = id;
+    job.len = len;
+    return submit(job, data, u);
+}
+
+int FlashScheduler::writeFile(const char* path, const void* data, size_t len, Urgency u) {
+    if (strlen(path) >= maxPath) return -ENAMETOOLONG;
+    Job job = {};
+    job.kind = Job::File;
+    strcpy(job.path, path);
+    job.len = len;
+    return submit(job, data, u);
+}
+
+int FlashScheduler::deleteFile(const char* path, Urgency u) {
+    if (strlen(path) >= maxPath) return -ENAMETOOLONG;
+    Job job = {};
+    job.kind = Job::Delete;
+    strcpy(job.path, path);
+    return submit(job, nullptr, u);
+}
+
+// Same record, or same path: a write or delete replaces whatever was
+// queued for that file
+bool FlashScheduler::sameTarget(const Job& a, const Job& b) {
+    bool recA = a.kind == Job::Record, recB = b.kind == Job::Record;
+    if (recA != recB) return false;
+    return recA ? a.id == b.id : strcmp(a.path, b.path) == 0;
+}
+
+// Forget a queued job superseded by this one. Caller holds lock.
+void FlashScheduler::drop(const Job& job) {
+    for (int i = 0; i < maxJobs; i++) {
+        Job& q = jobs[i];
+        if (q.kind != Job::None && sameTarget(q, job)) {
+            k_free(q.data);
+            q = {};
+        }
+    }
+}
+
+int FlashScheduler::submit(Job& job, const void* data, Urgency u) {
+    if (!ops) return -ENODEV;
+
+    k_mutex_lock(&lock, K_FOREVER);
+
+    if (!window || u == Urgency::Immediate) {
+        if (window) counts.overrides++;
+        drop(job);
+        job.data = (uint8_t*)data;	// Only read by the backend
+        int ret = run(job);
+        k_mutex_unlock(&lock);
+        return ret;
+    }
+
+    Job* slot = nullptr;
+    for (int i = 0; i < maxJobs && !slot; i++) {
+        Job& q = jobs[i];
+        if (q.kind != Job::None && sameTarget(q, job)) slot = &q;
+    }
+    for (int i = 0; i < maxJobs && !slot; i++) {
+        if (jobs[i].kind == Job::None) slot = &jobs[i];
+    }
+    if (!slot) {
+        k_mutex_unlock(&lock);
+        logger.err("ops", "Flash queue full, write refused during TX");
+        return -ENOSPC;
+    }
+
+    job.data = nullptr;
+    if (job.len) {
+        job.data = (uint8_t*)k_malloc(job.len);
+        if (!job.data) {
+            k_mutex_unlock(&lock);
+            return -ENOMEM;
+        }
+        memcpy(job.data, data, job.len);
+    }
+
+    k_free(slot->data);
+    *slot = job;
+    counts.deferred++;
+    k_mutex_unlock(&lock);
+
+    logger.dbg("ops", "Flash write deferred until after TX");
+    return queued;
+}
+
+// Caller holds lock
+int FlashScheduler::run(const Job& job) {
+    int ret = 0;
+    switch (job.kind) {
+    case Job::Record: ret = ops->writeRecord(job.id, job.data, job.len); break;
+    case Job::File: ret = ops->writeFile(job.path, job.data, job.len); break;
+    case Job::Delete: ret = ops->deleteFile(job.path); break;
+    default: break;
+    }
+
+    if (ret < 0) {
+        counts.failed++;
+        if (job.kind == Job::Record) logger.err("ops", "Write of record %u failed: %d", job.id, ret);
+        else logger.err("ops", "Write to %s failed: %d", job.path, ret);
+    } else {
+        counts.run++;
+    }
+    return ret;
+}
+
+// One job per hold of the lock, so a transmission waits for at most
+// one flash operation
+void FlashScheduler::drain(bool force) {
+    while (true) {
+        k_mutex_lock(&lock, K_FOREVER);
+        Job* job = nullptr;
+        if (!window || force) {
+            for (int i = 0; i < maxJobs && !job; i++) {
+                if (jobs[i].kind != Job::None) job = &jobs[i];
+            }
+        }
+        if (!job) {
+            k_mutex_unlock(&lock);
+            return;
+        }
+
+        run(*job);
+        k_free(job->data);
+        *job = {};
+        k_mutex_unlock(&lock);
+    }
+}
+
+void FlashScheduler::beginWindow() {
+    k_mutex_lock(&lock, K_FOREVER);
+    window = true;
+    k_mutex_unlock(&lock);
+}
+
+void FlashScheduler::endWindow() {
+    k_mutex_lock(&lock, K_FOREVER);
+    window = false;
+    k_mutex_unlock(&lock);
+    k_sem_give(&wake);
+}
+
+int FlashScheduler::flush() {
+    drain(true);
+    return pending() ? -EIO : 0;
+}
+
+int FlashScheduler::pending() const {
+    k_mutex_lock(&lock, K_FOREVER);
+    int n = 0;
+    for (int i = 0; i < maxJobs; i++) {
+        if (jobs[i].kind != Job::None) n++;
+    }
+    k_mutex_unlock(&lock);
+    return n;
+}
+
+void FlashScheduler::threadFn(void* p1, void* p2, void* p3) {
+    FlashScheduler* inst = static_cast<FlashScheduler*>(p1);
+    inst->processLoop();
+}
+
+void FlashScheduler::processLoop() {
+    logger.inf("init", "Flash writer thread started");
+    while (running) {
+        // Woken at the end of each window; the timeout catches a job
+        // queued just as a window closed
+        k_sem_take(&wake, K_SECONDS(1));
+        drain(false);
+    }
+}
+
+} // namespace wspr
@@ -0,0 +1,102 @@
+/*
+ * Flash Write Scheduler for WSPR-ease
+ * Keeps NVS and LittleFS writes out of transmissions: on the ESP32 a
+ * flash erase or program stalls the instruction cache, and with it
+ * the symbol timing.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <zephyr/kernel.h>
+
+namespace wspr {
+
+  class FlashScheduler {
+  public:
+    static FlashScheduler& instance();
+
+    // The flash operations themselves
+    struct Backend {
+      int (*writeRecord)(uint16_t id, const void* data, size_t len);
+      int (*writeFile)(const char* path, const void* data, size_t len);
+      int (*deleteFile)(const char* path);
+    };
+
+    // Deferred operations wait for the end of a TX window; Immediate
+    // ones run at once, window or not
+    enum class Urgency : uint8_t { Deferred, Immediate };
+
+    // Returned when an operation was queued rather than run
+    static const int queued = 1;
+
+    struct Stats {
+      uint32_t run;		// Operations completed
+      uint32_t deferred;	// Queued behind a TX window
+      uint32_t overrides;	// Immediate operations run inside a window
+      uint32_t failed;
+    };
+
+    int init(const Backend* backend);
+
+    // Outside a TX window these run in the caller and return the
+    // backend's result. Inside one a Deferred operation is copied,
+    // queued (replacing any queued one for the same record or path)
+    // and `queued` is returned.
+    int writeRecord(uint16_t id, const void* data, size_t len, Urgency u = Urgency::Deferred);
+    int writeFile(const char* path, const void* data, size_t len, Urgency u = Urgency::Deferred);
+    int deleteFile(const char* path, Urgency u = Urgency::Deferred);
+
+    // Bracket a transmission. beginWindow() waits for an operation in
+    // progress, then holds off every Deferred one until endWindow().
+    void beginWindow();
+    void endWindow();
+    bool inWindow() const { return window; }
+
+    // Run everything queued now, window or not (before a reboot)
+    int flush();
+
+    int pending() const;
+    Stats stats() const { return counts; }
+
+  private:
+    FlashScheduler() = default;
+
+    static const int maxJobs = 8;
+    static const size_t maxPath = 64;
+
+    struct Job {
+      enum Kind : uint8_t { None, Record, File, Delete };
+      Kind kind;
+      uint16_t id;
+      char path[maxPath];
+      uint8_t* data;
+      size_t len;
+    };
+
+    static bool sameTarget(const Job& a, const Job& b);
+    int submit(Job& job, const void* data, Urgency u);
+    int run(const Job& job);
+    void drop(const Job& job);
+    void drain(bool force);
+    void processLoop();
+    static void threadFn(void* p1, void* p2, void* p3);
+
+    const Backend* ops = nullptr;
+    Job jobs[maxJobs] = {};
+    Stats counts = {};
+    volatile bool window = false;
+
+    // Held for the length of every flash operation, and while jobs[] or
+    // the window flag change
+    mutable struct k_mutex lock;
+    struct k_sem wake;
+    struct k_thread threadData;
+    bool running = false;
+  };
+
+  // NVStore records and LittleFS files (flashBackend.cpp)
+  extern const FlashScheduler::Backend storageBackend;
+
+} // namespace wspr
@@ -10,7 +10,9 @@ namespace WSPRRegs {
 #include "regs.hpp"
 };
 
+#include "bandPlanner.hpp"
 #include "filesystem.hpp"
+#include "flashScheduler.hpp"
 #include "logmanager.hpp"
 
 #include <zephyr/kernel.h>
@@ -41,10 +43,32 @@ namespace wspr {
   static const struct gpio_dt_spec pgFPGACORE = GPIO_DT_SPEC_GET(DT_NODELABEL(pg_fpgacore), gpios);
   static const struct gpio_dt_spec enFPGAIO = GPIO_DT_SPEC_GET(DT_NODELABEL(en_fpgaio), gpios);
 
+  // Filter bank RF switches
+  static const struct gpio_dt_spec lpfHigh = GPIO_DT_SPEC_GET(DT_NODELABEL(lpf_high), gpios);
+  static const struct gpio_dt_spec lpfLowMaster = GPIO_DT_SPEC_GET(DT_NODELABEL(lpf_low_master), gpios);
+  static const struct gpio_dt_spec lpfLow1 = GPIO_DT_SPEC_GET(DT_NODELABEL(lpf_low1), gpios);
+  static const struct gpio_dt_spec lpfLow2 = GPIO_DT_SPEC_GET(DT_NODELABEL(lpf_low2), gpios);
+
   // iCE40 Slave SPI: Mode 0 (CPOL=0, CPHA=0), MSB First.
   static const struct spi_dt_spec fpgaSPI = SPI_DT_SPEC_GET(DT_NODELABEL(fpga_dev),
 							    SPI_OP_MODE_MASTER | SPI_WORD_SET(8) | SPI_TRANSFER_MSB);
 
+  // Register access runs at the devicetree rate until CRC-protected
+  // writes are enabled, then at regSpiCrcHz.
+  static struct spi_dt_spec regSPI = fpgaSPI;
+
+  // CRC-8 (x^8+x^2+x+1, init 0) as checked by SPIRegisters.sv
+  static uint8_t crc8(const uint8_t* data, size_t len) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+      crc ^= data[i];
+      for (int b = 0; b < 8; b++) {
+	crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+      }
+    }
+    return crc;
+  }
+
   FPGA& FPGA::instance() {
     static FPGA inst;
     return inst;
@@ -58,7 +82,8 @@ namespace wspr {
 	!device_is_ready(fpgaDONE.port) ||
         !device_is_ready(fpgaNCS.port) ||
 	!device_is_ready(pgFPGACORE.port) ||
-        !device_is_ready(enFPGAIO.port))
+        !device_is_ready(enFPGAIO.port) ||
+	!device_is_ready(lpfHigh.port))
     {
       logger.err("FPGA GPIO devices not ready");
       return -ENODEV;
@@ -80,6 +105,13 @@ namespace wspr {
     gpio_pin_configure_dt(&pgFPGACORE, GPIO_INPUT);
     gpio_pin_configure_dt(&fpgaDONE, GPIO_INPUT | GPIO_PULL_UP);
 
+    // Every filter path open until a band is selected
+    gpio_pin_configure_dt(&lpfHigh, GPIO_OUTPUT_LOW);
+    gpio_pin_configure_dt(&lpfLowMaster, GPIO_OUTPUT_LOW);
+    gpio_pin_configure_dt(&lpfLow1, GPIO_OUTPUT_LOW);
+    gpio_pin_configure_dt(&lpfLow2, GPIO_OUTPUT_LOW);
+    setLPFBand(currentBand);
+
     logger.inf("enFPGAIO deasserted. Waiting for FPGA Core power good (pgFPGACORE)...");
 
     // Power Sequencing: Wait for Core Power Good
@@ -117,10 +149,25 @@ namespace wspr {
 
     initialized = true;
     logger.inf("FPGA initialized and running");
+
+    if (setCrcRequired(true) < 0) {
+      logger.wrn("spi", "FPGA does not support CRC-protected writes");
+    }
     return 0;
   }
 
   int FPGA::reset() {
+    // A fresh configuration starts with CRC checking off
+    crcChecked = false;
+    crcErrorCount = 0;
+    crcErrorTotal = 0;
+    regSPI.config.frequency = fpgaSPI.config.frequency;
+    waveTableSel = 0;
+    stepsPerCycle = BandTable::defaultSteps;
+    ditherOn = false;
+    ditherBits = 0;
+    eventsSeen = 0;
+
     gpio_pin_set_dt(&fpgaNRESET, 0);	// Assert software reset
     gpio_pin_set_dt(&fpgaNCS, 0);	// SPI slave mode indicator
     gpio_pin_set_dt(&fpgaCRESET, 0);	// Assert FPGA config reset
@@ -225,28 +272,159 @@ namespace wspr {
     return ret;
   }
 
+  uint32_t FPGA::tuningWordForHz(uint32_t freqHz) const {
+    // NCO tuning for the 180 MHz SDR exciter clock.
+    // Each NCO overflow advances the waveform table by one step, so
+    // f_nco = steps * freqHz and M = (steps * freqHz / 180,000,000) * 2^32.
+    // With the default 6 steps this is (freqHz / 30,000,000) * 2^32.
+
+    // Using 64-bit math to avoid overflow before division
+    return (uint32_t)(((uint64_t)freqHz * stepsPerCycle << 32) / exciterClkHz);
+  }
+
+  uint8_t FPGA::ditherWidthFor(uint32_t word) {
+    // Largest power of two below both M and 2^32 - M, less a margin
+    // for the FreqCorr scaling applied after this word leaves us
+    uint32_t room = word < 0x80000000u ? word : (uint32_t)(0u - word);
+    room -= room >> 8;
+    return room ? 31 - __builtin_clz(room) : 0;
+  }
+
+  int FPGA::writeDither(uint8_t width) {
+    WSPRRegs::WSPRDither reg;
+    reg.u = 0;
+    reg.enable = ditherOn ? 1 : 0;
+    reg.width = width;
+    ditherBits = width;
+    return spiWriteReg(WSPRRegs::aWSPRDither, reg.u);
+  }
+
+  // Write a tuning word that may move anywhere between word and
+  // endWord (a sweep), shrinking the dither span first or growing it
+  // afterwards so it never exceeds what the NCO can absorb.
+  int FPGA::writeTuning(uint32_t word, uint32_t endWord) {
+    uint8_t a = ditherWidthFor(word), b = ditherWidthFor(endWord);
+    uint8_t width = a < b ? a : b;
+    int ret = 0;
+    if (ditherOn && width < ditherBits) ret = writeDither(width);
+    if (ret == 0) ret = spiWriteReg(WSPRRegs::aWSPRTuning, word);
+    if (ret == 0 && ditherOn && width > ditherBits) ret = writeDither(width);
+    return ret;
+  }
+
   int FPGA::setFrequency(uint32_t freqHz) {
     currentFreq = freqHz;
     if (!initialized) return -ENODEV;
+    if (freqHz >= maxFrequency()) return -ERANGE;
+    uint32_t word = tuningWordForHz(freqHz);
+    return writeTuning(word, word);
+  }
 
-    // NCO tuning for 90 MHz system clock and 180 Msps effective sample rate.
-    // One full RF cycle corresponds to 6 state transitions (NCO overflows).
-    // The NCO frequency f_nco = 6 * freqHz.
-    // The tuning word per 180 Msps sample is M = (f_nco / 180,000,000) * 2^32.
-    // M = (6 * freqHz / 180,000,000) * 2^32 = (freqHz / 30,000,000) * 2^32.
-    // In each 90 MHz clock cycle (2 samples), the FPGA takes two steps of size M.
+  int FPGA::setDither(bool enable) {
+    if (!initialized) return -ENODEV;
+    ditherOn = enable;
+    logger.inf("config", "NCO phase dither %s", enable ? "on" : "off");
+    return writeDither(enable ? ditherWidthFor(tuningWordForHz(currentFreq)) : 0);
+  }
 
-    // Using 64-bit math to avoid overflow before division
-    const uint64_t f_limit = 30000000ULL;
-    uint64_t word = ((uint64_t)freqHz << 32) / f_limit;
+  int FPGA::setFrequencyCorrection(double errorPpm) {
+    if (!initialized) return -ENODEV;
+
+    // A reference running fast by e scales every output frequency by
+    // (1 + e), so the tuning word must be multiplied by 1 / (1 + e).
+    // The register holds that factor minus one in units of 2^-32.
+    double e = errorPpm * 1.0e-6;
+    double corr = (1.0 / (1.0 + e) - 1.0) * 4294967296.0;
+    if (corr >= 8388607.5 || corr < -8388608.5) return -ERANGE;
+
+    WSPRRegs::WSPRFreqCorr reg;
+    reg.u = 0;
+    reg.corr = (int32_t)(corr < 0 ? corr - 0.5 : corr + 0.5);
+
+    logger.inf("config", "Reference correction %.4f ppm (reg %d)", errorPpm, (int)reg.corr);
+    refErrorPpm = errorPpm;
+    return spiWriteReg(WSPRRegs::aWSPRFreqCorr, reg.u);
+  }
+
+  int FPGA::startSweep(uint32_t startHz, uint32_t stopHz, uint32_t durationMs, bool loop) {
+    if (!initialized) return -ENODEV;
+    if (durationMs == 0 || startHz == stopHz) return -EINVAL;
+    if (startHz >= maxFrequency() || stopHz >= maxFrequency()) return -ERANGE;
+
+    // The FPGA adds a signed Q16.16 step to the tuning word every
+    // `interval` clk90 cycles. Use the shortest interval that still
+    // gives at least one whole tuning LSB per step so the sweep is as
+    // smooth as possible without losing slope precision.
+    int64_t span = (int64_t)tuningWordForHz(stopHz) - (int64_t)tuningWordForHz(startHz);
+    uint64_t cycles = (uint64_t)durationMs * (fpgaClkHz / 1000);
+    uint32_t interval = 8;
+    int64_t step;
+
+    for (;;) {
+      uint64_t nSteps = cycles / interval;
+      if (nSteps == 0) return -EINVAL;
+      step = (span * 65536) / (int64_t)nSteps;
+      if (llabs(step) >= 65536 || interval >= (1u << 23)) break;
+      interval <<= 1;
+    }
+
+    if (step == 0 || llabs(step) > INT32_MAX) {
+      logger.err("config", "Sweep %u to %u Hz in %u ms out of range", startHz, stopHz, durationMs);
+      return -ERANGE;
+    }
 
-    return spiWriteReg(WSPRRegs::aWSPRTuning, (uint32_t)word);
+    logger.inf("config", "Sweep %u to %u Hz over %u ms (step %lld/65536 every %u clocks)%s",
+	       startHz, stopHz, durationMs, step, interval, loop ? " looping" : "");
+
+    // Stop any sweep in progress so the new start word is latched
+    WSPRRegs::WSPRControl ctrl;
+    spiReadReg(WSPRRegs::aWSPRControl, &ctrl.u);
+    ctrl.sweepEnable = 0;
+    spiWriteReg(WSPRRegs::aWSPRControl, ctrl.u);
+
+    WSPRRegs::WSPRSweepRate rate;
+    rate.u = 0;
+    rate.interval = interval;
+
+    currentFreq = startHz;
+    writeTuning(tuningWordForHz(startHz), tuningWordForHz(stopHz));
+    spiWriteReg(WSPRRegs::aWSPRSweepStop, tuningWordForHz(stopHz));
+    spiWriteReg(WSPRRegs::aWSPRSweepStep, (uint32_t)(int32_t)step);
+    spiWriteReg(WSPRRegs::aWSPRSweepRate, rate.u);
+
+    ctrl.sweepEnable = 1;
+    ctrl.sweepLoop = loop ? 1 : 0;
+    sweeping = true;
+    return spiWriteReg(WSPRRegs::aWSPRControl, ctrl.u);
+  }
+
+  int FPGA::stopSweep() {
+    if (!initialized) return -ENODEV;
+    if (!sweeping) return 0;
+    sweeping = false;
+
+    WSPRRegs::WSPRControl ctrl;
+    spiReadReg(WSPRRegs::aWSPRControl, &ctrl.u);
+    ctrl.sweepEnable = 0;
+    ctrl.sweepLoop = 0;
+    return spiWriteReg(WSPRRegs::aWSPRControl, ctrl.u);
   }
 
   int FPGA::startTX() {
     if (!initialized) return -ENODEV;
     if (transmitting) return -EALREADY;
     logger.inf("config", "Starting transmission at %u Hz", currentFreq);
+
+    // Normally selected ahead of the slot; this costs the settle time
+    uint8_t want = BandPlanner::lpfForHz(currentFreq);
+    if (want != lpfSel) {
+      logger.wrn("config", "LPF %u not preselected for %u Hz", want, currentFreq);
+      int ret = setLPF(want);
+      if (ret < 0) return ret;
+    }
+
+    // Waits for a flash write in progress; later ones queue until stopTX()
+    FlashScheduler::instance().beginWindow();
     transmitting = true;
 
     WSPRRegs::WSPRControl ctrl;
@@ -264,7 +442,9 @@ namespace wspr {
     WSPRRegs::WSPRControl ctrl;
     spiReadReg(WSPRRegs::aWSPRControl, &ctrl.u);
     ctrl.txEnable = 0;
-    return spiWriteReg(WSPRRegs::aWSPRControl, ctrl.u);
+    int ret = spiWriteReg(WSPRRegs::aWSPRControl, ctrl.u);
+    FlashScheduler::instance().endWindow();
+    return ret;
   }
 
   int FPGA::setPowerLevel(uint8_t level) {
@@ -280,18 +460,243 @@ namespace wspr {
   int FPGA::sendSymbol(uint8_t symbol) {
     if (!initialized) return -ENODEV;
 
-    // WSPR tone spacing is 1.46484375 Hz (12000 / 8192)
-    // All frequency shifts are now handled here.
-    double toneFreq = (double)currentFreq + (double)symbol * 1.46484375;
-    return setFrequency((uint32_t)toneFreq);
+    if (symbol >= Modulation::toneCount) return -EINVAL;
+    if (currentFreq >= maxFrequency()) return -ERANGE;
+
+    // Tones sit one symbol rate apart above the dial frequency, which
+    // stays put; the word keeps the fractional spacing
+    uint32_t word = Modulation::get(txMode).toneWord(currentFreq, symbol, stepsPerCycle, exciterClkHz);
+    return writeTuning(word, word);
+  }
+
+  int FPGA::setModulation(Modulation::Mode mode) {
+    if ((int)mode >= Modulation::modeCount) return -EINVAL;
+    if (transmitting && mode != txMode) return -EBUSY;
+    txMode = mode;
+    return 0;
+  }
+
+  int FPGA::sendSymbol(uint8_t symbol, const uint32_t* toneWords) {
+    if (!initialized) return -ENODEV;
+    if (symbol >= Modulation::toneCount || !toneWords) return -EINVAL;
+    return writeTuning(toneWords[symbol], toneWords[symbol]);
+  }
+
+  int FPGA::selectWaveform(uint8_t table, uint8_t steps) {
+    if (!initialized) return -ENODEV;
+    if (table > 3) return -EINVAL;
+
+    WSPRRegs::WSPRWaveSel sel;
+    sel.u = 0;
+    sel.table = table;
+    switch (steps) {
+    case 6:  sel.steps = WSPRRegs::eWSPRWaveSelStepsN6; break;
+    case 12: sel.steps = WSPRRegs::eWSPRWaveSelStepsN12; break;
+    case 24: sel.steps = WSPRRegs::eWSPRWaveSelStepsN24; break;
+    default: return -EINVAL;
+    }
+    if (currentFreq >= (uint32_t)(exciterClkHz / steps)) return -ERANGE;
+    // The sweep's step and stop words are scaled for the old step count
+    if (sweeping) return -EBUSY;
+
+    // Park the output while the step count and tuning word disagree
+    bool wasTransmitting = transmitting;
+    if (wasTransmitting) stopTX();
+
+    waveTableSel = table;
+    stepsPerCycle = steps;
+    int ret = spiWriteReg(WSPRRegs::aWSPRWaveSel, sel.u);
+    if (ret == 0 && currentFreq) ret = setFrequency(currentFreq);
+    if (ret == 0 && wasTransmitting) ret = startTX();
+    return ret;
+  }
+
+  int FPGA::loadWaveTable(uint8_t table, const int8_t* levels, size_t n) {
+    if (!initialized) return -ENODEV;
+    if (table > 3 || n == 0 || n > 32) return -EINVAL;
+
+    // Gate bits are {pullPeak, pullBase, pushPeak, pushBase}
+    for (size_t i = 0; i < n; i++) {
+      WSPRRegs::WSPRWaveTable entry;
+      entry.u = 0;
+      entry.table = table;
+      entry.step = i;
+      switch (levels[i]) {
+      case 2:  entry.gates = 0x3; break;
+      case 1:  entry.gates = 0x1; break;
+      case 0:  entry.gates = 0x0; break;
+      case -1: entry.gates = 0x4; break;
+      case -2: entry.gates = 0xC; break;
+      default: return -EINVAL;
+      }
+      int ret = spiWriteReg(WSPRRegs::aWSPRWaveTable, entry.u);
+      if (ret != 0) return ret;
+    }
+    return 0;
+  }
+
+  // Power-up table contents, reloadable after experiments
+  static const struct {
+    const char* name;
+    uint8_t table;
+    uint8_t steps;
+    int8_t levels[24];
+  } wavePresets[] = {
+    { "121", 0, 6, { 1, 2, 1, -1, -2, -1 } },
+    { "12step", 1, 12, { 1, 2, 2, 2, 2, 1, -1, -2, -2, -2, -2, -1 } },
+    { "24step", 2, 24, { 0, 1, 1, 2, 2, 2, 2, 2, 2, 1, 1, 0,
+			 0, -1, -1, -2, -2, -2, -2, -2, -2, -1, -1, 0 } },
+  };
+
+  int FPGA::loadWavePreset(const char* name) {
+    if (sweeping) return -EBUSY;
+    for (const auto& p : wavePresets) {
+      if (strcmp(p.name, name) != 0) continue;
+      int ret = loadWaveTable(p.table, p.levels, p.steps);
+      if (ret == 0) ret = selectWaveform(p.table, p.steps);
+      if (ret == 0) logger.inf("config", "Waveform %s (%u steps)", p.name, p.steps);
+      return ret;
+    }
+    return -ENOENT;
+  }
+
+  int FPGA::setLPF(uint8_t lpf) {
+    if (lpf >= lpfCount) return -EINVAL;
+    if (transmitting) return -EBUSY;
+    if (lpf == lpfSel) return 0;
+
+    // Break before make: the PA never sees two filters or a half-made
+    // path. The switches settle with RF off.
+    gpio_pin_set_dt(&lpfHigh, 0);
+    gpio_pin_set_dt(&lpfLowMaster, 0);
+    gpio_pin_set_dt(&lpfLow1, 0);
+    gpio_pin_set_dt(&lpfLow2, 0);
+    lpfSel = lpfNone;
+
+    if (lpf == 2) {
+      gpio_pin_set_dt(&lpfHigh, 1);
+    } else {
+      gpio_pin_set_dt(lpf == 0 ? &lpfLow1 : &lpfLow2, 1);
+      gpio_pin_set_dt(&lpfLowMaster, 1);
+    }
+    k_msleep(lpfSettleMs);
+
+    lpfSel = lpf;
+    logger.dbg("config", "LPF %u selected", lpf);
+    return 0;
+  }
+
+  static_assert(BandTable::get(BandTable::count - 1).dialHz < FPGA::lpfMaxHz, "every band has a filter");
+
+  int FPGA::setLPFBand(BandTable::Id band) {
+    int ret = setLPF(BandTable::get(band).lpf);
+    if (ret == 0) currentBand = band;
+    return ret;
+  }
+
+  int FPGA::setRFWindow(uint32_t seconds) {
+    if (!initialized) return -ENODEV;
+
+    WSPRRegs::WSPRRFGate gate;
+    gate.u = 0;
+    switch (seconds) {
+    case 1:   gate.window = WSPRRegs::eWSPRRFGateWindowSec1; break;
+    case 10:  gate.window = WSPRRegs::eWSPRRFGateWindowSec10; break;
+    case 100: gate.window = WSPRRegs::eWSPRRFGateWindowSec100; break;
+    default:  return -EINVAL;
+    }
+
+    rfWindowSec = seconds;
+    return spiWriteReg(WSPRRegs::aWSPRRFGate, gate.u);
   }
 
-  int FPGA::setLPFBand(WSPRBand band) {
-    logger.inf("config", "NOTE: FPGA setLPFBand not yet implemented");
-    currentBand = band;
+  int FPGA::getRFCount(uint32_t* cycles, uint8_t* gen) {
+    if (!initialized) return -ENODEV;
+
+    // Read the generation on both sides of the count so a window
+    // completing between the two reads is detected and retried.
+    for (int attempt = 0; attempt < 3; attempt++) {
+      WSPRRegs::WSPRRFGate before, after;
+      uint32_t count;
+      int ret = spiReadReg(WSPRRegs::aWSPRRFGate, &before.u);
+      if (ret == 0) ret = spiReadReg(WSPRRegs::aWSPRRFCount, &count);
+      if (ret == 0) ret = spiReadReg(WSPRRegs::aWSPRRFGate, &after.u);
+      if (ret < 0) return ret;
+
+      if (before.gen == after.gen) {
+	*cycles = count;
+	*gen = after.gen;
+	return 0;
+      }
+    }
+
+    return -EAGAIN;
+  }
+
+  int FPGA::getPPSStamp(uint32_t* halfClocks, uint8_t* gen) {
+    if (!initialized) return -ENODEV;
+
+    WSPRRegs::WSPRPPS val;
+    int ret = spiReadReg(WSPRRegs::aWSPRPPS, &val.u);
+    if (ret < 0) return ret;
+    *halfClocks = ((uint32_t)val.count << 1) | val.half;
+    *gen = val.gen;
     return 0;
   }
 
+  int FPGA::readEvents(TimeEvent* events, size_t maxEvents) {
+    if (!initialized) return -ENODEV;
+
+    // One burst returns the count followed by the whole ring, 8 bytes
+    // per entry, most significant first
+    static uint8_t rx[5 + eventRingSize * 8];
+    int ret = spiReadBurst(WSPRRegs::aWSPREventLog, rx, sizeof(rx));
+    if (ret < 0) return ret;
+
+    uint16_t count = ((uint16_t)rx[3] << 8) | rx[4];
+    uint16_t fresh = count - eventsSeen;
+    eventsSeen = count;
+
+    // The slot after the newest entry may already hold a newer event
+    // than count, so one slot fewer than the ring is trustworthy
+    bool lost = fresh > eventRingSize - 1;
+    if (lost) fresh = eventRingSize - 1;
+    if (fresh > maxEvents) {
+      lost = true;
+      fresh = maxEvents;
+    }
+
+    for (uint16_t i = 0; i < fresh; i++) {
+      const uint8_t* e = &rx[5 + ((count - fresh + i) % eventRingSize) * 8];
+      uint64_t raw = 0;
+      for (int b = 0; b < 8; b++) raw = (raw << 8) | e[b];
+      events[i].kind = (TimeEvent::Kind)(raw >> 62);
+      events[i].clocks = raw & ((1ULL << 62) - 1);
+    }
+    return lost ? -EOVERFLOW : fresh;
+  }
+
+  double FPGA::eventDeltaUs(const TimeEvent& from, const TimeEvent& to) const {
+    double clocks = (double)(int64_t)(to.clocks - from.clocks);
+    if (to.kind == TimeEvent::PPSLate) clocks += 0.5;
+    if (from.kind == TimeEvent::PPSLate) clocks -= 0.5;
+    return clocks / (fpgaClkHz * (1.0 + refErrorPpm * 1.0e-6)) * 1.0e6;
+  }
+
+  int FPGA::commitTimesUs(const TimeEvent* events, size_t n, double* usFromSlot, size_t maxOut) const {
+    const TimeEvent* slotStart = nullptr;
+    for (size_t i = 0; i < n && !slotStart; i++) {
+      if (events[i].kind != TimeEvent::Commit) slotStart = &events[i];
+    }
+    if (!slotStart) return -ENOENT;
+
+    size_t out = 0;
+    for (size_t i = 0; i < n && out < maxOut; i++) {
+      if (events[i].kind == TimeEvent::Commit) usFromSlot[out++] = eventDeltaUs(*slotStart, events[i]);
+    }
+    return out;
+  }
+
   uint32_t FPGA::getCounter() {
     if (!initialized) return 0;
 
@@ -300,20 +705,72 @@ namespace wspr {
     return val.u;
   }
 
+  int FPGA::setCrcRequired(bool required) {
+    if (!initialized) return -ENODEV;
+
+    WSPRRegs::WSPRSPIStatus st;
+    st.u = 0;
+    st.crcRequired = required ? 1 : 0;
+
+    // Verify with the pre-change settings, then confirm the FPGA has
+    // the bit set (older bitstreams read back zero).
+    crcChecked = false;
+    regSPI.config.frequency = fpgaSPI.config.frequency;
+    int ret = spiWriteReg(WSPRRegs::aWSPRSPIStatus, st.u);
+    if (ret < 0) return ret;
+
+    ret = spiReadReg(WSPRRegs::aWSPRSPIStatus, &st.u);
+    if (ret < 0) return ret;
+    if (required && !st.crcRequired) return -ENOTSUP;
+
+    crcErrorCount = st.crcErrors;
+    crcChecked = required;
+    if (required) regSPI.config.frequency = regSpiCrcHz;
+    logger.inf("spi", "CRC-protected writes %s (SCLK %u Hz)",
+	       required ? "required" : "off", regSPI.config.frequency);
+    return 0;
+  }
+
+  int FPGA::spiSendFrame(const uint8_t* buf, size_t len) {
+    gpio_pin_set_dt(&fpgaNCS, 0);
+    struct spi_buf sBuf = { .buf = (void*)buf, .len = len };
+    struct spi_buf_set sBufs = { .buffers = &sBuf, .count = 1 };
+    int ret = spi_write_dt(&regSPI, &sBufs);
+    gpio_pin_set_dt(&fpgaNCS, 1);
+    return ret;
+  }
+
   int FPGA::spiWriteReg(uint8_t reg, uint32_t value) {
-    uint8_t txBuf[5];
+    // Always append the CRC-8 trailer; the FPGA accepts a valid 48-bit
+    // frame whether or not CRC is required.
+    uint8_t txBuf[6];
     txBuf[0] = 0x80 | (reg & 0x7F);
     txBuf[1] = (value >> 24) & 0xFF;
     txBuf[2] = (value >> 16) & 0xFF;
     txBuf[3] = (value >> 8) & 0xFF;
     txBuf[4] = value & 0xFF;
+    txBuf[5] = crc8(txBuf, 5);
+
+    const int maxAttempts = 3;
+    for (int attempt = 0; attempt < maxAttempts; attempt++) {
+      int ret = spiSendFrame(txBuf, sizeof(txBuf));
+      if (ret < 0 || !crcChecked) return ret;
+
+      // A discarded frame shows up as an increment of the error count,
+      // which wraps, so any change means this frame was dropped
+      WSPRRegs::WSPRSPIStatus st;
+      ret = spiReadReg(WSPRRegs::aWSPRSPIStatus, &st.u);
+      if (ret < 0) return ret;
+      uint16_t dropped = (uint16_t)(st.crcErrors - crcErrorCount);
+      if (dropped == 0) return 0;
+
+      crcErrorCount = st.crcErrors;
+      crcErrorTotal += dropped;
+      logger.wrn("spi", "CRC error writing reg 0x%02x (attempt %d)", reg, attempt + 1);
+    }
 
-    gpio_pin_set_dt(&fpgaNCS, 0);
-    struct spi_buf sBuf = { .buf = txBuf, .len = sizeof(txBuf) };
-    struct spi_buf_set sBufs = { .buffers = &sBuf, .count = 1 };
-    int ret = spi_write_dt(&fpgaSPI, &sBufs);
-    gpio_pin_set_dt(&fpgaNCS, 1);
-    return ret;
+    logger.err("spi", "Write to reg 0x%02x failed after %d attempts", reg, maxAttempts);
+    return -EIO;
   }
 
   int FPGA::spiReadReg(uint8_t reg, uint32_t* value) {
@@ -325,7 +782,7 @@ namespace wspr {
     struct spi_buf_set sTXs = { .buffers = &sTX, .count = 1 };
     struct spi_buf sRX = { .buf = rxBuf, .len = 5 };
     struct spi_buf_set sRXs = { .buffers = &sRX, .count = 1 };
-    int ret = spi_transceive_dt(&fpgaSPI, &sTXs, &sRXs);
+    int ret = spi_transceive_dt(&regSPI, &sTXs, &sRXs);
     gpio_pin_set_dt(&fpgaNCS, 1);
 
     if (ret == 0) {
@@ -338,4 +795,19 @@ namespace wspr {
     return ret;
   }
 
+  int FPGA::spiReadBurst(uint8_t reg, uint8_t* rxBuf, size_t len) {
+    // Only the command byte matters; the driver clocks dummy bytes for
+    // the rest of the read.
+    uint8_t cmd = reg & 0x7F;
+
+    gpio_pin_set_dt(&fpgaNCS, 0);
+    struct spi_buf sTX = { .buf = &cmd, .len = 1 };
+    struct spi_buf_set sTXs = { .buffers = &sTX, .count = 1 };
+    struct spi_buf sRX = { .buf = rxBuf, .len = len };
+    struct spi_buf_set sRXs = { .buffers = &sRX, .count = 1 };
+    int ret = spi_transceive_dt(&regSPI, &sTXs, &sRXs);
+    gpio_pin_set_dt(&fpgaNCS, 1);
+    return ret;
+  }
+
 } // namespace wspr
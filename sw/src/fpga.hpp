@@ -6,22 +6,19 @@
 #pragma once
 
 #include <cstdint>
+#include <cstddef>
+
+#include "bandTable.hpp"
+#include "modulation.hpp"
 
 namespace wspr {
 
-  // WSPR band definitions (dial frequencies in Hz)
-  enum class WSPRBand : uint32_t {
-    Band160m = 1836600,
-    Band80m  = 3568600,
-    Band60m  = 5287200,
-    Band40m  = 7038600,
-    Band30m  = 10138700,
-    Band20m  = 14095600,
-    Band17m  = 18104600,
-    Band15m  = 21094600,
-    Band12m  = 24924600,
-    Band10m  = 28124600,
-    Band6m   = 50293000,
+  // One entry from the FPGA event log, stamped on its free-running
+  // 64-bit clk90 timebase (62 bits kept)
+  struct TimeEvent {
+    enum Kind : uint8_t { Commit = 1, PPS = 2, PPSLate = 3 };
+    Kind kind;			// PPSLate: edge half a clock after clocks
+    uint64_t clocks;
   };
 
   class FPGA {
@@ -29,6 +26,10 @@ namespace wspr {
     static FPGA& instance();
 
     static const int tcxoFreqHz = 40*1000*1000;
+    static const int fpgaClkHz = 90*1000*1000;
+    static const int exciterClkHz = BandTable::exciterClkHz;
+    // Register SCLK once CRC-protected writes are enabled
+    static const int regSpiCrcHz = 10*1000*1000;
 
     int init();
     int reset();
@@ -38,6 +39,35 @@ namespace wspr {
     int setFrequency(uint32_t freq_hz);
     uint32_t frequency() const { return currentFreq; }
 
+    // Reference oscillator error in ppm (positive when the TCXO runs
+    // fast). The FPGA scales every tuning word to cancel it, so nominal
+    // words and tone tables stay valid across recalibration.
+    int setFrequencyCorrection(double refErrorPpm);
+    double frequencyCorrection() const { return refErrorPpm; }
+
+    // Hardware linear sweep from startHz to stopHz, optionally looping.
+    // The FPGA steps the tuning word itself so no CPU time is used.
+    int startSweep(uint32_t startHz, uint32_t stopHz, uint32_t durationMs, bool loop = false);
+    int stopSweep();
+    bool isSweeping() const { return initialized && sweeping; }
+
+    // Exciter waveform. Table 0-3 is played at 6, 12 or 24 steps per
+    // RF cycle; more steps push harmonics further down but limit the
+    // output to 180 MHz / steps. Levels are -2..+2 per step. Not while
+    // sweeping (-EBUSY): the sweep words hold the old step count.
+    int selectWaveform(uint8_t table, uint8_t steps);
+    int loadWaveTable(uint8_t table, const int8_t* levels, size_t n);
+    int loadWavePreset(const char* name);
+    uint8_t waveTable() const { return waveTableSel; }
+    uint8_t waveSteps() const { return stepsPerCycle; }
+    uint32_t maxFrequency() const { return exciterClkHz / stepsPerCycle; }
+
+    // LFSR phase dither on the NCO. Spreads the phase truncation spurs
+    // of awkward tuning words into a low noise floor. The span is kept
+    // just under the tuning word so edges move by at most one clock.
+    int setDither(bool enable);
+    bool dither() const { return ditherOn; }
+
     // Transmission control
     int startTX();
     int stopTX();
@@ -46,16 +76,67 @@ namespace wspr {
     // Power control (0-255)
     int setPowerLevel(uint8_t level);
 
-    // Send WSPR symbol (0-3) - 4-FSK modulation
+    // Send a symbol (0-3) - 4-FSK modulation above the dial frequency
+    // from setFrequency(), which it leaves unchanged, with the tone
+    // spacing of the selected mode
+    int setModulation(Modulation::Mode mode);
+    Modulation::Mode modulation() const { return txMode; }
     int sendSymbol(uint8_t symbol);
+    // Same from a band's precomputed words (MessageCache::tones)
+    int sendSymbol(uint8_t symbol, const uint32_t* toneWords);
+
+    // Low-pass filter bank (IO4-IO7). Filter 0 (6 MHz) and 1 (16 MHz)
+    // sit behind the low path master switch, filter 2 (32 MHz) on the
+    // high path; BandPlanner::lpfForHz picks one for a frequency. A
+    // change waits lpfSettleMs with every path open, so it is refused
+    // while transmitting. startTX() selects the filter for the current
+    // frequency if nobody has; the scheduler does it ahead of the slot.
+    static const uint8_t lpfCount = 3;
+    static const uint32_t lpfMaxHz = 32*1000*1000;
+    static const int lpfSettleMs = 5;
+    static const uint8_t lpfNone = 0xff;
+    int setLPF(uint8_t lpf);
+    uint8_t lpf() const { return lpfSel; }
 
     // LPF band switching
-    int setLPFBand(WSPRBand band);
-    WSPRBand getBand() const { return currentBand; }
+    int setLPFBand(BandTable::Id band);
+    BandTable::Id getBand() const { return currentBand; }
+
+    // RF output self-measurement over a PPS-gated window of 1, 10 or
+    // 100 seconds. gen advances each time a new count is published.
+    int setRFWindow(uint32_t seconds);
+    uint32_t rfWindow() const { return rfWindowSec; }
+    int getRFCount(uint32_t* cycles, uint8_t* gen);
+
+    // Latest GNSS PPS timestamp in half clk90 cycles (the DDR input
+    // capture resolves 5.6 ns). Wraps at 2^28; gen counts PPS edges.
+    int getPPSStamp(uint32_t* halfClocks, uint8_t* gen);
+
+    // Events (Tuning register commits and PPS edges) logged since the
+    // last call, oldest first. Returns the number stored, or -EOVERFLOW
+    // when older events were overwritten (the newest are still stored).
+    static const int eventRingSize = 64;
+    int readEvents(TimeEvent* events, size_t maxEvents);
+
+    // Microseconds from one event to another, in true time: the
+    // timebase runs at fpgaClkHz scaled by the reference error.
+    double eventDeltaUs(const TimeEvent& from, const TimeEvent& to) const;
+
+    // Convert the commits in events[] to microseconds from the first PPS
+    // edge there, which the caller arranges to be the slot start.
+    // Returns the number of commits converted, -ENOENT without a PPS.
+    int commitTimesUs(const TimeEvent* events, size_t n, double* usFromSlot, size_t maxOut) const;
 
     uint32_t getCounter();
     uint32_t getLiveCounter();
 
+    // CRC-protected register writes. When required, the FPGA discards
+    // write frames with a bad CRC and the driver retries them, which
+    // lets register traffic run at regSpiCrcHz.
+    int setCrcRequired(bool required);
+    bool crcRequired() const { return crcChecked; }
+    uint32_t crcErrors() const { return crcErrorTotal; }
+
     // Raw register access for diagnostics
     int readRegister(uint8_t reg, uint32_t* value) { return spiReadReg(reg, value); }
 
@@ -64,13 +145,33 @@ namespace wspr {
   private:
     FPGA() = default;
 
+    uint32_t tuningWordForHz(uint32_t freqHz) const;
+    static uint8_t ditherWidthFor(uint32_t word);
+    int writeDither(uint8_t width);
+    int writeTuning(uint32_t word, uint32_t endWord);
+
+    int spiSendFrame(const uint8_t* buf, size_t len);
     int spiWriteReg(uint8_t reg, uint32_t value);
     int spiReadReg(uint8_t reg, uint32_t* value);
+    int spiReadBurst(uint8_t reg, uint8_t* rxBuf, size_t len);
 
     bool initialized = false;
     bool transmitting = false;
+    bool sweeping = false;
     uint32_t currentFreq = 0;
-    WSPRBand currentBand = WSPRBand::Band20m;
+    double refErrorPpm = 0.0;
+    uint32_t rfWindowSec = 1;
+    bool crcChecked = false;
+    uint16_t crcErrorCount = 0;		// SPIStatus.crcErrors last seen
+    uint32_t crcErrorTotal = 0;
+    uint8_t waveTableSel = 0;
+    uint8_t stepsPerCycle = BandTable::defaultSteps;
+    uint16_t eventsSeen = 0;
+    bool ditherOn = false;
+    uint8_t ditherBits = 0;
+    BandTable::Id currentBand = BandTable::Id::Band20m;
+    uint8_t lpfSel = lpfNone;
+    Modulation::Mode txMode = Modulation::Mode::Wspr2;
   };
 
 } // namespace wspr
@@ -315,10 +315,10 @@ int64_t GNSS::unixTime() const {
     return (int64_t)epoch;
 }
 
-bool GNSS::isTXSlot() const {
+bool GNSS::isTXSlot(int periodMin) const {
     k_mutex_lock(&mutex, K_FOREVER);
-    // WSPR transmissions start at even minutes
-    bool result = data.valid && (data.second == 0) && ((data.minute % 2) == 0);
+    // Periods divide the hour, so they start on multiples of it
+    bool result = data.valid && (data.second == 0) && ((data.minute % periodMin) == 0);
     k_mutex_unlock(&mutex);
     return result;
 }
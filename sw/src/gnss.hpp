@@ -73,8 +73,9 @@ public:
     // Get Unix timestamp (seconds since epoch)
     int64_t unixTime() const;
 
-    // Check if we're at the start of an even minute (for WSPR timing)
-    bool isTXSlot() const;
+    // Check if this second starts a transmit period of periodMin minutes
+    // (even minutes for WSPR-2)
+    bool isTXSlot(int periodMin = 2) const;
 
 private:
     GNSS() = default;
@@ -8,13 +8,19 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/net/net_if.h>
 #include <zephyr/net/net_mgmt.h>
+#include <utility>
 
 #include "wifiManager.hpp"
 #include "webserver.hpp"
 #include "captiveDNS.hpp"
 #include "gnss.hpp"
 #include "fpga.hpp"
+#include "tcxo.hpp"
 #include "filesystem.hpp"
+#include "nvstore.hpp"
+#include "flashScheduler.hpp"
+#include "appConfig.hpp"
+#include "slotPlanner.hpp"
 #include "logmanager.hpp"
 
 LOG_MODULE_REGISTER(wspr_ease, LOG_LEVEL_INF);
@@ -92,8 +98,11 @@ static void initSubsystems(wspr::WebServer& webServer)
     auto& fs = wspr::FileSystem::instance();
     using wspr::logger;
 
-    // Mount LittleFS early - doesn't need network
+    // Mount LittleFS and NVS early - don't need network
     fs.mount();
+    wspr::NVStore::instance().mount();
+    wspr::FlashScheduler::instance().init(&wspr::storageBackend);
+    wspr::ConfigStore::instance().load();
 
     // Initialize GNSS (stub mode)
     if (gnss.init() != 0) {
@@ -105,6 +114,9 @@ static void initSubsystems(wspr::WebServer& webServer)
         logger.err("init", "FPGA init failed");
     }
 
+    // Apply the stored reference correction and start refining it
+    wspr::TcxoMonitor::instance().init();
+
     // Initialize WiFi
     if (wifi.init() != 0) {
         logger.err("init", "WiFi init failed");
@@ -148,15 +160,56 @@ int main(void)
     auto& wifi = wspr::WifiManager::instance();
     auto& gnss = wspr::GNSS::instance();
     auto& fpga = wspr::FPGA::instance();
+    auto& planner = wspr::SlotPlanner::instance();
 
     uint32_t loopCount = 0;
     bool wasConnected = wifi.isConnected();
 
+    // Settings the plan and the prepared message come from. Taken again
+    // at each slot boundary, once that slot is under way, so an edit
+    // governs the slots planned after the next boundary.
+    wspr::ConfigStore::Snapshot slotConfig = wspr::ConfigStore::instance().current();
+
+    // The message and tone words of the slot being sent
+    static uint8_t symbols[wspr::Modulation::maxSymbols];
+    static uint32_t toneWords[wspr::Modulation::toneCount];
+
     while (1) {
         // Check for scheduled WSPR transmission
         // (In real implementation, this would check schedule and start TX)
-        if (gnss.isTXSlot() && !fpga.isTransmitting()) {
-            logger.inf("tx", "TX slot detected (not transmitting in stub mode)");
+        int periodMin = wspr::Modulation::get(planner.txMode()).periodMin();
+        if (gnss.isTXSlot(periodMin) && !fpga.isTransmitting()) {
+            // Decided ahead of time; this is only a lookup
+            int64_t now = gnss.unixTime();
+            wspr::BandPlanner::Slot slot;
+            if (planner.take(now - now % 60, slot)) {
+                if (fpga.lpf() != slot.lpf) {
+                    logger.wrn("tx", "Filter %u not preselected, switching at the slot", slot.lpf);
+                    fpga.setLPF(slot.lpf);
+                }
+                fpga.setModulation(slot.mode);
+                if (!planner.message(slot, *slotConfig, symbols, toneWords)) {
+                    logger.err("tx", "No message to send, slot skipped");
+                } else {
+                    logger.inf("tx", "TX slot on %u Hz, %s (not transmitting in stub mode)", slot.freqHz,
+                            wspr::Modulation::get(slot.mode).name);
+                }
+            }
+
+            auto latest = wspr::ConfigStore::instance().current();
+            if (latest.generation() != slotConfig.generation()) {
+                logger.inf("tx", "Configuration %u applied: Callsign=%s Power=%d dBm",
+                        latest.generation(), latest->callsign, latest->powerDbm);
+            }
+            slotConfig = std::move(latest);
+        } else {
+            // Between slots: follow configuration changes, top up the
+            // plan, encode the next message and switch the filter bank
+            // ahead of the next slot
+            int64_t now = gnss.unixTime();
+            planner.refresh(now, slotConfig);
+            planner.prepareMessage(now, *slotConfig);
+            planner.preselect(now);
         }
 
         // Monitor WiFi connection and reconnect if needed
@@ -0,0 +1,79 @@
+/*
+ * NVS Storage Implementation for WSPR-ease
+ */
+
+#include "nvstore.hpp"
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/drivers/flash.h>
+
+#include "logmanager.hpp"
+
+namespace wspr {
+
+// Register subsystem with LogManager
+static Logger& logger = LogManager::instance().registerSubsystem("nvs",
+    {"mount", "ops"});
+
+NVStore& NVStore::instance() {
+  static NVStore inst;
+  return inst;
+}
+
+int NVStore::mount() {
+  if (mounted) return 0;
+
+  const struct flash_area *fa;
+  int rc = flash_area_open(FIXED_PARTITION_ID(storage_partition), &fa);
+  if (rc) {
+    logger.err("mount", "Flash area open failed: %d (check app.overlay partitions)", rc);
+    return rc;
+  }
+
+  fs.flash_device = fa->fa_dev;
+  fs.offset = fa->fa_off;
+  struct flash_pages_info info;
+  rc = flash_get_page_info_by_offs(fa->fa_dev, fs.offset, &info);
+  if (rc) {
+    logger.err("mount", "Flash get page info failed: %d at offset 0x%lx", rc, (long)fs.offset);
+    flash_area_close(fa);
+    return rc;
+  }
+
+  fs.sector_size = info.size;
+  fs.sector_count = fa->fa_size / info.size;
+
+  logger.inf("mount", "NVS init: dev=%p, off=0x%lx, sec_sz=%u, sec_cnt=%u",
+             fs.flash_device, (long)fs.offset, fs.sector_size, fs.sector_count);
+
+  rc = nvs_mount(&fs);
+  flash_area_close(fa);
+  if (rc) {
+    logger.err("mount", "NVS mount failed: %d", rc);
+    return rc;
+  }
+
+  mounted = true;
+  return 0;
+}
+
+ssize_t NVStore::read(Id id, void* data, size_t len) {
+  if (!mounted) return -ENODEV;
+  return nvs_read(&fs, id, data, len);
+}
+
+ssize_t NVStore::write(Id id, const void* data, size_t len) {
+  if (!mounted) return -ENODEV;
+  ssize_t rc = nvs_write(&fs, id, data, len);
+  if (rc < 0) logger.err("ops", "NVS write of record %u failed: %d", id, (int)rc);
+  return rc;
+}
+
+int NVStore::remove(Id id) {
+  if (!mounted) return -ENODEV;
+  int rc = nvs_delete(&fs, id);
+  if (rc < 0) logger.err("ops", "NVS delete of record %u failed: %d", id, rc);
+  return rc;
+}
+
+} // namespace wspr
@@ -0,0 +1,47 @@
+/*
+ * NVS Storage for WSPR-ease
+ * Mounts the NVS partition once and hands out numbered records
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <sys/types.h>
+#include <zephyr/fs/nvs.h>
+
+namespace wspr {
+
+  class NVStore {
+  public:
+    static NVStore& instance();
+
+    // Record IDs, one per persisted object. Never reuse a retired ID.
+    enum Id : uint16_t {
+      AppConfigV0 = 1,		// Retired: whole AppConfig, migrated at boot
+      TcxoCal = 2,
+      ConfigVersion = 3,	// ConfigSchema::version of the field records
+      ConfigFields = 0x100,	// + ConfigSchema field key
+    };
+
+    // Mount the storage partition (safe to call more than once)
+    int mount();
+    bool isMounted() const { return mounted; }
+
+    // Same return values as nvs_read() and nvs_write()
+    ssize_t read(Id id, void* data, size_t len);
+    ssize_t write(Id id, const void* data, size_t len);
+    int remove(Id id);
+
+  private:
+    NVStore() = default;
+
+    // Prevent copying
+    NVStore(const NVStore&) = delete;
+    NVStore& operator=(const NVStore&) = delete;
+
+    bool mounted = false;
+    struct nvs_fs fs;
+  };
+
+} // namespace wspr
@@ -8,46 +8,20 @@
 #include <zephyr/kernel.h>
 #include <zephyr/fs/fs.h>
 #include <stdlib.h>
+#include <math.h>
 #include <string>
 #include "wifiManager.hpp"
 #include "gnss.hpp"
 #include "regs.hpp"
 #include "fpga.hpp"
+#include "tcxo.hpp"
+#include "flashScheduler.hpp"
+#include "appConfig.hpp"
+#include "slotPlanner.hpp"
 #include "logmanager.hpp"
 
 namespace wspr {
 
-  static struct k_thread sweepThreadData;
-  static K_THREAD_STACK_DEFINE(sweepThreadStack, 2048);
-  static bool sweepRunning = false;
-  static bool sweepContinuous = false;
-  static uint32_t sweepDurationSec = 10;
-
-  static void sweepThreadEntry(void *p1, void *p2, void *p3) {
-    auto& fpga = FPGA::instance();
-    const struct shell *sh = (const struct shell *)p1;
-
-    uint32_t startFreq = 1000000; // 1 MHz
-    uint32_t endFreq = 30000000; // 30 MHz
-    uint32_t steps = 1000;
-    uint32_t stepDelayMs = (sweepDurationSec * 1000) / steps;
-    
-    do {
-      shell_print(sh, "Starting sweep: %u to %u MHz over %u s", 
-		  startFreq/1000000, endFreq/1000000, sweepDurationSec);
-        
-      for (uint32_t i = 0; i <= steps && sweepRunning; i++) {
-	uint32_t freq = startFreq + ((uint64_t)(endFreq - startFreq) * i) / steps;
-	fpga.setFrequency(freq);
-	k_msleep(stepDelayMs);
-      }
-    } while (sweepRunning && sweepContinuous);
-
-    sweepRunning = false;
-    fpga.stopTX();
-    shell_print(sh, "Sweep stopped.");
-  }
-
   static int cmd_status(const struct shell *sh, size_t argc, char **argv) {
     auto& wifi = WifiManager::instance();
     auto& gnss = GNSS::instance();
@@ -74,35 +48,55 @@ namespace wspr {
     shell_print(sh, "Freq: %u Hz", fpga.frequency());
     shell_print(sh, "PPS:  %u", fpga.getCounter());
 
+    auto fs = FlashScheduler::instance().stats();
+    shell_print(sh, "--- Flash ---");
+    shell_print(sh, "Writes: %u (%u deferred, %u queued, %u TX overrides, %u failed)",
+                fs.run, fs.deferred, FlashScheduler::instance().pending(), fs.overrides, fs.failed);
+
     return 0;
   }
 
   static int cmd_tx_stop(const struct shell *sh, size_t argc, char **argv) {
-    sweepRunning = false;
-    FPGA::instance().stopTX();
+    auto& fpga = FPGA::instance();
+    fpga.stopSweep();
+    fpga.stopTX();
     shell_print(sh, "TX stopped");
     return 0;
   }
 
   static int cmd_tx_sweep(const struct shell *sh, size_t argc, char **argv) {
-    if (sweepRunning) {
+    auto& fpga = FPGA::instance();
+    if (fpga.isSweeping()) {
       shell_error(sh, "Sweep already running. Use tx stop first.");
       return -EBUSY;
     }
 
-    sweepDurationSec = (argc > 1) ? strtoul(argv[1], NULL, 10) : 10;
-    sweepContinuous = (argc > 2 && strcmp(argv[2], "continuous") == 0);
-    
-    auto& fpga = FPGA::instance();
-    fpga.setPowerLevel(255); // Full power for sweep
-    fpga.startTX();
+    // Up to 1 MHz short of the NCO limit: its tuning word wraps to 0
+    const uint32_t startFreq = 1000000; // 1 MHz
+    const uint32_t endFreq = fpga.maxFrequency() - 1000000;
+    uint32_t durationSec = (argc > 1) ? strtoul(argv[1], NULL, 10) : 10;
+    bool continuous = (argc > 2 && strcmp(argv[2], "continuous") == 0);
 
-    sweepRunning = true;
-    k_thread_create(&sweepThreadData, sweepThreadStack,
-                    K_THREAD_STACK_SIZEOF(sweepThreadStack),
-                    sweepThreadEntry, (void*)sh, NULL, NULL,
-                    7, 0, K_NO_WAIT);
+    if (durationSec == 0) {
+      shell_error(sh, "Sweep duration must be at least 1 s");
+      return -EINVAL;
+    }
 
+    int ret = fpga.startSweep(startFreq, endFreq, durationSec * 1000, continuous);
+    if (ret == -ERANGE) {
+      shell_error(sh, "Sweep %u to %u Hz over %u s out of range (NCO limit %u Hz)",
+		  startFreq, endFreq, durationSec, fpga.maxFrequency());
+      return ret;
+    } else if (ret < 0) {
+      shell_error(sh, "Sweep setup failed: %d", ret);
+      return ret;
+    }
+
+    fpga.setPowerLevel(255); // Full power for sweep
+    fpga.startTX();
+    shell_print(sh, "Sweeping %u to %u kHz over %u s%s",
+		startFreq/1000, endFreq/1000, durationSec,
+		continuous ? " (continuous)" : "");
     return 0;
   }
 
@@ -217,28 +211,30 @@ namespace wspr {
 
   static int cmd_fpga_counter(const struct shell *sh, size_t argc, char **argv) {
     auto& fpga = wspr::FPGA::instance();
-    WSPRPPS pps;
-    WSPRPPS prev;
+    uint32_t stamp, prevStamp;
+    uint8_t gen, prevGen;
+
+    // Wait for the next PPS edge so the two timestamps are one second
+    // apart.
+    if (fpga.getPPSStamp(&prevStamp, &prevGen) < 0) {
+      shell_error(sh, "Failed to read PPS timestamp from FPGA!");
+      return -EIO;
+    }
 
-    pps.u = ~0ul;
-    
-    // Read register in a loop until generation field transitions to a
-    // new value to avoid hardware update race and acquire previous
-    // count to subtract.
     int attempts = 0;
     do {
-      prev = pps;
-      fpga.readRegister(aWSPRPPS, &pps.u);
+      k_msleep(20);
+      fpga.getPPSStamp(&stamp, &gen);
       attempts++;
-    } while (pps.gen != prev.gen && attempts < 100);
+    } while (gen == prevGen && attempts < 100);
 
-    if (attempts >= 100) {
-      shell_error(sh, "Failed to get stable PPS readings from FPGA!");
+    if (gen == prevGen) {
+      shell_error(sh, "No PPS edge seen by the FPGA in 2 s!");
       return -EIO;
     }
 
-    // Handle 32-bit rollover.
-    uint32_t delta_f = pps.count - prev.count;
+    // Timestamps are in half clock cycles and wrap at 2^28
+    uint32_t delta_f = (stamp - prevStamp) & 0x0FFFFFFF;
 
     WSPRControl ctrl;
     uint32_t tuning, sig;
@@ -256,8 +252,8 @@ namespace wspr {
     
     // We are measuring exactly 1 second between two rising edges
     if (delta_f > 0) {
-      double freq = (double)delta_f;
-      double ppm = (freq - wspr::FPGA::tcxoFreqHz) / (wspr::FPGA::tcxoFreqHz / 1.0e6);
+      double freq = delta_f / 2.0;
+      double ppm = (freq - wspr::FPGA::fpgaClkHz) / (wspr::FPGA::fpgaClkHz / 1.0e6);
       shell_print(sh, "----------------------------");
       shell_print(sh, "Measured Frequency: %.3f Hz", freq);
       shell_print(sh, "Clock Error:        %.3f ppm", ppm);
@@ -268,6 +264,248 @@ namespace wspr {
     return 0;
   }
 
+  static int cmd_fpga_corr(const struct shell *sh, size_t argc, char **argv) {
+    auto& fpga = FPGA::instance();
+
+    if (argc > 1) {
+      char *endptr;
+      double ppm = strtod(argv[1], &endptr);
+      if (*endptr != '\0') {
+	shell_error(sh, "Usage: fpga corr [ppm]");
+	return -EINVAL;
+      }
+
+      int ret = fpga.setFrequencyCorrection(ppm);
+      if (ret < 0) {
+	shell_error(sh, "Failed to set correction: %d", ret);
+	return ret;
+      }
+    }
+
+    shell_print(sh, "Reference error: %.4f ppm", fpga.frequencyCorrection());
+    return 0;
+  }
+
+  static int cmd_fpga_tcxo(const struct shell *sh, size_t argc, char **argv) {
+    auto& tcxo = TcxoMonitor::instance();
+
+    if (argc > 1) {
+      if (strcmp(argv[1], "reset") == 0 && argc == 2) {
+	tcxo.reset();
+      } else if (strcmp(argv[1], "gate") == 0 && argc == 3) {
+	char *endptr;
+	long sec = strtol(argv[2], &endptr, 10);
+	if (*endptr != '\0' || sec < 1 || sec > TcxoEstimator::maxGateSec) {
+	  shell_error(sh, "Gate must be 1-%u s", TcxoEstimator::maxGateSec);
+	  return -EINVAL;
+	}
+	tcxo.setGate((uint16_t)sec);
+      } else {
+	shell_error(sh, "Usage: fpga tcxo [gate <1-1000 s>|reset]");
+	return -EINVAL;
+      }
+    }
+
+    auto e = tcxo.estimate();
+    auto s = tcxo.stats();
+    if (e.valid) {
+      shell_print(sh, "Reference error: %+.4f ppm +/- %.4f ppm over %u s (gate %u s)",
+		  e.ppm, e.uncertaintyPpm, e.tauSec, tcxo.gate());
+    } else {
+      shell_print(sh, "Reference error: no estimate yet (gate %u s)", tcxo.gate());
+    }
+    shell_print(sh, "PPS edges: %u, missed %u, rejected %u", s.edges, s.missed, s.rejected);
+    shell_print(sh, "FPGA correction: %+.4f ppm (%s)", tcxo.correctionPpm(),
+		TcxoMonitor::sourceName(tcxo.source()));
+    auto cal = tcxo.calibration();
+    if (cal.valid()) {
+      shell_print(sh, "Stored: %+.4f ppm at %lld, aging %+.5f ppm/day, %u saves",
+		  cal.record().ppm, (long long)cal.record().unixTime,
+		  cal.record().ratePpmPerDay, cal.record().saves);
+    }
+
+    TcxoEstimator::AdevPoint table[TcxoEstimator::nTableGates];
+    int n = tcxo.adevTable(table, TcxoEstimator::nTableGates);
+    shell_print(sh, "  tau s  pairs  ADEV ppm");
+    for (int i = 0; i < n; i++) {
+      if (table[i].pairs == 0) continue;
+      shell_print(sh, "  %5u  %5u  %.6f", table[i].tauSec, table[i].pairs, table[i].adevPpm);
+    }
+    return 0;
+  }
+
+  static int cmd_fpga_wave(const struct shell *sh, size_t argc, char **argv) {
+    auto& fpga = FPGA::instance();
+
+    if (argc > 1) {
+      int ret = fpga.loadWavePreset(argv[1]);
+      if (ret == -ENOENT) {
+	shell_error(sh, "Usage: fpga wave [121|12step|24step]");
+	return -EINVAL;
+      } else if (ret == -ERANGE) {
+	shell_error(sh, "Current frequency %u Hz is too high for %s", fpga.frequency(), argv[1]);
+	return ret;
+      } else if (ret == -EBUSY) {
+	shell_error(sh, "Sweep running. Use tx stop first.");
+	return ret;
+      } else if (ret < 0) {
+	shell_error(sh, "Failed to load waveform: %d", ret);
+	return ret;
+      }
+    }
+
+    shell_print(sh, "Waveform table %u, %u steps per cycle (max %u Hz)",
+		fpga.waveTable(), fpga.waveSteps(), fpga.maxFrequency());
+    return 0;
+  }
+
+  static int cmd_fpga_dither(const struct shell *sh, size_t argc, char **argv) {
+    auto& fpga = FPGA::instance();
+
+    if (argc > 1) {
+      bool on;
+      if (strcmp(argv[1], "on") == 0) on = true;
+      else if (strcmp(argv[1], "off") == 0) on = false;
+      else {
+	shell_error(sh, "Usage: fpga dither [on|off]");
+	return -EINVAL;
+      }
+
+      int ret = fpga.setDither(on);
+      if (ret < 0) {
+	shell_error(sh, "Failed to set dither: %d", ret);
+	return ret;
+      }
+    }
+
+    shell_print(sh, "NCO phase dither: %s", fpga.dither() ? "on" : "off");
+    return 0;
+  }
+
+  static int cmd_fpga_lpf(const struct shell *sh, size_t argc, char **argv) {
+    auto& fpga = FPGA::instance();
+    auto& planner = SlotPlanner::instance();
+
+    if (argc > 2 && strcmp(argv[1], "lead") == 0) {
+      if (planner.setLpfLead(atoi(argv[2])) < 0) {
+	shell_error(sh, "Lead time is 1-%d s", SlotPlanner::maxLpfLeadSec);
+	return -EINVAL;
+      }
+    } else if (argc > 1) {
+      char *end;
+      unsigned long lpf = strtoul(argv[1], &end, 10);
+      if (*end != '\0' || lpf >= FPGA::lpfCount) {
+	shell_error(sh, "Usage: fpga lpf [0|1|2|lead <s>]");
+	return -EINVAL;
+      }
+      int ret = fpga.setLPF((uint8_t)lpf);
+      if (ret == -EBUSY) {
+	shell_error(sh, "Not while transmitting");
+	return ret;
+      } else if (ret < 0) {
+	shell_error(sh, "Failed to select filter: %d", ret);
+	return ret;
+      }
+    }
+
+    if (fpga.lpf() == FPGA::lpfNone) shell_print(sh, "LPF: none selected");
+    else shell_print(sh, "LPF: %u", fpga.lpf());
+    shell_print(sh, "Selected %d s before a slot, settles in %d ms", planner.lpfLead(), FPGA::lpfSettleMs);
+    return 0;
+  }
+
+  static int cmd_fpga_events(const struct shell *sh, size_t argc, char **argv) {
+    auto& fpga = FPGA::instance();
+    static TimeEvent events[FPGA::eventRingSize];
+
+    int n = fpga.readEvents(events, FPGA::eventRingSize);
+    if (n == -EOVERFLOW) {
+      shell_warn(sh, "Event log overran; older events lost");
+      n = FPGA::eventRingSize - 1;
+    } else if (n < 0) {
+      shell_error(sh, "Failed to read event log: %d", n);
+      return n;
+    }
+
+    // Times are from the first PPS edge in the batch. Commits are also
+    // placed on the WSPR symbol grid (1 s after the slot start, then
+    // every 8192/12000 s) to show their timing error.
+    const double symbolUs = 8192.0 / 12000.0 * 1.0e6;
+    const TimeEvent* ref = nullptr;
+    for (int i = 0; i < n && !ref; i++) {
+      if (events[i].kind != TimeEvent::Commit) ref = &events[i];
+    }
+
+    shell_print(sh, "%d new event%s", n, n == 1 ? "" : "s");
+    for (int i = 0; i < n; i++) {
+      bool commit = events[i].kind == TimeEvent::Commit;
+      if (!ref) {
+	shell_print(sh, "  %-6s clk90 %llu", commit ? "commit" : "PPS",
+		    (unsigned long long)events[i].clocks);
+	continue;
+      }
+
+      double us = fpga.eventDeltaUs(*ref, events[i]);
+      if (commit && us >= 0) {
+	double k = floor((us - 1.0e6) / symbolUs + 0.5);
+	shell_print(sh, "  %-6s %+14.3f us  symbol %d %+.3f us", "commit", us,
+		    (int)k, us - 1.0e6 - k * symbolUs);
+      } else {
+	shell_print(sh, "  %-6s %+14.3f us", commit ? "commit" : "PPS", us);
+      }
+    }
+    return 0;
+  }
+
+  static int cmd_fpga_rfcount(const struct shell *sh, size_t argc, char **argv) {
+    auto& fpga = FPGA::instance();
+
+    if (argc > 1) {
+      int ret = fpga.setRFWindow(strtoul(argv[1], NULL, 10));
+      if (ret < 0) {
+	shell_error(sh, "Usage: fpga rfcount [1|10|100]");
+	return ret;
+      }
+    }
+
+    uint32_t window = fpga.rfWindow();
+    uint32_t cycles;
+    uint8_t gen, startGen;
+    int ret = fpga.getRFCount(&cycles, &startGen);
+    if (ret < 0) {
+      shell_error(sh, "Failed to read RF counter: %d", ret);
+      return ret;
+    }
+
+    // Wait for a window that started after this command, which after a
+    // window change takes two windows (the first only primes the counter).
+    shell_print(sh, "Measuring RF output over %u s...", window);
+    uint32_t timeoutMs = (2 * window + 2) * 1000;
+    int64_t start = k_uptime_get();
+    do {
+      k_msleep(100);
+      ret = fpga.getRFCount(&cycles, &gen);
+      if (ret < 0) continue;
+      if ((uint8_t)(gen - startGen) >= 2 || (argc <= 1 && gen != startGen)) break;
+    } while (k_uptime_get() - start < timeoutMs);
+
+    if (ret < 0 || gen == startGen) {
+      shell_error(sh, "No RF count within %u ms. TX off or PPS missing?", timeoutMs);
+      return -ETIMEDOUT;
+    }
+
+    double measured = (double)cycles / window;
+    shell_print(sh, "RF cycles:     %u in %u s", cycles, window);
+    shell_print(sh, "Measured:      %.3f Hz", measured);
+    if (fpga.isTransmitting() && fpga.frequency() > 0) {
+      double nominal = fpga.frequency();
+      shell_print(sh, "Nominal:       %u Hz", fpga.frequency());
+      shell_print(sh, "Error:         %.3f Hz (%.3f ppm)",
+		  measured - nominal, (measured - nominal) / nominal * 1.0e6);
+    }
+    return 0;
+  }
+
   // File system helpers
   static int cmd_fs_ls(const struct shell *sh, size_t argc, char **argv) {
     const char* path = "/lfs";
@@ -391,11 +629,19 @@ namespace wspr {
     shell_print(sh, "--- Registers ---");
     shell_print(sh, "Tuning Word:     0x%08X", tuning);
     shell_print(sh, "Power Thresh:          0x%02X", ctrl.powerThresh);
+    shell_print(sh, "SPI CRC:         %s (%u errors)",
+		fpga.crcRequired() ? "REQUIRED" : "OFF", fpga.crcErrors());
     if (!ctrl.pllLocked) shell_warn(sh, "WARNING: FPGA PLL is not locked.");
     return 0;
   }
 
   static int cmd_reboot(const struct shell *sh, size_t argc, char **argv) {
+    // Unsaved settings and writes held back by a transmission would
+    // otherwise be lost
+    ConfigStore::instance().flush();
+    if (FlashScheduler::instance().flush() < 0) {
+      shell_warn(sh, "Some queued flash writes failed");
+    }
     shell_execute_cmd(sh, "kernel reboot");
     return 0;
   }
@@ -405,6 +651,13 @@ namespace wspr {
 				 SHELL_CMD(reset, NULL, "Reset iCE40 FPGA", cmd_fpga_reset),
 				 SHELL_CMD(flash, NULL, "Load bitstream from LFS [path]", cmd_fpga_flash),
 				 SHELL_CMD(counter, NULL, "Read 1PPS reference counter (Falling edge)", cmd_fpga_counter),
+				 SHELL_CMD(corr, NULL, "Show or set TCXO error correction [ppm]", cmd_fpga_corr),
+				 SHELL_CMD(tcxo, NULL, "Long-gate TCXO error and Allan deviation [gate <s>|reset]", cmd_fpga_tcxo),
+				 SHELL_CMD(wave, NULL, "Show or select exciter waveform [121|12step|24step]", cmd_fpga_wave),
+				 SHELL_CMD(dither, NULL, "Show or set NCO phase dither [on|off]", cmd_fpga_dither),
+				 SHELL_CMD(lpf, NULL, "Show or select the low-pass filter [0|1|2|lead <s>]", cmd_fpga_lpf),
+				 SHELL_CMD(events, NULL, "Show tuning commits and PPS edges logged since last call", cmd_fpga_events),
+				 SHELL_CMD(rfcount, NULL, "Measure RF output frequency [1|10|100 s window]", cmd_fpga_rfcount),
 				 SHELL_SUBCMD_SET_END
 				 );
 
@@ -0,0 +1,222 @@
+/*
+ * Slot Planner Implementation for WSPR-ease
+ */
+
+#include "slotPlanner.hpp"
+
+#include <cstring>
+#include <errno.h>
+
+#include "appConfig.hpp"
+#include "bandTable.hpp"
+#include "fpga.hpp"
+#include "gnss.hpp"
+#include "logmanager.hpp"
+
+namespace wspr {
+
+// Register subsystem with LogManager
+static Logger& logger = LogManager::instance().registerSubsystem("planner",
+    {"compile", "slot", "lpf", "message"});
+
+SlotPlanner& SlotPlanner::instance() {
+    static SlotPlanner inst;
+    return inst;
+}
+
+SlotPlanner::SlotPlanner() {
+    k_mutex_init(&mutex);
+}
+
+static BandPlanner::Mode modeFromName(const char* mode) {
+    if (strcmp(mode, "manual") == 0) return BandPlanner::Mode::Manual;
+    if (strcmp(mode, "random") == 0) return BandPlanner::Mode::Random;
+    if (strcmp(mode, "list") == 0) return BandPlanner::Mode::List;
+    return BandPlanner::Mode::RoundRobin;
+}
+
+// Translate the stored settings. AppConfig has no time windows or duty
+// cycle yet, so every enabled band is eligible in every slot.
+static void buildConfig(const AppConfig& app, BandPlanner::Config& c) {
+    c.mode = modeFromName(app.mode);
+    if (!Modulation::fromName(app.txMode, c.txMode)) {
+        logger.wrn("compile", "Unknown mode %s, using WSPR-2", app.txMode);
+        c.txMode = Modulation::Mode::Wspr2;
+    }
+    c.slotIntervalMin = app.slotIntervalMin;
+    c.compoundCall = strchr(app.callsign, '/') != nullptr;
+    c.longLocator = strlen(app.gridSquare) == 6;
+    c.seed = (uint32_t)k_cycle_get_32();
+    c.nBands = BandTable::count < BandPlanner::maxBands ? BandTable::count : BandPlanner::maxBands;
+    for (int b = 0; b < c.nBands; b++) {
+        c.bands[b].freqHz = BandTable::get(b).dialHz;
+        c.bands[b].enabled = app.bandEnabled[b];
+    }
+
+    // "20m,20m,40m": repeats weight a band
+    char list[sizeof(app.bandList)];
+    strncpy(list, app.bandList, sizeof(list) - 1);
+    list[sizeof(list) - 1] = '\0';
+    c.listLen = 0;
+    char* save = nullptr;
+    for (char* tok = strtok_r(list, ", ", &save); tok && c.listLen < BandPlanner::maxList;
+         tok = strtok_r(nullptr, ", ", &save)) {
+        int b = BandTable::fromName(tok);
+        if (b >= 0 && b < c.nBands) c.list[c.listLen++] = (uint8_t)b;
+    }
+}
+
+BandPlanner::SunTimes SlotPlanner::sunTimes(int64_t unixTime, const char* grid) {
+    auto& gnss = GNSS::instance();
+    double lat, lon;
+    BandPlanner::SunTimes st;
+    if (gnss.hasFix()) {
+        lat = gnss.latitude();
+        lon = gnss.longitude();
+    } else if (!SolarCalc::gridToLatLon(grid, lat, lon)) {
+        return st;
+    }
+
+    // Cached per day and cell, so this is cheap on every refresh
+    const SolarCalc::Day& d = solar.get(unixTime, lat, lon);
+    st.known = true;
+    st.sunriseMin = d.sunriseMin;
+    st.sunsetMin = d.sunsetMin;
+    st.daylightMin = d.daylightMin;
+    return st;
+}
+
+void SlotPlanner::refresh(int64_t unixTime, const ConfigStore::Snapshot& cfg) {
+    if (unixTime <= 0) return;
+
+    k_mutex_lock(&mutex, K_FOREVER);
+    BandPlanner::SunTimes st = sunTimes(unixTime, cfg->gridSquare);
+    bool sunChanged = st.known != sun.known || st.sunriseMin != sun.sunriseMin ||
+        st.sunsetMin != sun.sunsetMin || st.daylightMin != sun.daylightMin;
+    if (cfg.generation() != configGeneration || sunChanged) {
+        BandPlanner::Config c;
+        buildConfig(*cfg, c);
+        planner.compile(c, st);
+        configGeneration = cfg.generation();
+        sun = st;
+        logger.inf("compile", "Band plan compiled from configuration %u (mode %s, every %d min, sunrise %02d:%02d sunset %02d:%02d UTC)",
+                configGeneration, cfg->mode, planner.interval(),
+                st.sunriseMin / 60, st.sunriseMin % 60, st.sunsetMin / 60, st.sunsetMin % 60);
+    }
+    planner.refill(unixTime);
+    k_mutex_unlock(&mutex);
+}
+
+bool SlotPlanner::take(int64_t slotUnix, BandPlanner::Slot& out) {
+    k_mutex_lock(&mutex, K_FOREVER);
+    bool ok = planner.take(slotUnix, out);
+    k_mutex_unlock(&mutex);
+    if (ok) {
+        logger.inf("slot", "Slot %lld: %s %u Hz, filter %u, %s %s", (long long)slotUnix,
+                BandTable::get(out.band).name, out.freqHz, out.lpf,
+                Modulation::get(out.mode).name, BandPlanner::messageName(out.message));
+    }
+    return ok;
+}
+
+Modulation::Mode SlotPlanner::txMode() const {
+    k_mutex_lock(&mutex, K_FOREVER);
+    Modulation::Mode m = planner.txMode();
+    k_mutex_unlock(&mutex);
+    return m;
+}
+
+int SlotPlanner::upcoming(BandPlanner::Slot* out, int max) const {
+    k_mutex_lock(&mutex, K_FOREVER);
+    int n = planner.upcoming(out, max);
+    k_mutex_unlock(&mutex);
+    return n;
+}
+
+void SlotPlanner::preselect(int64_t unixTime) {
+    BandPlanner::Slot next;
+    if (unixTime <= 0 || upcoming(&next, 1) == 0) return;
+
+    int64_t ahead = next.startUnix - unixTime;
+    if (ahead <= 0 || ahead > lpfLeadSec) return;
+
+    auto& fpga = FPGA::instance();
+    if (fpga.lpf() == next.lpf || fpga.isTransmitting()) return;
+    int ret = fpga.setLPF(next.lpf);
+    if (ret < 0) {
+        logger.wrn("lpf", "Filter %u for the slot in %lld s not selected: %d",
+                next.lpf, (long long)ahead, ret);
+    } else {
+        logger.dbg("lpf", "Filter %u selected %lld s before the slot", next.lpf, (long long)ahead);
+    }
+}
+
+MessageCache::Key SlotPlanner::messageKey(const BandPlanner::Slot& slot, const AppConfig& cfg) {
+    auto& gnss = GNSS::instance();
+    const char* grid = gnss.hasFix() ? gnss.gridLocator() : cfg.gridSquare;
+    return MessageCache::keyFor(slot.mode, slot.message, cfg.callsign, grid, cfg.powerDbm);
+}
+
+void SlotPlanner::prepareMessage(int64_t unixTime, const AppConfig& cfg) {
+    BandPlanner::Slot next;
+    if (unixTime <= 0 || upcoming(&next, 1) == 0) return;
+
+    MessageCache::Key key = messageKey(next, cfg);
+    auto& fpga = FPGA::instance();
+    k_mutex_lock(&mutex, K_FOREVER);
+    uint32_t misses = messages.stats().misses;
+    const uint8_t* symbols = messages.get(key);
+    bool encoded = messages.stats().misses != misses;
+    messages.tones(next.band, next.mode, next.freqHz, fpga.waveSteps(), FPGA::exciterClkHz);
+    k_mutex_unlock(&mutex);
+
+    // Retried every second until the configuration changes, reported once
+    bool failed = symbols == nullptr;
+    if (failed && !messageFailed) {
+        logger.err("message", "Cannot encode %s %s %s %d dBm", BandPlanner::messageName(key.type),
+                key.callsign, key.grid, key.powerDbm);
+    }
+    messageFailed = failed;
+    if (encoded && !failed) {
+        logger.inf("message", "Encoded %s %s %s %d dBm for the slot at %lld",
+                BandPlanner::messageName(key.type), key.callsign, key.grid, key.powerDbm,
+                (long long)next.startUnix);
+    }
+}
+
+bool SlotPlanner::message(const BandPlanner::Slot& slot, const AppConfig& cfg,
+                          uint8_t* symbols, uint32_t* toneWords) {
+    MessageCache::Key key = messageKey(slot, cfg);
+    auto& fpga = FPGA::instance();
+    k_mutex_lock(&mutex, K_FOREVER);
+    const uint8_t* s = messages.find(key);
+    if (!s) {
+        logger.wrn("message", "%s message not prepared, encoding at the slot",
+                BandPlanner::messageName(key.type));
+        s = messages.get(key);
+    }
+    const uint32_t* t = messages.tones(slot.band, slot.mode, slot.freqHz, fpga.waveSteps(), FPGA::exciterClkHz);
+    if (s && t) {
+        memcpy(symbols, s, Modulation::get(slot.mode).symbolCount);
+        memcpy(toneWords, t, Modulation::toneCount * sizeof(uint32_t));
+    }
+    k_mutex_unlock(&mutex);
+    return s && t;
+}
+
+MessageCache::Stats SlotPlanner::messageStats() const {
+    k_mutex_lock(&mutex, K_FOREVER);
+    MessageCache::Stats st = messages.stats();
+    k_mutex_unlock(&mutex);
+    return st;
+}
+
+int SlotPlanner::setLpfLead(int seconds) {
+    // The main loop looks once a second. A longer lead than the gap
+    // after the previous transmission just switches as that one ends.
+    if (seconds < 1 || seconds > maxLpfLeadSec) return -EINVAL;
+    lpfLeadSec = seconds;
+    return 0;
+}
+
+} // namespace wspr
@@ -0,0 +1,79 @@
+/*
+ * Slot Planner for WSPR-ease
+ * Keeps the band plan compiled from the current configuration and
+ * the next transmit slots planned, so the main loop only looks the
+ * slot up at the boundary
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <zephyr/kernel.h>
+
+#include "appConfig.hpp"
+#include "bandPlanner.hpp"
+#include "messageCache.hpp"
+#include "solarCalc.hpp"
+
+namespace wspr {
+
+class SlotPlanner {
+public:
+    static SlotPlanner& instance();
+
+    // Recompile after a configuration change, a new UTC day or a move
+    // to another location cell, and top up the plan. Call between slots
+    // with the current UTC time and the configuration in force since
+    // the last slot boundary.
+    void refresh(int64_t unixTime, const ConfigStore::Snapshot& cfg);
+
+    // The slot planned to start at slotUnix, if any
+    bool take(int64_t slotUnix, BandPlanner::Slot& out);
+
+    int upcoming(BandPlanner::Slot* out, int max) const;
+
+    // Mode of the compiled plan, which sets the slot period
+    Modulation::Mode txMode() const;
+
+    // Select the next slot's low-pass filter once the slot is within
+    // the lead time, while RF is off, so the switches have settled by
+    // the first symbol. Call between slots.
+    void preselect(int64_t unixTime);
+
+    // Encode the next slot's message and its band's tone words while
+    // the current slot transmits, so the boundary only looks them up.
+    // Call between slots, with the configuration refresh() was given.
+    void prepareMessage(int64_t unixTime, const AppConfig& cfg);
+
+    // Copy out what prepareMessage() made for a slot, encoding here
+    // only if it did not get to it. cfg is the configuration the slot
+    // was planned with. False if the message cannot be encoded.
+    bool message(const BandPlanner::Slot& slot, const AppConfig& cfg, uint8_t* symbols, uint32_t* toneWords);
+
+    MessageCache::Stats messageStats() const;
+
+    static const int maxLpfLeadSec = 50;
+    int setLpfLead(int seconds);
+    int lpfLead() const { return lpfLeadSec; }
+
+private:
+    SlotPlanner();
+
+    // Sun times at the GNSS position, or else the configured locator
+    BandPlanner::SunTimes sunTimes(int64_t unixTime, const char* grid);
+
+    // Callsign and power from the configuration, locator from GNSS
+    // when there is a fix
+    MessageCache::Key messageKey(const BandPlanner::Slot& slot, const AppConfig& cfg);
+
+    BandPlanner planner;
+    SolarCalc solar;
+    MessageCache messages;
+    bool messageFailed = false;
+    uint32_t configGeneration = 0;
+    BandPlanner::SunTimes sun;
+    int lpfLeadSec = 3;
+    mutable struct k_mutex mutex;
+};
+
+} // namespace wspr
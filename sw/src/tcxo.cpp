@@ -0,0 +1,237 @@
+/*
+ * TCXO Monitor Implementation for WSPR-ease
+ * Polls the FPGA PPS register and feeds the stamps to TcxoEstimator.
+ */
+
+#include "tcxo.hpp"
+
+#include <zephyr/kernel.h>
+
+#include <cmath>
+
+#include "fpga.hpp"
+#include "gnss.hpp"
+#include "nvstore.hpp"
+#include "flashScheduler.hpp"
+#include "logmanager.hpp"
+
+namespace wspr {
+
+// Register subsystem with LogManager
+static Logger& logger = LogManager::instance().registerSubsystem("tcxo",
+    {"init", "pps", "cal"});
+
+#define TCXO_STACK_SIZE 2048
+static K_THREAD_STACK_DEFINE(tcxoStack, TCXO_STACK_SIZE);
+
+// Four polls per second, so the uptime between readings always picks
+// out the number of PPS edges missed
+#define TCXO_POLL_MS 250
+
+// A measurement replaces the correction once it averages at least
+// this long and is this good (WSPR needs about 0.03 ppm at 10 m), and
+// is then followed in steps no smaller than applyStepPpm
+static const uint16_t applyMinSec = 10;
+static const double applyUncertaintyPpm = 0.02;
+static const double applyStepPpm = 0.002;
+
+TcxoMonitor& TcxoMonitor::instance() {
+    static TcxoMonitor inst;
+    return inst;
+}
+
+// PPS stamps are in half clk90 cycles, 28 bits, with a 4-bit gen
+TcxoMonitor::TcxoMonitor() : est(2.0 * FPGA::fpgaClkHz, 28, 4) {
+}
+
+const char* TcxoMonitor::sourceName(Source s) {
+    switch (s) {
+    case Source::Stored: return "stored";
+    case Source::Predicted: return "predicted";
+    case Source::Measured: return "measured";
+    default: return "none";
+    }
+}
+
+int TcxoMonitor::init() {
+    if (running) return 0;
+
+    k_mutex_init(&mutex);
+
+    auto& nvs = NVStore::instance();
+    TcxoCalibration::Record rec;
+    if (nvs.mount() == 0 &&
+        nvs.read(NVStore::TcxoCal, &rec, sizeof(rec)) == (ssize_t)sizeof(rec) &&
+        cal.load(rec)) {
+        logger.inf("cal", "Stored calibration %.4f ppm, aging %.5f ppm/day",
+                   rec.ppm, rec.ratePpmPerDay);
+        applyStored();
+    } else {
+        logger.inf("cal", "No stored calibration");
+    }
+
+    running = true;
+    k_thread_create(&threadData, tcxoStack, K_THREAD_STACK_SIZEOF(tcxoStack),
+                    threadFn, this, NULL, NULL,
+                    K_PRIO_PREEMPT(12), 0, K_NO_WAIT);
+    k_thread_name_set(&threadData, "tcxoMonitor");
+    logger.inf("init", "TCXO monitor started, %u s gate", est.gate());
+    return 0;
+}
+
+void TcxoMonitor::threadFn(void* p1, void* p2, void* p3) {
+    TcxoMonitor* inst = static_cast<TcxoMonitor*>(p1);
+    inst->processLoop();
+}
+
+void TcxoMonitor::processLoop() {
+    auto& fpga = FPGA::instance();
+    uint32_t lastRejected = 0;
+
+    uint32_t lastEdges = 0;
+
+    while (running) {
+        uint32_t stamp;
+        uint8_t gen;
+        if (!fpga.isInitialized() || fpga.getPPSStamp(&stamp, &gen) < 0) {
+            k_sleep(K_SECONDS(1));
+            continue;
+        }
+
+        // Without GNSS this is all the correction there will be
+        if (src == Source::None || src == Source::Stored) applyStored();
+
+        k_mutex_lock(&mutex, K_FOREVER);
+        est.addStamp(stamp, gen, k_uptime_get());
+        uint32_t rejected = est.stats().rejected;
+        uint32_t edges = est.stats().edges;
+        k_mutex_unlock(&mutex);
+
+        if (edges != lastEdges) {
+            refine();
+            lastEdges = edges;
+        }
+
+        if (rejected != lastRejected) {
+            logger.wrn("pps", "PPS interval rejected as an outlier (%u total)", rejected);
+            lastRejected = rejected;
+        }
+
+        k_msleep(TCXO_POLL_MS);
+    }
+}
+
+// Stored error, aged to now when GNSS has the time
+void TcxoMonitor::applyStored() {
+    if (!cal.valid() || FPGA::instance().isTransmitting()) return;
+
+    int64_t now = GNSS::instance().unixTime();
+    if (now > 0) {
+        applyCorrection(cal.predict(now), Source::Predicted);
+    } else if (src == Source::None) {
+        applyCorrection(cal.predict(0), Source::Stored);
+    }
+}
+
+// Follow the measured error, and save it when it has moved or the
+// aging baseline is due. Both wait for the gap between transmissions.
+void TcxoMonitor::refine() {
+    if (FPGA::instance().isTransmitting()) return;
+
+    auto e = estimate();
+    if (!e.valid || e.tauSec < applyMinSec || e.uncertaintyPpm > applyUncertaintyPpm) return;
+
+    if (src != Source::Measured || fabs(e.ppm - appliedPpm) >= applyStepPpm) {
+        applyCorrection(e.ppm, Source::Measured);
+    }
+
+    int64_t now = GNSS::instance().unixTime();
+    k_mutex_lock(&mutex, K_FOREVER);
+    bool due = cal.update(e.ppm, now);
+    auto rec = cal.record();
+    k_mutex_unlock(&mutex);
+
+    if (due) {
+        if (FlashScheduler::instance().writeRecord(NVStore::TcxoCal, &rec, sizeof(rec)) >= 0) {
+            logger.inf("cal", "Saved calibration %.4f ppm, aging %.5f ppm/day",
+                       rec.ppm, rec.ratePpmPerDay);
+        }
+    }
+}
+
+void TcxoMonitor::applyCorrection(double ppm, Source s) {
+    int ret = FPGA::instance().setFrequencyCorrection(ppm);
+    if (ret < 0) {
+        logger.err("cal", "Failed to apply %.4f ppm correction: %d", ppm, ret);
+        return;
+    }
+    if (s != src) logger.inf("cal", "Correction %.4f ppm (%s)", ppm, sourceName(s));
+    k_mutex_lock(&mutex, K_FOREVER);
+    appliedPpm = ppm;
+    src = s;
+    k_mutex_unlock(&mutex);
+}
+
+TcxoMonitor::Source TcxoMonitor::source() const {
+    k_mutex_lock(&mutex, K_FOREVER);
+    Source s = src;
+    k_mutex_unlock(&mutex);
+    return s;
+}
+
+double TcxoMonitor::correctionPpm() const {
+    k_mutex_lock(&mutex, K_FOREVER);
+    double ppm = appliedPpm;
+    k_mutex_unlock(&mutex);
+    return ppm;
+}
+
+TcxoCalibration TcxoMonitor::calibration() const {
+    k_mutex_lock(&mutex, K_FOREVER);
+    TcxoCalibration c = cal;
+    k_mutex_unlock(&mutex);
+    return c;
+}
+
+TcxoEstimator::Estimate TcxoMonitor::estimate() const {
+    k_mutex_lock(&mutex, K_FOREVER);
+    auto e = est.estimate();
+    k_mutex_unlock(&mutex);
+    return e;
+}
+
+int TcxoMonitor::adevTable(TcxoEstimator::AdevPoint* out, int maxOut) const {
+    k_mutex_lock(&mutex, K_FOREVER);
+    int n = est.adevTable(out, maxOut);
+    k_mutex_unlock(&mutex);
+    return n;
+}
+
+TcxoEstimator::Stats TcxoMonitor::stats() const {
+    k_mutex_lock(&mutex, K_FOREVER);
+    auto s = est.stats();
+    k_mutex_unlock(&mutex);
+    return s;
+}
+
+int TcxoMonitor::setGate(uint16_t seconds) {
+    k_mutex_lock(&mutex, K_FOREVER);
+    int ret = est.setGate(seconds);
+    k_mutex_unlock(&mutex);
+    return ret;
+}
+
+uint16_t TcxoMonitor::gate() const {
+    k_mutex_lock(&mutex, K_FOREVER);
+    uint16_t g = est.gate();
+    k_mutex_unlock(&mutex);
+    return g;
+}
+
+void TcxoMonitor::reset() {
+    k_mutex_lock(&mutex, K_FOREVER);
+    est.reset();
+    k_mutex_unlock(&mutex);
+}
+
+} // namespace wspr
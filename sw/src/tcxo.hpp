@@ -0,0 +1,59 @@
+/*
+ * TCXO Monitor for WSPR-ease
+ * Background long-gate estimate of the reference oscillator error
+ * against GNSS PPS
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <zephyr/kernel.h>
+
+#include "tcxoEstimator.hpp"
+#include "tcxoCalibration.hpp"
+
+namespace wspr {
+
+class TcxoMonitor {
+public:
+    static TcxoMonitor& instance();
+
+    // Applies the stored calibration (aged to the GNSS time once there
+    // is one) and then keeps the FPGA correction at the measured error
+    int init();
+
+    // Where the correction now in the FPGA came from
+    enum class Source : uint8_t { None, Stored, Predicted, Measured };
+    static const char* sourceName(Source s);
+
+    // Snapshots of the monitor and estimator, safe from any thread
+    Source source() const;
+    double correctionPpm() const;
+    TcxoCalibration calibration() const;
+    TcxoEstimator::Estimate estimate() const;
+    int adevTable(TcxoEstimator::AdevPoint* out, int maxOut) const;
+    TcxoEstimator::Stats stats() const;
+
+    int setGate(uint16_t seconds);
+    uint16_t gate() const;
+    void reset();
+
+private:
+    TcxoMonitor();
+
+    void processLoop();
+    void applyStored();
+    void refine();
+    void applyCorrection(double ppm, Source s);
+    static void threadFn(void* p1, void* p2, void* p3);
+    struct k_thread threadData;
+    bool running = false;
+
+    TcxoEstimator est;
+    TcxoCalibration cal;
+    Source src = Source::None;
+    double appliedPpm = 0.0;
+    mutable struct k_mutex mutex;
+};
+
+} // namespace wspr
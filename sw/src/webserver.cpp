@@ -1,14 +1,21 @@
 /*
  * HTTP Web Server Implementation for WSPR-ease
- * Simple socket-based server for maximum portability
+ * Simple socket-based server for maximum portability. One thread polls
+ * the listening socket and a fixed table of connections, each a small
+ * state machine, so a slow client holds up nobody else. Connections
+ * are kept alive between requests, framed by Content-Length.
  */
 
 #include "webserver.hpp"
 #include "wifiManager.hpp"
 #include "gnss.hpp"
 #include "fpga.hpp"
-#include "band.hpp"
+#include "tcxo.hpp"
+#include "slotPlanner.hpp"
+#include "bandTable.hpp"
 #include "filesystem.hpp"
+#include "appConfig.hpp"
+#include "flashScheduler.hpp"
 #include "logmanager.hpp"
 
 #include <zephyr/kernel.h>
@@ -18,13 +25,11 @@
 #include <zephyr/posix/unistd.h>
 #include <zephyr/fs/fs.h>
 #include <zephyr/fs/littlefs.h>
-#include <zephyr/storage/flash_map.h>
-#include <zephyr/drivers/flash.h>
-#include <zephyr/fs/nvs.h>
 
 #include <cstring>
 #include <cstdio>
 #include <cstdlib>
+#include <cctype>
 
 LOG_MODULE_REGISTER(webserver, LOG_LEVEL_INF);
 
@@ -43,6 +48,12 @@ static Logger& logger = LogManager::instance().registerSubsystem("web",
 #define MAX_REQUEST_SIZE 4096
 #define MAX_RESPONSE_SIZE 4096
 #define SERVER_STACK_SIZE 16384
+#define MAX_CONNECTIONS 4
+#define POLL_INTERVAL_MS 250
+#define READ_TIMEOUT_MS 2000	// No request bytes for this long
+#define KEEPALIVE_IDLE_MS 5000	// Between requests; above the UI's 2 s poll
+#define MAX_REQUESTS_PER_CONNECTION 100
+#define WRITE_TIMEOUT_MS 10000	// Response not drained for this long
 
 static k_thread_stack_t *serverStackPtr = nullptr;
 static struct k_thread serverThread;
@@ -50,15 +61,31 @@ static struct k_thread serverThread;
 static int serverSock = -1;
 static bool serverRunning = false;
 
-// Request buffer will be dynamically allocated
-static char *reqBufPtr = nullptr;
+// One client. Reading collects a request until its headers and
+// Content-Length bytes of body are in; it is then handled in one go and
+// Writing drains the response, refilled from an open file for
+// downloads, as fast as the client takes it.
+struct Connection {
+    enum class State : uint8_t { Free, Reading, Writing };
+    State state = State::Free;
+    int sock = -1;
+    int64_t lastActivity = 0;	// k_uptime_get()
+    char* rx = nullptr;		// MAX_REQUEST_SIZE, NUL-terminated
+    size_t rxLen = 0;
+    size_t requestLen = 0;	// Of the request at rx being answered
+    uint16_t requests = 0;	// Answered and being answered
+    bool keepAlive = false;	// For the response being written
+    char* tx = nullptr;		// MAX_RESPONSE_SIZE
+    size_t txLen = 0;
+    size_t txSent = 0;
+    bool streaming = false;	// file holds more of the body
+    struct fs_file_t file;
+};
 
-static struct nvs_fs fs;
-#define CONFIG_NVS_ID 1
+static Connection connections[MAX_CONNECTIONS];
 
-// Forward declarations
-static void loadConfigFromNVS();
-static void saveConfigToNVS();
+// rx and tx of every connection, dynamically allocated
+static char *connBufPtr = nullptr;
 
 // Get content type from file extension
 static const char* getContentType(const char* path) {
@@ -78,41 +105,91 @@ static const char* getContentType(const char* path) {
     return "application/octet-stream";
 }
 
+// The Connection header lines of a response
+static int connectionHeader(const Connection& conn, char* buf, size_t size) {
+    if (!conn.keepAlive) return snprintf(buf, size, "Connection: close\r\n");
+    return snprintf(buf, size, "Connection: keep-alive\r\nKeep-Alive: timeout=%d, max=%d\r\n",
+                    KEEPALIVE_IDLE_MS / 1000, MAX_REQUESTS_PER_CONNECTION - conn.requests);
+}
+
+// Queue bytes of the response; false when they do not fit
+static bool queue(Connection& conn, const char* data, size_t len) {
+    if (len > MAX_RESPONSE_SIZE - conn.txLen) return false;
+    memcpy(conn.tx + conn.txLen, data, len);
+    conn.txLen += len;
+    return true;
+}
+
 // Simple HTTP response helpers
-static void sendResponse(int clientSock, int st,
+static void sendResponse(Connection& conn, int st,
                          const char* contentType,
                          const char* body, size_t bodyLen) {
     char header[256];
+    char connHeader[80];
+    connectionHeader(conn, connHeader, sizeof(connHeader));
     const char* statusText = (st == 200) ? "OK" :
+                              (st == 400) ? "Bad Request" :
                               (st == 404) ? "Not Found" :
+                              (st == 405) ? "Method Not Allowed" :
+                              (st == 413) ? "Payload Too Large" :
                               (st == 500) ? "Internal Server Error" : "Error";
 
     int headerLen = snprintf(header, sizeof(header),
         "HTTP/1.1 %d %s\r\n"
         "Content-Type: %s\r\n"
         "Content-Length: %zu\r\n"
-        "Connection: close\r\n"
+        "%s"
         "Access-Control-Allow-Origin: *\r\n"
         "\r\n",
-        st, statusText, contentType, bodyLen);
+        st, statusText, contentType, bodyLen, connHeader);
 
-    zsock_send(clientSock, header, headerLen, 0);
+    if (headerLen + bodyLen > MAX_RESPONSE_SIZE) {
+        logger.err("api", "Response of %zu bytes does not fit", bodyLen);
+        sendResponse(conn, 500, "text/plain", "Too Large", 9);
+        return;
+    }
+    queue(conn, header, headerLen);
     if (body && bodyLen > 0) {
-        zsock_send(clientSock, body, bodyLen, 0);
+        queue(conn, body, bodyLen);
     }
 }
 
-static void sendJSON(int clientSock, const char* json) {
-    sendResponse(clientSock, 200, "application/json", json, strlen(json));
+static void sendJSON(Connection& conn, const char* json) {
+    sendResponse(conn, 200, "application/json", json, strlen(json));
 }
 
 // API handler: GET /api/status
-static void handleAPIStatus(int clientSock) {
+static void handleAPIStatus(Connection& conn) {
     auto& wifi = WifiManager::instance();
     auto& gnss = GNSS::instance();
     auto& fpga = FPGA::instance();
+    auto& tcxo = TcxoMonitor::instance();
+
+    auto est = tcxo.estimate();
+    TcxoEstimator::AdevPoint table[TcxoEstimator::nTableGates];
+    int nAdev = tcxo.adevTable(table, TcxoEstimator::nTableGates);
+    char adev[TcxoEstimator::nTableGates * 56 + 2];
+    size_t pos = 0;
+    for (int i = 0; i < nAdev && pos < sizeof(adev); i++) {
+        pos += snprintf(adev + pos, sizeof(adev) - pos, "%s{\"tau\":%u,\"pairs\":%u,\"adev\":%.3e}",
+                        i ? "," : "", table[i].tauSec, table[i].pairs, table[i].adevPpm);
+    }
+    if (nAdev == 0) adev[0] = '\0';
+
+    BandPlanner::Slot slots[BandPlanner::maxPlan];
+    int nSlots = SlotPlanner::instance().upcoming(slots, BandPlanner::maxPlan);
+    char plan[BandPlanner::maxPlan * 128 + 2];
+    pos = 0;
+    for (int i = 0; i < nSlots && pos < sizeof(plan); i++) {
+        pos += snprintf(plan + pos, sizeof(plan) - pos,
+                        "%s{\"start\":%lld,\"band\":\"%s\",\"freqHz\":%u,\"lpf\":%u,\"mode\":\"%s\",\"message\":\"%s\"}",
+                        i ? "," : "", (long long)slots[i].startUnix, BandTable::get(slots[i].band).name,
+                        slots[i].freqHz, slots[i].lpf, Modulation::get(slots[i].mode).name,
+                        BandPlanner::messageName(slots[i].message));
+    }
+    if (nSlots == 0) plan[0] = '\0';
 
-    char buf[600];
+    char buf[2048];
     snprintf(buf, sizeof(buf),
         "{"
         "\"wifi\":{"
@@ -137,6 +214,17 @@ static void handleAPIStatus(int clientSock) {
             "\"transmitting\":%s,"
             "\"frequency\":%u"
         "},"
+        "\"tcxo\":{"
+            "\"valid\":%s,"
+            "\"ppm\":%.5f,"
+            "\"uncertaintyPpm\":%.5f,"
+            "\"tauSec\":%u,"
+            "\"gateSec\":%u,"
+            "\"correctionPpm\":%.5f,"
+            "\"source\":\"%s\","
+            "\"adev\":[%s]"
+        "},"
+        "\"plan\":[%s],"
         "\"uptime\":%lld"
         "}",
         wifi.isConnected() ? "true" : "false",
@@ -155,127 +243,71 @@ static void handleAPIStatus(int clientSock) {
         fpga.isInitialized() ? "true" : "false",
         fpga.isTransmitting() ? "true" : "false",
         fpga.frequency(),
+        est.valid ? "true" : "false",
+        est.ppm,
+        est.uncertaintyPpm,
+        est.tauSec,
+        tcxo.gate(),
+        tcxo.correctionPpm(),
+        TcxoMonitor::sourceName(tcxo.source()),
+        adev,
+        plan,
         k_uptime_get() / 1000
     );
 
-    sendJSON(clientSock, buf);
+    sendJSON(conn, buf);
 }
 
 // API handler: GET /api/version
-static void handleAPIVersion(int clientSock) {
+static void handleAPIVersion(Connection& conn) {
     char buf[64];
     snprintf(buf, sizeof(buf), "{\"version\":\"%s\"}", APP_VERSION);
-    sendJSON(clientSock, buf);
-}
-
-// Application configuration state (persisted to flash)
-struct AppConfig {
-    char callsign[16] = "N0CALL";
-    char gridSquare[8] = "AA00";
-    int powerDbm = 23;
-    char mode[16] = "round-robin";
-    int slotIntervalMin = 10;
-    char bandList[128] = "";
-    bool bandEnabled[10] = {false, false, false, false, true, false, false, false, false, false};
-};
-
-static AppConfig appConfig;
-
-// Load configuration from NVS
-static void loadConfigFromNVS() {
-    const struct flash_area *fa;
-    int rc;
-
-    logger.inf("init", "Loading configuration from NVS...");
-
-    rc = flash_area_open(FIXED_PARTITION_ID(storage_partition), &fa);
-    if (rc) {
-        logger.err("init", "Flash area open failed: %d (check app.overlay partitions)", rc);
-        return;
-    }
-
-    fs.flash_device = fa->fa_dev;
-    fs.offset = fa->fa_off;
-    struct flash_pages_info info;
-    rc = flash_get_page_info_by_offs(fa->fa_dev, fs.offset, &info);
-    if (rc) {
-        logger.err("init", "Flash get page info failed: %d at offset 0x%lx", rc, (long)fs.offset);
-        flash_area_close(fa);
-        return;
-    }
-
-    fs.sector_size = info.size;
-    fs.sector_count = fa->fa_size / info.size;
-
-    logger.inf("init", "NVS init: dev=%p, off=0x%lx, sec_sz=%u, sec_cnt=%u",
-            fs.flash_device, (long)fs.offset, fs.sector_size, fs.sector_count);
-
-    rc = nvs_mount(&fs);
-    if (rc) {
-        logger.err("init", "NVS mount failed: %d", rc);
-        flash_area_close(fa);
-        return;
-    }
-
-    rc = nvs_read(&fs, CONFIG_NVS_ID, &appConfig, sizeof(appConfig));
-    if (rc == sizeof(appConfig)) {
-        logger.inf("init", "Configuration loaded from flash: Callsign=%s Grid=%s", 
-                appConfig.callsign, appConfig.gridSquare);
-    } else if (rc < 0) {
-        logger.wrn("init", "NVS read error: %d (expected %zu), using defaults", rc, sizeof(appConfig));
-    } else {
-        logger.inf("init", "No valid configuration found in flash (read %d, expected %zu), using defaults", 
-                rc, sizeof(appConfig));
-    }
-    
-    flash_area_close(fa);
-}
-
-// Save configuration to NVS
-static void saveConfigToNVS() {
-    logger.inf("config", "Saving configuration to NVS (%zu bytes)...", sizeof(appConfig));
-    int rc = nvs_write(&fs, CONFIG_NVS_ID, &appConfig, sizeof(appConfig));
-    if (rc < 0) {
-        logger.err("config", "Failed to save config to NVS: %d", rc);
-    } else if (rc == 0) {
-        logger.inf("config", "Configuration already up to date in NVS");
-    } else {
-        logger.inf("config", "Configuration saved to flash (%d bytes)", rc);
-    }
+    sendJSON(conn, buf);
 }
 
 // API handler: GET /api/config
-static void handleAPIConfigGet(int clientSock) {
+static void handleAPIConfigGet(Connection& conn) {
+    ConfigStore::Snapshot snap = ConfigStore::instance().current();
+    const AppConfig& appConfig = *snap;
+    char buf[2048];
     int pos = 0;
 
-    pos += snprintf(reqBufPtr + pos, MAX_REQUEST_SIZE - pos,
+    pos += snprintf(buf + pos, sizeof(buf) - pos,
         "{"
         "\"callsign\":\"%s\","
         "\"gridSquare\":\"%s\","
         "\"powerDbm\":%d,"
         "\"mode\":\"%s\","
         "\"slotIntervalMin\":%d,"
+        "\"txMode\":\"%s\","
         "\"bandList\":\"%s\","
         "\"bands\":[",
         appConfig.callsign, appConfig.gridSquare, appConfig.powerDbm,
-        appConfig.mode, appConfig.slotIntervalMin, appConfig.bandList
+        appConfig.mode, appConfig.slotIntervalMin, appConfig.txMode, appConfig.bandList
     );
 
-    Band &bands{Band::get()};
-
-    for (int i = 0; i < bands.nBands; i++) {
-        pos += snprintf(reqBufPtr + pos, MAX_REQUEST_SIZE - pos,
+    for (int i = 0; i < BandTable::count; i++) {
+        const BandTable::Entry& band = BandTable::get(i);
+        pos += snprintf(buf + pos, sizeof(buf) - pos,
             "{\"name\":\"%s\",\"freqHz\":%u,\"enabled\":%s}%s",
-            bands.metadata[i].name, bands.metadata[i].hz,
+            band.name, (unsigned)band.dialHz,
             appConfig.bandEnabled[i] ? "true" : "false",
-            (i < bands.nBands - 1) ? "," : ""
+            (i < BandTable::count - 1) ? "," : ""
         );
     }
 
-    pos += snprintf(reqBufPtr + pos, MAX_REQUEST_SIZE - pos, "]}");
+    // The modes this build can send, for the UI to offer
+    pos += snprintf(buf + pos, sizeof(buf) - pos, "],\"txModes\":[");
+    const char* sep = "";
+    for (int i = 0; i < Modulation::modeCount; i++) {
+        pos += snprintf(buf + pos, sizeof(buf) - pos, "%s\"%s\"", sep,
+                        Modulation::get((Modulation::Mode)i).name);
+        sep = ",";
+    }
+    pos += snprintf(buf + pos, sizeof(buf) - pos, "]}");
 
     logger.inf("api", "Sending config JSON (%d bytes)", pos);
-    sendJSON(clientSock, reqBufPtr);
+    sendJSON(conn, buf);
 }
 
 // Simple JSON field extractor (helper for PUT handler)
@@ -313,8 +345,8 @@ static bool getJSONInt(const char* json, const char* key, int* out) {
 }
 
 // API handler: PUT /api/config
-static void handleAPIConfigPut(int clientSock, const char* body) {
-    logger.inf("config", "Saving configuration update. Body len: %zu", strlen(body));
+static void handleAPIConfigPut(Connection& conn, const char* body) {
+    logger.inf("config", "Applying configuration update. Body len: %zu", strlen(body));
     
     if (strlen(body) > 0) {
         char dbgBody[64];
@@ -322,45 +354,57 @@ static void handleAPIConfigPut(int clientSock, const char* body) {
         logger.inf("config", "Body start: %s...", dbgBody);
     }
 
+    AppConfig appConfig = ConfigStore::instance().get();
     getJSONString(body, "callsign", appConfig.callsign, sizeof(appConfig.callsign));
     getJSONString(body, "gridSquare", appConfig.gridSquare, sizeof(appConfig.gridSquare));
     getJSONInt(body, "powerDbm", &appConfig.powerDbm);
     getJSONString(body, "mode", appConfig.mode, sizeof(appConfig.mode));
     getJSONInt(body, "slotIntervalMin", &appConfig.slotIntervalMin);
+    char txMode[sizeof(appConfig.txMode)];
+    if (getJSONString(body, "txMode", txMode, sizeof(txMode))) {
+        // Refused rather than planned as WSPR-2 behind the user's back
+        Modulation::Mode m;
+        if (!Modulation::fromName(txMode, m)) {
+            logger.wrn("config", "Transmit mode '%s' not available", txMode);
+            sendResponse(conn, 400, "text/plain", "Unsupported txMode", 18);
+            return;
+        }
+        strcpy(appConfig.txMode, txMode);
+    }
     getJSONString(body, "bandList", appConfig.bandList, sizeof(appConfig.bandList));
 
-    Band &bands{Band::get()};
+    // Each {"name":"20m",...,"enabled":true} in turn, by name
     const char* bandsStart = strstr(body, "\"bands\":[");
-    if (bandsStart) {
-        for (int i = 0; i < bands.nBands; i++) {
-            char bandSearch[64];
-            snprintf(bandSearch, sizeof(bandSearch), "\"name\":\"%s\"", bands.metadata[i].name);
-            const char* bandP = strstr(bandsStart, bandSearch);
-            if (bandP) {
-                const char* enabledP = strstr(bandP, "\"enabled\":");
-                if (enabledP) {
-                    const char* valP = enabledP + 10;
-                    while (*valP == ' ' || *valP == ':') valP++;
-                    appConfig.bandEnabled[i] = (strncmp(valP, "true", 4) == 0);
-                }
-            }
+    const char* bandP = bandsStart;
+    while (bandP && (bandP = strstr(bandP, "\"name\":\"")) != nullptr) {
+        bandP += 8;
+        char name[8];
+        snprintf(name, sizeof(name), "%.*s", (int)strcspn(bandP, "\""), bandP);
+        int i = BandTable::fromName(name);
+        const char* end = strchr(bandP, '}');
+        const char* enabledP = strstr(bandP, "\"enabled\":");
+        if (i >= 0 && enabledP && (!end || enabledP < end)) {
+            const char* valP = enabledP + 10;
+            while (*valP == ' ' || *valP == ':') valP++;
+            appConfig.bandEnabled[i] = (strncmp(valP, "true", 4) == 0);
         }
     }
 
-    saveConfigToNVS();
-    sendJSON(clientSock, "{\"status\":\"ok\"}");
+    // Applied now, written to flash once the edits settle
+    ConfigStore::instance().update(appConfig);
+    sendJSON(conn, "{\"status\":\"ok\"}");
 }
 
 // API handler: POST /api/tx/trigger
-static void handleAPITXTrigger(int clientSock) {
+static void handleAPITXTrigger(Connection& conn) {
     logger.inf("api", "Manual TX trigger requested");
-    sendJSON(clientSock, "{\"message\":\"TX triggered (stub)\"}");
+    sendJSON(conn, "{\"message\":\"TX triggered (stub)\"}");
 }
 
 // API handler: GET /api/files?path=/
-static void handleAPIFilesList(int clientSock) {
+static void handleAPIFilesList(Connection& conn) {
     if (!FileSystem::instance().isMounted()) {
-        sendJSON(clientSock, "{\"files\":[]}");
+        sendJSON(conn, "{\"files\":[]}");
         return;
     }
 
@@ -386,81 +430,95 @@ static void handleAPIFilesList(int clientSock) {
     }
 
     pos += snprintf(buf + pos, sizeof(buf) - pos, "]}");
-    sendJSON(clientSock, buf);
+    sendJSON(conn, buf);
 }
 
 // API handler: GET /api/files/{filename}
-static void handleAPIFileGet(int clientSock, const char* filename) {
+static void handleAPIFileGet(Connection& conn, const char* filename) {
     char fullPath[256];
     snprintf(fullPath, sizeof(fullPath), "%s/%s", FileSystem::instance().getMountPoint(), filename);
 
-    struct fs_file_t file;
-    fs_file_t_init(&file);
+    fs_file_t_init(&conn.file);
 
-    if (fs_open(&file, fullPath, FS_O_READ) < 0) {
-        sendResponse(clientSock, 404, "text/plain", "Not Found", 9);
+    if (fs_open(&conn.file, fullPath, FS_O_READ) < 0) {
+        sendResponse(conn, 404, "text/plain", "Not Found", 9);
         return;
     }
 
     struct fs_dirent stat;
     if (fs_stat(fullPath, &stat) < 0) {
-        fs_close(&file);
-        sendResponse(clientSock, 500, "text/plain", "Stat Error", 10);
+        fs_close(&conn.file);
+        sendResponse(conn, 500, "text/plain", "Stat Error", 10);
         return;
     }
 
     char header[256];
+    char connHeader[80];
+    connectionHeader(conn, connHeader, sizeof(connHeader));
     int headerLen = snprintf(header, sizeof(header),
         "HTTP/1.1 200 OK\r\n"
         "Content-Type: application/octet-stream\r\n"
         "Content-Length: %zu\r\n"
         "Content-Disposition: attachment; filename=\"%s\"\r\n"
-        "Connection: close\r\n"
+        "%s"
         "\r\n",
-        (size_t)stat.size, filename);
+        (size_t)stat.size, filename, connHeader);
 
-    zsock_send(clientSock, header, headerLen, 0);
+    // The body follows from the file as the client takes it
+    queue(conn, header, headerLen);
+    conn.streaming = true;
+}
 
-    ssize_t bytesRead;
-    while ((bytesRead = fs_read(&file, reqBufPtr, MAX_REQUEST_SIZE)) > 0) {
-        zsock_send(clientSock, reqBufPtr, bytesRead, 0);
-    }
+// Static serving prefers path.gz: once path is written or deleted the
+// gzip copy is stale, so it goes too, ahead of the change itself
+static void removeGzipCopy(const char* fullPath) {
+    char gzPath[256 + 3];
+    snprintf(gzPath, sizeof(gzPath), "%s.gz", fullPath);
 
-    fs_close(&file);
+    struct fs_dirent stat;
+    if (fs_stat(gzPath, &stat) < 0) return;
+    int rc = FlashScheduler::instance().deleteFile(gzPath);
+    if (rc < 0) {
+        logger.wrn("api", "Stale gzip copy %s not removed: %d", gzPath, rc);
+    }
 }
 
 // API handler: PUT /api/files/{filename}
-static void handleAPIFilePut(int clientSock, const char* filename, const char* body, size_t bodyLen) {
+static void handleAPIFilePut(Connection& conn, const char* filename, const char* body, size_t bodyLen) {
     char fullPath[256];
     snprintf(fullPath, sizeof(fullPath), "%s/%s", FileSystem::instance().getMountPoint(), filename);
 
-    struct fs_file_t file;
-    fs_file_t_init(&file);
-
-    if (fs_open(&file, fullPath, FS_O_CREATE | FS_O_WRITE) < 0) {
-        sendResponse(clientSock, 500, "text/plain", "Create Error", 12);
+    removeGzipCopy(fullPath);
+    int rc = FlashScheduler::instance().writeFile(fullPath, body, bodyLen);
+    if (rc < 0) {
+        sendResponse(conn, 500, "text/plain", "Create Error", 12);
         return;
     }
 
-    fs_write(&file, body, bodyLen);
-    fs_close(&file);
+    if (rc == FlashScheduler::queued) {
+        logger.inf("api", "File write deferred until after TX: %s (%zu bytes)", filename, bodyLen);
+        sendJSON(conn, "{\"status\":\"queued\"}");
+        return;
+    }
 
     logger.inf("api", "File written: %s (%zu bytes)", filename, bodyLen);
-    sendJSON(clientSock, "{\"status\":\"ok\"}");
+    sendJSON(conn, "{\"status\":\"ok\"}");
 }
 
 // API handler: DELETE /api/files/{filename}
-static void handleAPIFileDelete(int clientSock, const char* filename) {
+static void handleAPIFileDelete(Connection& conn, const char* filename) {
     char fullPath[256];
     snprintf(fullPath, sizeof(fullPath), "%s/%s", FileSystem::instance().getMountPoint(), filename);
 
-    if (fs_unlink(fullPath) < 0) {
-        sendResponse(clientSock, 404, "text/plain", "Not Found", 9);
+    removeGzipCopy(fullPath);
+    int rc = FlashScheduler::instance().deleteFile(fullPath);
+    if (rc < 0) {
+        sendResponse(conn, 404, "text/plain", "Not Found", 9);
         return;
     }
 
-    logger.inf("api", "File deleted: %s", filename);
-    sendJSON(clientSock, "{\"status\":\"ok\"}");
+    logger.inf("api", "File %s: %s", rc == FlashScheduler::queued ? "delete deferred" : "deleted", filename);
+    sendJSON(conn, rc == FlashScheduler::queued ? "{\"status\":\"queued\"}" : "{\"status\":\"ok\"}");
 }
 
 // Fallback HTML
@@ -487,10 +545,11 @@ static const char* fallbackHtml =
     "</ul>"
     "</body></html>";
 
-// Serve static files from LittleFS
-static void handleStatic(int clientSock, const char* path) {
+// Serve static files from LittleFS, the gzip copy flash-lfs.sh stores
+// beside a file when the client takes it
+static void handleStatic(Connection& conn, const char* path, bool gzip) {
     if (!FileSystem::instance().isMounted()) {
-        sendResponse(clientSock, 200, "text/html", fallbackHtml, strlen(fallbackHtml));
+        sendResponse(conn, 200, "text/html", fallbackHtml, strlen(fallbackHtml));
         return;
     }
 
@@ -502,61 +561,50 @@ static void handleStatic(int clientSock, const char* path) {
         snprintf(fullPath, sizeof(fullPath), "%s%s", mountPoint, path);
     }
 
-    struct fs_file_t file;
-    fs_file_t_init(&file);
+    char gzPath[sizeof(fullPath) + 3];
+    snprintf(gzPath, sizeof(gzPath), "%s.gz", fullPath);
+    const char* openPath = fullPath;
 
-    int ret = fs_open(&file, fullPath, FS_O_READ);
+    fs_file_t_init(&conn.file);
+
+    int ret = -ENOENT;
+    if (gzip) {
+        ret = fs_open(&conn.file, gzPath, FS_O_READ);
+        if (ret == 0) openPath = gzPath;
+    }
+    if (ret < 0) ret = fs_open(&conn.file, fullPath, FS_O_READ);
     if (ret < 0) {
         logger.inf("static", "static GET: '%s'", fullPath);
-        sendResponse(clientSock, 404, "text/plain", "Not Found", 9);
+        sendResponse(conn, 404, "text/plain", "Not Found", 9);
         return;
     }
 
     struct fs_dirent stat;
-    ret = fs_stat(fullPath, &stat);
+    ret = fs_stat(openPath, &stat);
     if (ret < 0) {
-        fs_close(&file);
-        sendResponse(clientSock, 500, "text/plain", "Stat Error", 10);
+        fs_close(&conn.file);
+        sendResponse(conn, 500, "text/plain", "Stat Error", 10);
         return;
     }
 
     const char* contentType = getContentType(fullPath);
     char header[256];
+    char connHeader[80];
+    connectionHeader(conn, connHeader, sizeof(connHeader));
     int headerLen = snprintf(header, sizeof(header),
         "HTTP/1.1 200 OK\r\n"
         "Content-Type: %s\r\n"
+        "%s"
         "Content-Length: %zu\r\n"
-        "Connection: close\r\n"
+        "%s"
         "Cache-Control: max-age=3600\r\n"
+        "Vary: Accept-Encoding\r\n"
         "\r\n",
-        contentType, (size_t)stat.size);
-
-    ssize_t sent = 0;
-    while (sent < headerLen) {
-        ssize_t n = zsock_send(clientSock, header + sent, headerLen - sent, 0);
-        if (n <= 0) {
-            logger.err("static", "Failed to send header");
-            fs_close(&file);
-            return;
-        }
-        sent += n;
-    }
-
-    ssize_t bytesRead;
-    while ((bytesRead = fs_read(&file, reqBufPtr, MAX_REQUEST_SIZE)) > 0) {
-        ssize_t chunkSent = 0;
-        while (chunkSent < bytesRead) {
-            ssize_t n = zsock_send(clientSock, (uint8_t*)reqBufPtr + chunkSent,
-                                   bytesRead - chunkSent, 0);
-            if (n <= 0) {
-                fs_close(&file);
-                return;
-            }
-            chunkSent += n;
-        }
-    }
+        contentType, openPath == gzPath ? "Content-Encoding: gzip\r\n" : "",
+        (size_t)stat.size, connHeader);
 
-    fs_close(&file);
+    queue(conn, header, headerLen);
+    conn.streaming = true;
 }
 
 // Find HTTP body start
@@ -568,93 +616,324 @@ static const char* findBody(const char* request) {
     return nullptr;
 }
 
+// Value of a request header, found case-insensitively between the
+// request line and the blank line; nullptr when absent
+static const char* findHeader(const char* request, const char* end, const char* name) {
+    size_t n = strlen(name);
+    for (const char* line = strchr(request, '\n'); line && line < end; line = strchr(line, '\n')) {
+        line++;
+        size_t i = 0;
+        while (i < n && line + i < end && tolower((unsigned char)line[i]) == tolower((unsigned char)name[i])) i++;
+        if (i == n && line[n] == ':') {
+            const char* v = line + n + 1;
+            while (*v == ' ' || *v == '\t') v++;
+            return v;
+        }
+    }
+    return nullptr;
+}
+
+static bool valueIs(const char* value, const char* token) {
+    size_t n = strlen(token);
+    for (size_t i = 0; i < n; i++) {
+        if (tolower((unsigned char)value[i]) != token[i]) return false;
+    }
+    char c = value[n];
+    return c == '\r' || c == '\n' || c == ',' || c == ';' || c == ' ' || c == '\0';
+}
+
+// Whether Accept-Encoding takes gzip: listed, and not with q=0
+static bool acceptsGzip(const char* request) {
+    const char* v = findHeader(request, findBody(request), "Accept-Encoding");
+    while (v && *v && *v != '\r' && *v != '\n') {
+        while (*v == ' ' || *v == ',') v++;
+        if (valueIs(v, "gzip")) {
+            const char* q = v + 4;
+            while (*q == ' ') q++;
+            if (*q != ';') return true;
+            q++;
+            while (*q == ' ') q++;
+            return !(q[0] == 'q' && q[1] == '=' && strtod(q + 2, nullptr) == 0.0);
+        }
+        v += strcspn(v, ",\r\n");
+    }
+    return false;
+}
+
 // Parse HTTP request and route
-static void handleRequest(int clientSock, const char* request, size_t requestLen) {
+static void handleRequest(Connection& conn, const char* request, size_t requestLen) {
     char method[8] = {0};
     char path[128] = {0};
 
     if (sscanf(request, "%7s %127s", method, path) != 2) {
-        sendResponse(clientSock, 400, "text/plain", "Bad Request", 11);
+        sendResponse(conn, 400, "text/plain", "Bad Request", 11);
         return;
     }
 
     logger.inf("api", "HTTP %s %s", method, path);
 
     if (strcmp(method, "GET") == 0) {
-        if (strcmp(path, "/api/status") == 0) handleAPIStatus(clientSock);
-        else if (strcmp(path, "/api/version") == 0) handleAPIVersion(clientSock);
-        else if (strcmp(path, "/api/config") == 0) handleAPIConfigGet(clientSock);
+        if (strcmp(path, "/api/status") == 0) handleAPIStatus(conn);
+        else if (strcmp(path, "/api/version") == 0) handleAPIVersion(conn);
+        else if (strcmp(path, "/api/config") == 0) handleAPIConfigGet(conn);
         else if (strncmp(path, "/api/files", 10) == 0) {
-            if (path[10] == '?' || path[10] == '\0') handleAPIFilesList(clientSock);
-            else if (path[10] == '/') handleAPIFileGet(clientSock, path + 11);
-            else sendResponse(clientSock, 404, "text/plain", "Not Found", 9);
-        } else handleStatic(clientSock, path);
+            if (path[10] == '?' || path[10] == '\0') handleAPIFilesList(conn);
+            else if (path[10] == '/') handleAPIFileGet(conn, path + 11);
+            else sendResponse(conn, 404, "text/plain", "Not Found", 9);
+        } else handleStatic(conn, path, acceptsGzip(request));
     } else if (strcmp(method, "PUT") == 0) {
         if (strcmp(path, "/api/config") == 0) {
             const char* body = findBody(request);
-            handleAPIConfigPut(clientSock, body ? body : "");
+            handleAPIConfigPut(conn, body ? body : "");
         } else if (strncmp(path, "/api/files/", 11) == 0) {
             const char* body = findBody(request);
             size_t bodyLen = body ? (requestLen - (body - request)) : 0;
-            handleAPIFilePut(clientSock, path + 11, body ? body : "", bodyLen);
-        } else sendResponse(clientSock, 404, "text/plain", "Not Found", 9);
+            handleAPIFilePut(conn, path + 11, body ? body : "", bodyLen);
+        } else sendResponse(conn, 404, "text/plain", "Not Found", 9);
     } else if (strcmp(method, "POST") == 0) {
-        if (strcmp(path, "/api/tx/trigger") == 0) handleAPITXTrigger(clientSock);
-        else sendResponse(clientSock, 404, "text/plain", "Not Found", 9);
+        if (strcmp(path, "/api/tx/trigger") == 0) handleAPITXTrigger(conn);
+        else sendResponse(conn, 404, "text/plain", "Not Found", 9);
     } else if (strcmp(method, "DELETE") == 0) {
-        if (strncmp(path, "/api/files/", 11) == 0) handleAPIFileDelete(clientSock, path + 11);
-        else sendResponse(clientSock, 404, "text/plain", "Not Found", 9);
+        if (strncmp(path, "/api/files/", 11) == 0) handleAPIFileDelete(conn, path + 11);
+        else sendResponse(conn, 404, "text/plain", "Not Found", 9);
     } else if (strcmp(method, "OPTIONS") == 0) {
-        char header[] = "HTTP/1.1 200 OK\r\nAccess-Control-Allow-Origin: *\r\nAccess-Control-Allow-Methods: GET, POST, PUT, DELETE, OPTIONS\r\nAccess-Control-Allow-Headers: Content-Type\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
-        zsock_send(clientSock, header, strlen(header), 0);
+        char header[256];
+        char connHeader[80];
+        connectionHeader(conn, connHeader, sizeof(connHeader));
+        int headerLen = snprintf(header, sizeof(header), "HTTP/1.1 200 OK\r\nAccess-Control-Allow-Origin: *\r\nAccess-Control-Allow-Methods: GET, POST, PUT, DELETE, OPTIONS\r\nAccess-Control-Allow-Headers: Content-Type\r\nContent-Length: 0\r\n%s\r\n", connHeader);
+        queue(conn, header, headerLen);
+    } else {
+        sendResponse(conn, 405, "text/plain", "Method Not Allowed", 18);
+    }
+}
+
+// Length of the request at the start of rx, headers and Content-Length
+// bytes of body: 0 while more is to come, -1 when it cannot fit the
+// buffer. Bytes after it belong to the next request.
+static int requestLength(const Connection& conn) {
+    const char* body = findBody(conn.rx);
+    if (!body) return conn.rxLen >= MAX_REQUEST_SIZE - 1 ? -1 : 0;
+
+    size_t headerLen = body - conn.rx;
+    const char* clP = findHeader(conn.rx, body, "Content-Length");
+    size_t contentLen = clP ? strtoul(clP, nullptr, 10) : 0;
+    if (contentLen > MAX_REQUEST_SIZE - 1 - headerLen) return -1;
+    return conn.rxLen - headerLen >= contentLen ? (int)(headerLen + contentLen) : 0;
+}
+
+// HTTP/1.1 keeps the connection unless asked to close, 1.0 only when
+// asked to keep it
+static bool wantsKeepAlive(const Connection& conn) {
+    const char* body = findBody(conn.rx);
+    const char* eol = strchr(conn.rx, '\n');
+    const char* v = findHeader(conn.rx, body, "Connection");
+    bool http10 = eol && eol - conn.rx >= 9 && strncmp(eol - 9, "HTTP/1.0", 8) == 0;
+    if (v && valueIs(v, "close")) return false;
+    if (v && valueIs(v, "keep-alive")) return true;
+    return !http10;
+}
+
+static void closeConnection(Connection& conn) {
+    if (conn.streaming) fs_close(&conn.file);
+    conn.streaming = false;
+    zsock_close(conn.sock);
+    conn.sock = -1;
+    conn.state = Connection::State::Free;
+}
+
+// Kept alive and waiting for its next request
+static bool isIdle(const Connection& conn) {
+    return conn.state == Connection::State::Reading && conn.rxLen == 0 && conn.requests > 0;
+}
+
+// A free slot, else the longest idle kept-alive connection closed to
+// make one; nullptr when every connection is busy
+static Connection* freeSlot() {
+    Connection* oldest = nullptr;
+    for (Connection& conn : connections) {
+        if (conn.state == Connection::State::Free) return &conn;
+        if (isIdle(conn) && (!oldest || conn.lastActivity < oldest->lastActivity)) oldest = &conn;
+    }
+    return oldest;
+}
+
+static void acceptConnection(int64_t now) {
+    struct sockaddr_in clientAddr;
+    socklen_t clientAddrLen = sizeof(clientAddr);
+    int sock = zsock_accept(serverSock, (struct sockaddr*)&clientAddr, &clientAddrLen);
+    if (sock < 0) return;
+
+    Connection* slot = freeSlot();
+    if (!slot) {
+        // Only polled with a slot to be had, so not reached
+        zsock_close(sock);
+        return;
+    }
+    if (slot->state != Connection::State::Free) closeConnection(*slot);
+    Connection& conn = *slot;
+    conn.state = Connection::State::Reading;
+    conn.sock = sock;
+    conn.lastActivity = now;
+    conn.rxLen = 0;
+    conn.rx[0] = '\0';
+    conn.txLen = conn.txSent = 0;
+    conn.requestLen = 0;
+    conn.requests = 0;
+    conn.keepAlive = false;
+    conn.streaming = false;
+}
+
+// Answer the request at the start of rx once it is all in
+static void processRequest(Connection& conn) {
+    int len = requestLength(conn);
+    if (len == 0) return;
+
+    conn.state = Connection::State::Writing;
+    conn.txLen = conn.txSent = 0;
+    conn.requests++;
+    if (len < 0) {
+        // Framing is lost with the rest of the body unread
+        conn.keepAlive = false;
+        conn.requestLen = conn.rxLen;
+        sendResponse(conn, 413, "text/plain", "Payload Too Large", 17);
     } else {
-        sendResponse(clientSock, 405, "text/plain", "Method Not Allowed", 18);
+        conn.keepAlive = serverRunning && conn.requests < MAX_REQUESTS_PER_CONNECTION && wantsKeepAlive(conn);
+        conn.requestLen = len;
+        // Handlers see this request alone, terminated
+        char next = conn.rx[len];
+        conn.rx[len] = '\0';
+        handleRequest(conn, conn.rx, len);
+        conn.rx[len] = next;
+    }
+    conn.lastActivity = k_uptime_get();
+}
+
+// Response sent: close, or keep what the client sent after the request
+// and wait for the next
+static void finishResponse(Connection& conn) {
+    if (!conn.keepAlive) {
+        closeConnection(conn);
+        return;
+    }
+    size_t rest = conn.rxLen - conn.requestLen;
+    memmove(conn.rx, conn.rx + conn.requestLen, rest);
+    conn.rxLen = rest;
+    conn.rx[rest] = '\0';
+    conn.requestLen = 0;
+    conn.state = Connection::State::Reading;
+    processRequest(conn);
+}
+
+static void onReadable(Connection& conn, int64_t now) {
+    ssize_t n = zsock_recv(conn.sock, conn.rx + conn.rxLen, MAX_REQUEST_SIZE - 1 - conn.rxLen, ZSOCK_MSG_DONTWAIT);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+    if (n <= 0) {
+        closeConnection(conn);
+        return;
+    }
+    conn.rxLen += n;
+    conn.rx[conn.rxLen] = '\0';
+    conn.lastActivity = now;
+    processRequest(conn);
+}
+
+static void onWritable(Connection& conn, int64_t now) {
+    if (conn.txSent == conn.txLen && conn.streaming) {
+        ssize_t n = fs_read(&conn.file, conn.tx, MAX_RESPONSE_SIZE);
+        if (n < 0) {
+            // The length is already out; all that is left is to cut it short
+            logger.err("static", "File read failed (%d)", (int)n);
+            closeConnection(conn);
+            return;
+        }
+        if (n == 0) {
+            fs_close(&conn.file);
+            conn.streaming = false;
+        }
+        conn.txLen = n;
+        conn.txSent = 0;
+    }
+
+    if (conn.txSent < conn.txLen) {
+        ssize_t n = zsock_send(conn.sock, conn.tx + conn.txSent, conn.txLen - conn.txSent, ZSOCK_MSG_DONTWAIT);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+        if (n <= 0) {
+            closeConnection(conn);
+            return;
+        }
+        conn.txSent += n;
+        conn.lastActivity = now;
     }
+
+    if (conn.txSent == conn.txLen && !conn.streaming) finishResponse(conn);
 }
 
-// Server thread function
+// Server thread function: one poll over the listening socket and every
+// connection, then a step of each that is ready
 static void serverThreadFn(void* p1, void* p2, void* p3) {
     ARG_UNUSED(p1); ARG_UNUSED(p2); ARG_UNUSED(p3);
     logger.inf("init", "HTTP server thread started, port %d", HTTP_PORT);
 
+    struct zsock_pollfd fds[MAX_CONNECTIONS + 1];
+    Connection* polled[MAX_CONNECTIONS + 1];
+
     while (serverRunning) {
-        struct sockaddr_in clientAddr;
-        socklen_t clientAddrLen = sizeof(clientAddr);
-        int clientSock = zsock_accept(serverSock, (struct sockaddr*)&clientAddr, &clientAddrLen);
-        if (clientSock < 0) continue;
-
-        struct zsock_timeval tv = { .tv_sec = 2, .tv_usec = 0 };
-        zsock_setsockopt(clientSock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
-
-        int ret = zsock_recv(clientSock, reqBufPtr, MAX_REQUEST_SIZE - 1, 0);
-        if (ret > 0) {
-            int totalLen = ret;
-            reqBufPtr[totalLen] = '\0';
-            if (strncmp(reqBufPtr, "PUT", 3) == 0 || strncmp(reqBufPtr, "POST", 4) == 0) {
-                const char* clP = strstr(reqBufPtr, "Content-Length:");
-                if (clP) {
-                    int contentLen = atoi(clP + 15);
-                    const char* bodyStart = findBody(reqBufPtr);
-                    int curBodyLen = bodyStart ? (totalLen - (bodyStart - reqBufPtr)) : 0;
-                    while (curBodyLen < contentLen && totalLen < MAX_REQUEST_SIZE - 1) {
-                        ret = zsock_recv(clientSock, reqBufPtr + totalLen, MAX_REQUEST_SIZE - 1 - totalLen, 0);
-                        if (ret <= 0) break;
-                        totalLen += ret;
-                        curBodyLen += ret;
-                        reqBufPtr[totalLen] = '\0';
-                    }
-                }
+        int nfds = 0;
+        for (Connection& conn : connections) {
+            if (conn.state == Connection::State::Free) continue;
+            fds[nfds].fd = conn.sock;
+            fds[nfds].events = conn.state == Connection::State::Reading ? ZSOCK_POLLIN : ZSOCK_POLLOUT;
+            fds[nfds].revents = 0;
+            polled[nfds++] = &conn;
+        }
+        // New clients take a free or idle slot; with every connection
+        // busy they wait in the listen backlog
+        if (freeSlot()) {
+            fds[nfds].fd = serverSock;
+            fds[nfds].events = ZSOCK_POLLIN;
+            fds[nfds].revents = 0;
+            polled[nfds++] = nullptr;
+        }
+
+        int ret = zsock_poll(fds, nfds, POLL_INTERVAL_MS);
+        if (ret < 0) {
+            if (errno != EINTR) k_msleep(POLL_INTERVAL_MS);
+            continue;
+        }
+
+        int64_t now = k_uptime_get();
+        for (int i = 0; i < nfds; i++) {
+            short ev = fds[i].revents;
+            Connection* conn = polled[i];
+            if (!conn) {
+                if (ev & ZSOCK_POLLIN) acceptConnection(now);
+                continue;
+            }
+
+            if (ev & (ZSOCK_POLLERR | ZSOCK_POLLNVAL)) {
+                closeConnection(*conn);
+            } else if (conn->state == Connection::State::Reading && (ev & (ZSOCK_POLLIN | ZSOCK_POLLHUP))) {
+                onReadable(*conn, now);
+            } else if (conn->state == Connection::State::Writing && (ev & ZSOCK_POLLOUT)) {
+                onWritable(*conn, now);
+            } else if (ev & ZSOCK_POLLHUP) {
+                closeConnection(*conn);
+            } else {
+                int64_t limit = isIdle(*conn) ? KEEPALIVE_IDLE_MS :
+                    conn->state == Connection::State::Reading ? READ_TIMEOUT_MS : WRITE_TIMEOUT_MS;
+                if (now - conn->lastActivity > limit) closeConnection(*conn);
             }
-            handleRequest(clientSock, reqBufPtr, totalLen);
         }
-        zsock_close(clientSock);
+    }
+
+    for (Connection& conn : connections) {
+        if (conn.state != Connection::State::Free) closeConnection(conn);
     }
     logger.inf("init", "HTTP server thread exiting");
 }
 
 int WebServer::init() {
     logger.inf("init", "Initializing web server");
-    loadConfigFromNVS();
     return 0;
 }
 
@@ -664,9 +943,13 @@ int WebServer::start(uint16_t port) {
         serverStackPtr = (k_thread_stack_t *)k_aligned_alloc(ARCH_STACK_PTR_ALIGN, K_THREAD_STACK_LEN(SERVER_STACK_SIZE));
         if (!serverStackPtr) return -ENOMEM;
     }
-    if (!reqBufPtr) {
-        reqBufPtr = (char *)k_malloc(MAX_REQUEST_SIZE);
-        if (!reqBufPtr) return -ENOMEM;
+    if (!connBufPtr) {
+        connBufPtr = (char *)k_malloc(MAX_CONNECTIONS * (MAX_REQUEST_SIZE + MAX_RESPONSE_SIZE));
+        if (!connBufPtr) return -ENOMEM;
+        for (int i = 0; i < MAX_CONNECTIONS; i++) {
+            connections[i].rx = connBufPtr + i * (MAX_REQUEST_SIZE + MAX_RESPONSE_SIZE);
+            connections[i].tx = connections[i].rx + MAX_REQUEST_SIZE;
+        }
     }
     serverSock = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
     if (serverSock < 0) return -errno;
@@ -703,7 +986,7 @@ void WebServer::stop() {
     }
     k_thread_join(&serverThread, K_SECONDS(5));
     if (serverStackPtr) { k_free(serverStackPtr); serverStackPtr = nullptr; }
-    if (reqBufPtr) { k_free(reqBufPtr); reqBufPtr = nullptr; }
+    if (connBufPtr) { k_free(connBufPtr); connBufPtr = nullptr; }
     running = false;
 }
 
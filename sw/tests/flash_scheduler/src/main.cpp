@@ -0,0 +1,211 @@
+/*
+ * FlashScheduler tests: a fake backend that takes a few milliseconds
+ * per operation, a transmitter opening and closing windows and writers
+ * hammering it from other threads. No flash operation may overlap a
+ * window unless it was submitted as Immediate.
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+
+#include <atomic>
+#include <cstring>
+#include <cstdio>
+
+#include "flashScheduler.hpp"
+
+using wspr::FlashScheduler;
+
+static const int nRecords = 4;
+
+static std::atomic<bool> txActive{false};
+static std::atomic<bool> expectOverlap{false};
+static std::atomic<int> overlaps{0};
+static std::atomic<int> opsRun{0};
+static uint32_t records[nRecords];
+static char lastPath[64];
+
+// A flash operation long enough for other threads to run meanwhile
+static void flashOp() {
+  if (txActive && !expectOverlap) overlaps++;
+  k_msleep(3);
+  if (txActive && !expectOverlap) overlaps++;
+  opsRun++;
+}
+
+static int fakeWriteRecord(uint16_t id, const void* data, size_t len) {
+  flashOp();
+  if (id >= nRecords || len != sizeof(uint32_t)) return -EINVAL;
+  memcpy(&records[id], data, len);
+  return 0;
+}
+
+static int fakeWriteFile(const char* path, const void* data, size_t len) {
+  flashOp();
+  strncpy(lastPath, path, sizeof(lastPath) - 1);
+  return 0;
+}
+
+static int fakeDeleteFile(const char* path) {
+  flashOp();
+  return 0;
+}
+
+static const FlashScheduler::Backend fakeBackend = {
+  fakeWriteRecord,
+  fakeWriteFile,
+  fakeDeleteFile,
+};
+
+static void waitDrained() {
+  for (int i = 0; i < 200 && FlashScheduler::instance().pending(); i++) k_msleep(10);
+}
+
+// --- Transmitter and writers ---
+
+#define STACK_SIZE 2048
+static K_THREAD_STACK_DEFINE(txStack, STACK_SIZE);
+static K_THREAD_STACK_ARRAY_DEFINE(writerStacks, 2, STACK_SIZE);
+static struct k_thread txThread;
+static struct k_thread writerThreads[2];
+
+static uint32_t lcg(uint32_t& s) {
+  s = s * 1664525u + 1013904223u;
+  return s >> 16;
+}
+
+static void txFn(void* p1, void* p2, void* p3) {
+  auto& sched = FlashScheduler::instance();
+  uint32_t seed = 7;
+  for (int slot = 0; slot < 30; slot++) {
+    k_msleep(2 + lcg(seed) % 10);
+    sched.beginWindow();
+    txActive = true;
+    k_msleep(15 + lcg(seed) % 10);
+    txActive = false;
+    sched.endWindow();
+  }
+}
+
+static uint32_t lastWritten[2][nRecords];
+
+static void writerFn(void* p1, void* p2, void* p3) {
+  auto& sched = FlashScheduler::instance();
+  int w = (int)(intptr_t)p1;
+  uint32_t seed = 100 + w;
+  for (int i = 0; i < 150; i++) {
+    // Each writer owns alternate records so the final values are known
+    uint16_t id = (uint16_t)(w + 2 * (lcg(seed) % 2));
+    uint32_t v = (uint32_t)(w << 24 | i);
+    zassert_true(sched.writeRecord(id, &v, sizeof(v)) >= 0, "record write refused");
+    lastWritten[w][id] = v;
+    if (i % 10 == 0) {
+      zassert_true(sched.writeFile(w ? "/lfs/b.txt" : "/lfs/a.txt", &v, sizeof(v)) >= 0,
+                   "file write refused");
+    }
+    k_msleep(lcg(seed) % 4);
+  }
+}
+
+// --- Tests ---
+
+static void* setup(void) {
+  FlashScheduler::instance().init(&fakeBackend);
+  return NULL;
+}
+
+ZTEST(flash_scheduler, test_no_overlap_with_tx)
+{
+  auto before = FlashScheduler::instance().stats();
+  overlaps = 0;
+  memset(lastWritten, 0, sizeof(lastWritten));
+
+  k_thread_create(&txThread, txStack, STACK_SIZE, txFn, NULL, NULL, NULL,
+                  K_PRIO_PREEMPT(5), 0, K_NO_WAIT);
+  for (int w = 0; w < 2; w++) {
+    k_thread_create(&writerThreads[w], writerStacks[w], STACK_SIZE, writerFn,
+                    (void*)(intptr_t)w, NULL, NULL, K_PRIO_PREEMPT(6), 0, K_NO_WAIT);
+  }
+  k_thread_join(&txThread, K_FOREVER);
+  for (int w = 0; w < 2; w++) k_thread_join(&writerThreads[w], K_FOREVER);
+  waitDrained();
+
+  auto after = FlashScheduler::instance().stats();
+  zassert_equal((int)overlaps, 0, "%d flash operations overlapped a TX window", (int)overlaps);
+  zassert_true(after.deferred > before.deferred, "no write was ever deferred");
+  zassert_equal(after.failed, before.failed, "backend failures");
+  zassert_equal(FlashScheduler::instance().pending(), 0, "queue not drained");
+
+  // Coalescing kept the newest value of every record
+  for (int w = 0; w < 2; w++) {
+    for (int id = w; id < nRecords; id += 2) {
+      if (lastWritten[w][id]) zassert_equal(records[id], lastWritten[w][id], "record %d stale", id);
+    }
+  }
+}
+
+ZTEST(flash_scheduler, test_deferred_and_coalesced)
+{
+  auto& sched = FlashScheduler::instance();
+  uint32_t a = 0x1111, b = 0x2222;
+  int ops = opsRun;
+
+  sched.beginWindow();
+  txActive = true;
+  zassert_equal(sched.writeRecord(1, &a, sizeof(a)), FlashScheduler::queued);
+  zassert_equal(sched.writeRecord(1, &b, sizeof(b)), FlashScheduler::queued);
+  zassert_equal(sched.deleteFile("/lfs/x.txt"), FlashScheduler::queued);
+  zassert_equal(sched.writeFile("/lfs/x.txt", &a, sizeof(a)), FlashScheduler::queued);
+  zassert_equal(sched.pending(), 2, "same record or path not coalesced");
+  k_msleep(50);
+  zassert_equal((int)opsRun, ops, "flash touched inside the window");
+  txActive = false;
+  sched.endWindow();
+
+  waitDrained();
+  zassert_equal(records[1], b, "newest record value not written");
+  zassert_equal(strcmp(lastPath, "/lfs/x.txt"), 0);
+  zassert_equal((int)opsRun, ops + 2);
+}
+
+ZTEST(flash_scheduler, test_immediate_override)
+{
+  auto& sched = FlashScheduler::instance();
+  uint32_t v = 0x3333;
+  auto before = sched.stats();
+
+  sched.beginWindow();
+  txActive = true;
+  expectOverlap = true;
+  zassert_equal(sched.writeRecord(2, &v, sizeof(v), FlashScheduler::Urgency::Immediate), 0);
+  expectOverlap = false;
+  txActive = false;
+  sched.endWindow();
+
+  zassert_equal(records[2], v, "immediate write not run");
+  zassert_equal(sched.stats().overrides, before.overrides + 1);
+}
+
+ZTEST(flash_scheduler, test_limits)
+{
+  auto& sched = FlashScheduler::instance();
+  char longPath[80];
+  memset(longPath, 'a', sizeof(longPath) - 1);
+  longPath[sizeof(longPath) - 1] = '\0';
+  zassert_equal(sched.writeFile(longPath, "x", 1), -ENAMETOOLONG);
+
+  // Eight distinct files fill the queue, the ninth is refused
+  sched.beginWindow();
+  char path[16];
+  int ret = 0;
+  for (int i = 0; i < 9; i++) {
+    snprintf(path, sizeof(path), "/lfs/f%d", i);
+    ret = sched.deleteFile(path);
+  }
+  zassert_equal(ret, -ENOSPC);
+  zassert_equal(sched.flush(), 0, "flush inside a window failed");
+  zassert_equal(sched.pending(), 0);
+  sched.endWindow();
+}
+
+ZTEST_SUITE(flash_scheduler, NULL, setup, NULL, NULL, NULL);
@@ -0,0 +1,60 @@
+// Host benchmark for SolarCalc: the direct computation against a memo
+// cache hit, and the cost of compiling a band plan with sun windows.
+// Run with `make bench`.
+#include "solarCalc.hpp"
+#include "bandPlanner.hpp"
+#include <iostream>
+#include <chrono>
+#include <cstdint>
+
+using wspr::SolarCalc;
+using wspr::BandPlanner;
+using Clock = std::chrono::steady_clock;
+
+static double nsPer(Clock::time_point t0, Clock::time_point t1, int n) {
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+}
+
+int main() {
+  const int n = 200000;
+  const int64_t t = 1760054400;
+  volatile int sink = 0;
+
+  auto t0 = Clock::now();
+  for (int i = 0; i < n; i++) {
+    auto d = SolarCalc::compute(20000 + i % 3650, -60.0 + (i % 1200) * 0.1, -180.0 + (i % 3600) * 0.1);
+    sink += d.sunriseMin;
+  }
+  auto t1 = Clock::now();
+  std::cout << "compute()        " << nsPer(t0, t1, n) << " ns" << std::endl;
+
+  SolarCalc calc;
+  t0 = Clock::now();
+  for (int i = 0; i < n; i++) sink += calc.get(t + i % 3600, 52.52, 13.37).sunsetMin;
+  t1 = Clock::now();
+  std::cout << "get(), cached    " << nsPer(t0, t1, n) << " ns  (" << calc.stats().misses << " misses)" << std::endl;
+
+  BandPlanner::Config c;
+  c.nBands = 9;
+  for (int b = 0; b < c.nBands; b++) {
+    c.bands[b].enabled = true;
+    c.bands[b].freqHz = 3568600 + b * 3000000;
+    c.bands[b].window = {true, BandPlanner::TimeBase::Sunrise, (int16_t)(b * 10), BandPlanner::TimeBase::Sunset, 0};
+  }
+  BandPlanner planner;
+  const int m = 2000;
+  t0 = Clock::now();
+  for (int i = 0; i < m; i++) {
+    const auto& d = calc.get(t + i * 86400LL, 52.52, 13.37);
+    BandPlanner::SunTimes sun;
+    sun.known = true;
+    sun.sunriseMin = d.sunriseMin;
+    sun.sunsetMin = d.sunsetMin;
+    sun.daylightMin = d.daylightMin;
+    planner.compile(c, sun);
+    sink += planner.eligible(i % 1440);
+  }
+  t1 = Clock::now();
+  std::cout << "daily recompile  " << nsPer(t0, t1, m) / 1000 << " us" << std::endl;
+  return 0;
+}
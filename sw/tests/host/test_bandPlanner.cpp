@@ -0,0 +1,240 @@
+// Host test for BandPlanner: eligibility windows, the four modes, duty
+// cycle, the message mix and taking slots at the boundary
+#include "bandPlanner.hpp"
+#include <iostream>
+#include <cstdint>
+
+using wspr::BandPlanner;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+  std::cout << "  " << what << (ok ? " (OK)" : " (FAIL)") << std::endl;
+  if (!ok) failures++;
+}
+
+static const uint32_t hz[] = {1836600, 3568600, 7038600, 10138700, 14095600, 18104600, 28124600};
+static const int nHz = sizeof(hz) / sizeof(hz[0]);
+
+static BandPlanner::Config baseConfig() {
+  BandPlanner::Config c;
+  c.nBands = nHz;
+  for (int b = 0; b < nHz; b++) c.bands[b].freqHz = hz[b];
+  return c;
+}
+
+int main() {
+  const int64_t day0 = 1760054400;	// 2025-10-10 00:00:00 UTC
+  BandPlanner::SunTimes noSun;
+
+  std::cout << "Filters" << std::endl;
+  check(BandPlanner::lpfForHz(1836600) == 0 && BandPlanner::lpfForHz(5287200) == 0, "160 and 60 m on the 6 MHz filter");
+  check(BandPlanner::lpfForHz(7038600) == 1 && BandPlanner::lpfForHz(14095600) == 1, "40 and 20 m on the 16 MHz filter");
+  check(BandPlanner::lpfForHz(18104600) == 2 && BandPlanner::lpfForHz(28124600) == 2, "17 and 10 m on the 32 MHz filter");
+
+  std::cout << "Round robin" << std::endl;
+  {
+    auto c = baseConfig();
+    c.bands[1].enabled = c.bands[2].enabled = c.bands[4].enabled = true;
+    BandPlanner p;
+    p.compile(c, noSun);
+    check(p.refill(day0 + 30) == BandPlanner::maxPlan, "Plan filled");
+
+    BandPlanner::Slot s[BandPlanner::maxPlan];
+    int n = p.upcoming(s, BandPlanner::maxPlan);
+    check(s[0].startUnix == day0 + 120, "First slot at the next even minute");
+    bool order = true, spacing = true;
+    for (int i = 0; i < n; i++) {
+      static const uint8_t expect[] = {1, 2, 4};
+      if (s[i].band != expect[i % 3]) order = false;
+      if (i && s[i].startUnix - s[i - 1].startUnix != 120) spacing = false;
+    }
+    check(order, "Bands in turn");
+    check(spacing, "Every 2 minute slot used");
+    check(s[0].lpf == 0 && s[1].lpf == 1 && s[0].freqHz == hz[1], "Frequency and filter filled in");
+
+    BandPlanner::Slot got;
+    check(!p.take(day0 + 60, got), "Nothing planned at an odd minute");
+    check(p.take(day0 + 360, got) && got.startUnix == day0 + 360, "Later slot taken, earlier ones dropped");
+    check(p.upcoming(s, BandPlanner::maxPlan) == BandPlanner::maxPlan - 3, "Plan shortened");
+    p.refill(day0 + 400);
+    p.upcoming(s, BandPlanner::maxPlan);
+    check(s[0].startUnix == day0 + 480 && s[BandPlanner::maxPlan - 1].startUnix == day0 + 480 + 7 * 120,
+          "Refill continues after the last planned slot");
+
+    // Recompiling keeps the rotation going
+    int lastBand = s[BandPlanner::maxPlan - 1].band;
+    p.compile(c, noSun);
+    p.refill(day0 + 480 + 8 * 120 - 30);
+    p.upcoming(s, 1);
+    check(s[0].band == (lastBand == 4 ? 1 : lastBand == 1 ? 2 : 4), "Rotation kept across a recompile");
+  }
+
+  std::cout << "Interval and duty cycle" << std::endl;
+  {
+    auto c = baseConfig();
+    c.bands[4].enabled = true;
+    c.slotIntervalMin = 9;		// Rounded to 10
+    c.dutyCycle = 3;
+    BandPlanner p;
+    p.compile(c, noSun);
+    p.refill(day0);
+    BandPlanner::Slot s[BandPlanner::maxPlan];
+    int n = p.upcoming(s, BandPlanner::maxPlan);
+    bool ok = p.interval() == 10;
+    for (int i = 0; i < n; i++) {
+      int64_t slotNo = s[i].startUnix / 600;
+      if (s[i].startUnix % 600 || slotNo % 3) ok = false;
+      if (i && s[i].startUnix - s[i - 1].startUnix != 1800) ok = false;
+    }
+    check(n == BandPlanner::maxPlan && ok, "One 10 minute slot in three");
+  }
+
+  std::cout << "Time windows" << std::endl;
+  {
+    auto c = baseConfig();
+    // 40 m by day 06:00-18:00 UTC, 80 m overnight 20:00-04:00 local at UTC+2
+    c.bands[2].enabled = true;
+    c.bands[2].window = {true, BandPlanner::TimeBase::Utc, 360, BandPlanner::TimeBase::Utc, 1080};
+    c.bands[1].enabled = true;
+    c.timezoneOffsetMin = 120;
+    c.bands[1].window = {true, BandPlanner::TimeBase::Local, 1200, BandPlanner::TimeBase::Local, 240};
+    BandPlanner p;
+    p.compile(c, noSun);
+    check(p.eligible(360) == 1 << 2 && p.eligible(1077) == 1 << 2, "Day band inside its window");
+    check(p.eligible(1079) == 0, "Slot running past the window end refused");
+    check(p.eligible(1080) == 1 << 1 && p.eligible(0) == 1 << 1 && p.eligible(118) == 1 << 1,
+          "Night band across midnight, shifted by the time zone");
+    check(p.eligible(120) == 0 && p.eligible(300) == 0, "Gap between the windows");
+
+    // Sunset-relative window: unrestricted until the sun times are known
+    c.bands[1].enabled = false;
+    c.bands[3].enabled = true;
+    c.bands[3].window = {true, BandPlanner::TimeBase::Sunset, -60, BandPlanner::TimeBase::Sunset, 120};
+    p.compile(c, noSun);
+    check(p.eligible(200) & (1 << 3), "Sun window open while unknown");
+    BandPlanner::SunTimes sun;
+    sun.known = true;
+    sun.sunriseMin = 330;
+    sun.sunsetMin = 1000;
+    p.compile(c, sun);
+    check(p.eligible(940) & (1 << 3) && !(p.eligible(200) & (1 << 3)) && !(p.eligible(1119) & (1 << 3)),
+          "Sun window applied once known");
+
+    // Day and night windows between sun events at high latitude
+    c.bands[3].enabled = false;
+    c.bands[4].enabled = true;
+    c.bands[4].window = {true, BandPlanner::TimeBase::Sunrise, 30, BandPlanner::TimeBase::Sunset, -30};
+    c.bands[5].enabled = true;
+    c.bands[5].window = {true, BandPlanner::TimeBase::Sunset, 0, BandPlanner::TimeBase::Sunrise, 0};
+    BandPlanner polar;
+    BandPlanner::SunTimes night;
+    night.known = true;
+    night.sunriseMin = night.sunsetMin = 642;
+    night.daylightMin = 0;
+    polar.compile(c, night);
+    bool allNight = true;
+    for (int m = 0; m < BandPlanner::minutesPerDay; m++) {
+      if (polar.eligible(m) & (1 << 4) || !(polar.eligible(m) & (1 << 5))) allNight = false;
+    }
+    check(allNight, "Polar night: day window closed, night window open all day");
+    BandPlanner::SunTimes midnightSun = night;
+    midnightSun.daylightMin = BandPlanner::minutesPerDay;
+    polar.compile(c, midnightSun);
+    bool allDay = true;
+    for (int m = 0; m < BandPlanner::minutesPerDay; m++) {
+      if (!(polar.eligible(m) & (1 << 4)) || polar.eligible(m) & (1 << 5)) allDay = false;
+    }
+    check(allDay, "Polar day: day window open all day, night window closed");
+    c.bands[4].enabled = c.bands[5].enabled = false;
+    c.bands[3].enabled = true;
+
+    // No slot planned in the gap
+    p.refill(day0 + 1080 * 60);
+    BandPlanner::Slot s[BandPlanner::maxPlan];
+    int n = p.upcoming(s, BandPlanner::maxPlan);
+    bool gapFree = n > 0;
+    for (int i = 0; i < n; i++) {
+      int m = (int)((s[i].startUnix - day0) / 60 % 1440);
+      if (!(p.eligible(m) & (1 << s[i].band))) gapFree = false;
+    }
+    check(gapFree, "Planned slots all eligible");
+  }
+
+  std::cout << "List and random" << std::endl;
+  {
+    auto c = baseConfig();
+    c.mode = BandPlanner::Mode::List;
+    for (int b : {1, 2, 4}) c.bands[b].enabled = true;
+    const uint8_t list[] = {4, 4, 6, 2};	// 10 m disabled, skipped
+    c.listLen = 4;
+    for (int i = 0; i < 4; i++) c.list[i] = list[i];
+    BandPlanner p;
+    p.compile(c, noSun);
+    p.refill(day0);
+    BandPlanner::Slot s[BandPlanner::maxPlan];
+    p.upcoming(s, 6);
+    check(s[0].band == 4 && s[1].band == 4 && s[2].band == 2 && s[3].band == 4 && s[4].band == 4 && s[5].band == 2,
+          "List order, ineligible entry skipped");
+
+    c.mode = BandPlanner::Mode::Random;
+    c.seed = 42;
+    int hits[BandPlanner::maxBands] = {};
+    BandPlanner r;
+    r.compile(c, noSun);
+    BandPlanner::Slot got;
+    int64_t t = day0;
+    for (int i = 0; i < 3000; i++) {
+      r.refill(t);
+      r.take(r.upcoming(&got, 1) ? got.startUnix : 0, got);
+      hits[got.band]++;
+      t = got.startUnix + 1;
+    }
+    check(hits[1] + hits[2] + hits[4] == 3000, "Random picks only enabled bands");
+    check(hits[1] > 850 && hits[2] > 850 && hits[4] > 850, "Random spread evenly");
+
+    BandPlanner r1, r2;
+    r1.compile(c, noSun);
+    r1.refill(day0);
+    r2.compile(c, noSun);
+    r2.refill(day0);
+    BandPlanner::Slot x[BandPlanner::maxPlan], y[BandPlanner::maxPlan];
+    r1.upcoming(x, BandPlanner::maxPlan);
+    r2.upcoming(y, BandPlanner::maxPlan);
+    bool same = true;
+    for (int i = 0; i < BandPlanner::maxPlan; i++) same = same && x[i].band == y[i].band;
+    check(same, "Random plan reproducible");
+  }
+
+  std::cout << "Messages and manual mode" << std::endl;
+  {
+    auto c = baseConfig();
+    c.bands[4].enabled = true;
+    c.longLocator = true;
+    BandPlanner p;
+    p.compile(c, noSun);
+    p.refill(day0);
+    BandPlanner::Slot s[4];
+    p.upcoming(s, 4);
+    check(s[0].message == BandPlanner::Message::Type1 && s[1].message == BandPlanner::Message::Type3 &&
+          s[2].message == BandPlanner::Message::Type1, "6-character locator alternates types 1 and 3");
+
+    c.compoundCall = true;
+    p.compile(c, noSun);
+    p.refill(day0);
+    p.upcoming(s, 2);
+    check(s[0].message != BandPlanner::Message::Type1 && s[1].message != BandPlanner::Message::Type1,
+          "Compound call uses types 2 and 3");
+
+    c.mode = BandPlanner::Mode::Manual;
+    p.compile(c, noSun);
+    check(p.refill(day0) == 0, "Manual mode plans nothing");
+
+    auto none = baseConfig();
+    p.compile(none, noSun);
+    check(p.refill(day0) == 0, "No bands, no plan");
+  }
+
+  std::cout << (failures ? "BandPlanner (FAIL)" : "BandPlanner (OK)") << std::endl;
+  return failures ? 1 : 0;
+}
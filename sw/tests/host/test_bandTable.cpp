@@ -0,0 +1,91 @@
+// Host test for the band table: order and names, the constant-time
+// lookups, filter choice and the precomputed tone words against the
+// run-time computation
+#include "bandTable.hpp"
+#include "bandPlanner.hpp"
+#include "modulation.hpp"
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+using wspr::BandTable;
+using wspr::BandPlanner;
+using wspr::Modulation;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+  std::cout << "  " << what << (ok ? " (OK)" : " (FAIL)") << std::endl;
+  if (!ok) failures++;
+}
+
+// Resolved at compile time
+static_assert(BandTable::fromName("20m") == BandTable::index(BandTable::Id::Band20m), "constexpr name lookup");
+static_assert(BandTable::get(BandTable::Id::Band60m).lpf == 0, "constexpr filter");
+
+int main() {
+  std::cout << "Table" << std::endl;
+  {
+    static const char* names[] = { "160m", "80m", "60m", "40m", "30m", "20m", "17m", "15m", "12m", "10m" };
+    bool order = (int)(sizeof(names) / sizeof(names[0])) == BandTable::count;
+    for (int i = 1; i < BandTable::count; i++) order = order && BandTable::get(i).dialHz > BandTable::get(i - 1).dialHz;
+    bool named = true;
+    for (int i = 0; i < BandTable::count; i++) {
+      const BandTable::Entry& e = BandTable::get(i);
+      named = named && strcmp(e.name, names[i]) == 0 && std::to_string(e.meters) + "m" == e.name;
+    }
+    check(order, "Ten bands by frequency");
+    check(named, "Names and wavelengths agree");
+    check(BandTable::get(BandTable::Id::Band20m).dialHz == 14095600 &&
+          BandTable::get(BandTable::Id::Band60m).dialHz == 5287200, "Dial frequencies");
+  }
+
+  std::cout << "Lookups" << std::endl;
+  {
+    bool ok = true;
+    for (int i = 0; i < BandTable::count; i++) {
+      const BandTable::Entry& e = BandTable::get(i);
+      ok = ok && BandTable::fromName(e.name) == i && BandTable::fromDialHz(e.dialHz) == i;
+    }
+    check(ok, "Every band by name and dial frequency");
+    check(BandTable::fromName("6m") < 0 && BandTable::fromName("20") < 0 && BandTable::fromName("20mm") < 0 &&
+          BandTable::fromName("m") < 0 && BandTable::fromName("99999m") < 0 && BandTable::fromName("") < 0 &&
+          BandTable::fromName(nullptr) < 0, "Unknown names");
+    check(BandTable::fromDialHz(14095601) < 0 && BandTable::fromDialHz(14000000) < 0 &&
+          BandTable::fromDialHz(50293000) < 0 && BandTable::fromDialHz(0) < 0, "Off-dial frequencies");
+  }
+
+  std::cout << "Filters" << std::endl;
+  {
+    bool ok = true;
+    for (int i = 0; i < BandTable::count; i++) {
+      ok = ok && BandTable::get(i).lpf == BandPlanner::lpfForHz(BandTable::get(i).dialHz);
+    }
+    check(ok, "Same choice as the planner");
+    check(BandTable::get(BandTable::Id::Band80m).lpf == 0 && BandTable::get(BandTable::Id::Band30m).lpf == 1 &&
+          BandTable::get(BandTable::Id::Band17m).lpf == 2, "6, 16 and 32 MHz filters");
+  }
+
+  std::cout << "Tone words" << std::endl;
+  {
+    const Modulation& m = Modulation::get(Modulation::Mode::Wspr2);
+    bool ok = true;
+    for (int i = 0; i < BandTable::count; i++) {
+      const BandTable::Entry& e = BandTable::get(i);
+      for (int tone = 0; tone < Modulation::toneCount; tone++) {
+        ok = ok && e.wsprWords[tone] == m.toneWord(e.dialHz, tone, BandTable::defaultSteps, BandTable::exciterClkHz);
+      }
+      ok = ok && e.wsprWords[0] == (uint32_t)(((uint64_t)e.dialHz * BandTable::defaultSteps << 32) / BandTable::exciterClkHz);
+    }
+    check(ok, "WSPR-2 words match the run-time computation");
+    uint32_t f = BandTable::get(BandTable::Id::Band40m).dialHz;
+    check(BandTable::wsprWords(f, BandTable::defaultSteps, BandTable::exciterClkHz) ==
+          BandTable::get(BandTable::Id::Band40m).wsprWords, "Found for the default NCO");
+    check(!BandTable::wsprWords(f, 12, BandTable::exciterClkHz) && !BandTable::wsprWords(f + 1, 6, BandTable::exciterClkHz) &&
+          !BandTable::wsprWords(f, 6, 100000000), "Not for other steps, frequencies or clocks");
+  }
+
+  std::cout << (failures ? "BandTable (FAIL)" : "BandTable (OK)") << std::endl;
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,234 @@
+// Host test for ConfigSchema: field records, the version 0 and 1
+// migrations, change detection and records from other firmware versions
+#include "configSchema.hpp"
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <vector>
+
+using wspr::AppConfig;
+using wspr::ConfigSchema;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+  std::cout << "  " << what << (ok ? " (OK)" : " (FAIL)") << std::endl;
+  if (!ok) failures++;
+}
+
+// NVS stand-in: nvs_read() semantics, the stored length is returned
+// even when the buffer is shorter
+typedef std::map<uint16_t, std::vector<uint8_t>> Store;
+
+static int readRecord(uint16_t key, void* buf, size_t len, void* ctx) {
+  Store& s = *static_cast<Store*>(ctx);
+  auto it = s.find(key);
+  if (it == s.end()) return -2;
+  memcpy(buf, it->second.data(), std::min(len, it->second.size()));
+  return (int)it->second.size();
+}
+
+static void put(Store& s, uint16_t key, const void* data, size_t len) {
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  s[key].assign(p, p + len);
+}
+
+static void saveAll(Store& s, const AppConfig& cfg) {
+  uint8_t buf[ConfigSchema::maxRecord];
+  for (const auto& f : ConfigSchema::fields) put(s, f.key, buf, ConfigSchema::encode(f, cfg, buf));
+  uint16_t v = ConfigSchema::version;
+  put(s, ConfigSchema::versionKey, &v, sizeof(v));
+}
+
+static bool same(const AppConfig& a, const AppConfig& b) {
+  for (const auto& f : ConfigSchema::fields) {
+    if (ConfigSchema::differs(f, a, b)) return false;
+  }
+  return true;
+}
+
+static AppConfig custom() {
+  AppConfig c;
+  strcpy(c.callsign, "DL1ABC");
+  strcpy(c.gridSquare, "JO62qm");
+  c.powerDbm = 30;
+  strcpy(c.mode, "fixed");
+  c.slotIntervalMin = 4;
+  strcpy(c.bandList, "20m,40m");
+  c.bandEnabled[5] = false;
+  c.bandEnabled[6] = true;
+  return c;
+}
+
+// Band flags in the version 0 and 1 order, which had no 60 m
+static const wspr::BandTable::Id bandsV1[] = {
+  wspr::BandTable::Id::Band160m, wspr::BandTable::Id::Band80m, wspr::BandTable::Id::Band40m,
+  wspr::BandTable::Id::Band30m, wspr::BandTable::Id::Band20m, wspr::BandTable::Id::Band17m,
+  wspr::BandTable::Id::Band15m, wspr::BandTable::Id::Band12m, wspr::BandTable::Id::Band10m,
+};
+
+static void oldFlags(const AppConfig& c, bool flags[10]) {
+  memset(flags, 0, 10);
+  for (int i = 0; i < 9; i++) flags[i] = c.bandEnabled[wspr::BandTable::index(bandsV1[i])];
+}
+
+int main() {
+  std::cout << "Empty store" << std::endl;
+  {
+    Store s;
+    AppConfig cfg;
+    ConfigSchema::LoadInfo info;
+    ConfigSchema::load(readRecord, &s, cfg, info);
+    check(same(cfg, AppConfig()), "Defaults");
+    check(info.storedVersion == 0 && !info.migrated && info.fieldsRead == 0, "Nothing read or migrated");
+  }
+
+  std::cout << "Field records" << std::endl;
+  {
+    Store s;
+    AppConfig c = custom();
+    saveAll(s, c);
+    check(s[1].size() == strlen("DL1ABC") + 1, "Text stored without its unused tail");
+
+    AppConfig cfg;
+    ConfigSchema::LoadInfo info;
+    ConfigSchema::load(readRecord, &s, cfg, info);
+    check(same(cfg, c), "Round trip");
+    check(info.storedVersion == ConfigSchema::version && info.fieldsRead == ConfigSchema::nFields &&
+          !info.migrated, "All fields read at the current version");
+
+    // A missing or damaged record leaves its default
+    s.erase(3);
+    std::vector<uint8_t> bad(200, 'x');
+    s[6] = bad;
+    ConfigSchema::load(readRecord, &s, cfg, info);
+    check(cfg.powerDbm == AppConfig().powerDbm && cfg.bandList[0] == '\0', "Bad records fall back to defaults");
+    check(strcmp(cfg.callsign, "DL1ABC") == 0 && info.fieldsRead == ConfigSchema::nFields - 2,
+          "Other fields unaffected");
+  }
+
+  std::cout << "Version 0 migration" << std::endl;
+  {
+    // The whole struct as version 0 firmware wrote it
+    struct {
+      char callsign[16];
+      char gridSquare[8];
+      int powerDbm;
+      char mode[16];
+      int slotIntervalMin;
+      char bandList[128];
+      bool bandEnabled[10];
+    } old;
+    memset(&old, 0, sizeof(old));
+    AppConfig c = custom();
+    strcpy(old.callsign, c.callsign);
+    strcpy(old.gridSquare, c.gridSquare);
+    old.powerDbm = c.powerDbm;
+    strcpy(old.mode, c.mode);
+    old.slotIntervalMin = c.slotIntervalMin;
+    strcpy(old.bandList, c.bandList);
+    oldFlags(c, old.bandEnabled);
+
+    Store s;
+    put(s, ConfigSchema::legacyKey, &old, sizeof(old));
+    AppConfig cfg;
+    ConfigSchema::LoadInfo info;
+    ConfigSchema::load(readRecord, &s, cfg, info);
+    check(info.migrated && info.storedVersion == 0, "Old record migrated");
+    check(same(cfg, c), "Settings kept");
+
+    // Interrupted before the version record: the old record still wins
+    Store part = s;
+    uint8_t buf[ConfigSchema::maxRecord];
+    const auto& f = ConfigSchema::fields[0];
+    put(part, f.key, buf, ConfigSchema::encode(f, AppConfig(), buf));
+    ConfigSchema::load(readRecord, &part, cfg, info);
+    check(info.migrated && same(cfg, c), "Half-written migration redone");
+
+    // Once the version record exists the old one is ignored
+    saveAll(s, AppConfig());
+    ConfigSchema::load(readRecord, &s, cfg, info);
+    check(!info.migrated && same(cfg, AppConfig()), "Old record ignored after migration");
+
+    Store wrong;
+    put(wrong, ConfigSchema::legacyKey, &old, sizeof(old) - 4);
+    ConfigSchema::load(readRecord, &wrong, cfg, info);
+    check(!info.migrated && same(cfg, AppConfig()), "Old record of the wrong size ignored");
+  }
+
+  std::cout << "Version 1 migration" << std::endl;
+  {
+    // Field records with the flags in the old order
+    Store s;
+    AppConfig c = custom();
+    saveAll(s, c);
+    uint16_t v = 1;
+    put(s, ConfigSchema::versionKey, &v, sizeof(v));
+    bool flags[10];
+    oldFlags(c, flags);
+    put(s, 7, flags, sizeof(flags));
+
+    AppConfig cfg;
+    ConfigSchema::LoadInfo info;
+    ConfigSchema::load(readRecord, &s, cfg, info);
+    check(info.migrated && info.storedVersion == 1 && info.fieldsRead == ConfigSchema::nFields, "Flags migrated");
+    check(same(cfg, c) && cfg.bandEnabled[6] && !cfg.bandEnabled[2], "Bands moved past 60 m, which is off");
+
+    // Without a flag record the defaults are already in the new order
+    s.erase(7);
+    ConfigSchema::load(readRecord, &s, cfg, info);
+    check(!info.migrated && memcmp(cfg.bandEnabled, AppConfig().bandEnabled, sizeof(cfg.bandEnabled)) == 0,
+          "Default flags left alone");
+  }
+
+  std::cout << "Change detection" << std::endl;
+  {
+    AppConfig a = custom(), b = custom();
+    // Bytes past the terminator are not part of the record
+    memset(b.callsign + 7, 'z', sizeof(b.callsign) - 7);
+    b.callsign[sizeof(b.callsign) - 1] = 'z';
+    b.callsign[6] = '\0';
+    int changed = 0;
+    for (const auto& f : ConfigSchema::fields) changed += ConfigSchema::differs(f, a, b);
+    check(changed == 0, "Tail garbage is no change");
+
+    b.powerDbm = 37;
+    b.bandEnabled[9] = true;
+    changed = 0;
+    for (const auto& f : ConfigSchema::fields) changed += ConfigSchema::differs(f, a, b);
+    check(changed == 2, "Two edits, two changed fields");
+
+    for (const auto& f : ConfigSchema::fields) ConfigSchema::copy(f, b, a);
+    check(same(a, b), "Copied fields match");
+  }
+
+  std::cout << "Newer schema" << std::endl;
+  {
+    Store s;
+    saveAll(s, custom());
+    uint16_t v = ConfigSchema::version + 1;
+    put(s, ConfigSchema::versionKey, &v, sizeof(v));
+    // A field a later firmware added, and a longer flag list
+    put(s, 42, "future", 7);
+    bool flags[12] = {true, true, true, true, true, true, true, true, true, true, true, true};
+    put(s, 7, flags, sizeof(flags));
+
+    AppConfig cfg;
+    ConfigSchema::LoadInfo info;
+    ConfigSchema::load(readRecord, &s, cfg, info);
+    check(info.storedVersion == v && !info.migrated, "Version kept, nothing migrated");
+    check(strcmp(cfg.callsign, "DL1ABC") == 0 && info.fieldsRead == ConfigSchema::nFields - 1,
+          "Known fields read, oversize flags refused");
+
+    // A shorter flag list from an older layout keeps the remaining defaults
+    bool few[4] = {true, false, true, false};
+    put(s, 7, few, sizeof(few));
+    ConfigSchema::load(readRecord, &s, cfg, info);
+    check(cfg.bandEnabled[0] && !cfg.bandEnabled[1] && cfg.bandEnabled[2] && cfg.bandEnabled[5] == AppConfig().bandEnabled[5],
+          "Short flag list padded with defaults");
+  }
+
+  std::cout << (failures ? "ConfigSchema (FAIL)" : "ConfigSchema (OK)") << std::endl;
+  return failures ? 1 : 0;
+}
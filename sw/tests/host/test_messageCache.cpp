@@ -0,0 +1,113 @@
+// Host test for MessageCache: keys carry only what each message type
+// sends, entries survive changes that do not alter the message, and the
+// tone words match the NCO arithmetic.
+#include "messageCache.hpp"
+#include "wsprEncoder.hpp"
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+using wspr::MessageCache;
+using wspr::WsprEncoder;
+using wspr::Modulation;
+using Message = wspr::BandPlanner::Message;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+  std::cout << "  " << what << (ok ? " (OK)" : " (FAIL)") << std::endl;
+  if (!ok) failures++;
+}
+
+static bool sameSymbols(const uint8_t* a, Message type, const char* call, const char* grid, int power) {
+  uint8_t b[WsprEncoder::symbolCount];
+  return a && WsprEncoder::encode(type, call, grid, power, b) && std::equal(a, a + WsprEncoder::symbolCount, b);
+}
+
+int main() {
+  const Modulation::Mode wspr2 = Modulation::Mode::Wspr2;
+  const Modulation& wspr = Modulation::get(wspr2);
+
+  std::cout << "Keys" << std::endl;
+  {
+    auto a = MessageCache::keyFor(wspr2, Message::Type1, "k1abc", "FN42ax", 36);
+    auto b = MessageCache::keyFor(wspr2, Message::Type1, "K1ABC", "FN42bx", 37);
+    check(memcmp(&a, &b, sizeof(a)) == 0, "Type 1: case, subsquare and power rounding ignored");
+    auto c = MessageCache::keyFor(wspr2, Message::Type3, "K1ABC", "FN42ax", 37);
+    auto d = MessageCache::keyFor(wspr2, Message::Type3, "K1ABC", "FN42bx", 37);
+    check(memcmp(&c, &d, sizeof(c)) != 0, "Type 3: subsquare counts");
+    auto e = MessageCache::keyFor(wspr2, Message::Type2, "PJ4/K1ABC", "FN42", 37);
+    auto f = MessageCache::keyFor(wspr2, Message::Type2, "PJ4/K1ABC", "FK52", 37);
+    check(memcmp(&e, &f, sizeof(e)) == 0, "Type 2: no locator");
+  }
+
+  std::cout << "Lookups" << std::endl;
+  {
+    MessageCache cache;
+    auto k1 = MessageCache::keyFor(wspr2, Message::Type1, "K1ABC", "FN42ax", 37);
+    auto k3 = MessageCache::keyFor(wspr2, Message::Type3, "K1ABC", "FN42ax", 37);
+    check(cache.find(k1) == nullptr && cache.stats().misses == 0, "Find never encodes");
+    const uint8_t* s1 = cache.get(k1);
+    check(sameSymbols(s1, Message::Type1, "K1ABC", "FN42", 37), "Encoded on a miss");
+    cache.get(k3);
+    check(cache.find(k1) == s1 && cache.stats().misses == 2 && cache.stats().hits == 1, "Then found in place");
+
+    // A GNSS move within the square re-encodes type 3 only
+    auto k1moved = MessageCache::keyFor(wspr2, Message::Type1, "K1ABC", "FN42bx", 37);
+    auto k3moved = MessageCache::keyFor(wspr2, Message::Type3, "K1ABC", "FN42bx", 37);
+    cache.get(k1moved);
+    check(cache.stats().misses == 2, "Type 1 kept across a subsquare move");
+    check(sameSymbols(cache.get(k3moved), Message::Type3, "K1ABC", "FN42bx", 37) && cache.stats().misses == 3,
+	  "Type 3 re-encoded for the new subsquare");
+
+    // A power change is a new message for each type
+    cache.get(MessageCache::keyFor(wspr2, Message::Type1, "K1ABC", "FN42", 30));
+    check(cache.stats().misses == 4, "Power change re-encodes");
+
+    // Least recently used goes first
+    cache.get(k1);
+    cache.get(MessageCache::keyFor(wspr2, Message::Type1, "K1ABC", "FN42", 40));
+    check(cache.find(k1) != nullptr && cache.find(k3) == nullptr, "Least recently used evicted");
+
+    auto bad = MessageCache::keyFor(wspr2, Message::Type2, "K1ABC", "FN42", 37);
+    check(cache.get(bad) == nullptr && cache.stats().failures == 1 &&
+	  sameSymbols(cache.find(k3moved), Message::Type3, "K1ABC", "FN42bx", 37),
+	  "Unencodable message refused without evicting");
+  }
+
+  std::cout << "Tone words" << std::endl;
+  {
+    const uint32_t clk = 180000000;
+    check(wspr.toneWord(14095600, 0, 6, clk) == (uint32_t)(((uint64_t)14095600 * 6 << 32) / clk),
+	  "Tone 0 is the dial frequency word");
+    // 40 m stays below the 7.5 MHz limit of 24 steps
+    bool exact = true;
+    for (uint8_t steps : { 6, 12, 24 }) {
+      for (int tone = 0; tone < 4; tone++) {
+	double hz = 7038600 + tone * WsprEncoder::toneSpacingHz;
+	double want = hz * steps / clk * 4294967296.0;
+	uint32_t got = wspr.toneWord(7038600, tone, steps, clk);
+	if (fabs(got - floor(want)) > 1.0) exact = false;
+      }
+    }
+    check(exact, "Fractional tone spacing kept at 6, 12 and 24 steps");
+
+    MessageCache cache;
+    const uint32_t* t = cache.tones(4, wspr2, 14095600, 6, clk);
+    bool even = t != nullptr && t[1] > t[0];
+    for (int i = 1; even && i < WsprEncoder::toneCount; i++) {
+      uint32_t step = t[i] - t[i - 1];
+      even = step + 1 >= t[1] - t[0] && step <= t[1] - t[0] + 1;
+    }
+    check(even, "Band table filled with evenly spaced tones");
+    uint32_t w1 = t[1];
+    t = cache.tones(4, wspr2, 14095600, 12, clk);
+    check(t[1] != w1 && t[1] == wspr.toneWord(14095600, 1, 12, clk), "Recomputed for a new step count");
+    check(cache.tones(99, wspr2, 14095600, 6, clk) == nullptr, "Band out of range");
+  }
+
+  std::cout << (failures ? "MessageCache (FAIL)" : "MessageCache (OK)") << std::endl;
+  return failures ? 1 : 0;
+}
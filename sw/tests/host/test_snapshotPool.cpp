@@ -0,0 +1,107 @@
+// Host test for SnapshotPool: a writer publishing while readers take
+// and hold references must never let a reader see a half-written
+// value, and a held snapshot must not change under its holder.
+#include "snapshotPool.hpp"
+#include <iostream>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using wspr::SnapshotPool;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+  std::cout << "  " << what << (ok ? " (OK)" : " (FAIL)") << std::endl;
+  if (!ok) failures++;
+}
+
+// Every word equal when consistent; large enough that copying it is
+// not a single store
+struct Value {
+  uint32_t words[64];
+  void fill(uint32_t v) { for (auto& w : words) w = v; }
+  bool consistent() const {
+    for (auto w : words) if (w != words[0]) return false;
+    return true;
+  }
+};
+
+int main() {
+  std::cout << "Single thread" << std::endl;
+  {
+    SnapshotPool<Value, 3> pool;
+    check(!pool.acquire(), "Empty before the first publish");
+
+    Value v;
+    v.fill(1);
+    check(pool.publish(v), "First publish");
+    auto a = pool.acquire();
+    check(a && (*a).words[0] == 1 && a.generation() == 1, "Reference to the first snapshot");
+
+    v.fill(2);
+    pool.publish(v);
+    auto b = pool.acquire();
+    check(a->words[0] == 1 && b->words[0] == 2, "Held snapshot unchanged by a publish");
+
+    // Two held, the third current: no slot is free
+    v.fill(3);
+    check(pool.publish(v), "Publish into the spare slot");
+    v.fill(4);
+    check(!pool.publish(v), "Publish refused while every other slot is held");
+    a = SnapshotPool<Value, 3>::Ref();
+    check(pool.publish(v) && pool.acquire()->words[0] == 4, "Publish succeeds once one is released");
+    check(b->words[0] == 2, "Other holder still unchanged");
+  }
+
+  std::cout << "Concurrent readers" << std::endl;
+  {
+    SnapshotPool<Value, 6> pool;
+    Value v;
+    v.fill(0);
+    pool.publish(v);
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> torn{0}, changed{0}, backwards{0};
+    std::atomic<long> reads{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; r++) {
+      readers.emplace_back([&, r] {
+        uint32_t last = 0;
+        while (!stop) {
+          auto s = pool.acquire();
+          uint32_t first = s->words[0];
+          if (!s->consistent()) torn++;
+          if (first < last) backwards++;
+          last = first;
+          // Some readers hold on for a while, like a transmitter over a slot
+          if (r == 0) std::this_thread::yield();
+          if (s->words[0] != first || !s->consistent()) changed++;
+          reads++;
+        }
+      });
+    }
+
+    int refused = 0;
+    for (uint32_t i = 1; i <= 200000; i++) {
+      v.fill(i);
+      while (!pool.publish(v)) {
+        refused++;
+        std::this_thread::yield();
+      }
+    }
+    stop = true;
+    for (auto& t : readers) t.join();
+
+    std::cout << "  " << reads << " reads, " << refused << " publishes retried" << std::endl;
+    check(torn == 0, "No torn snapshot");
+    check(changed == 0, "No snapshot changed while held");
+    check(backwards == 0, "Readers never go back to an older snapshot");
+    check(pool.acquire()->words[0] == 200000 && pool.generation() == 200001, "Last publish is current");
+  }
+
+  std::cout << (failures ? "SnapshotPool (FAIL)" : "SnapshotPool (OK)") << std::endl;
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,133 @@
+// Host test for SolarCalc: sunrise and sunset against published tables
+// (USNO / timeanddate.com, converted to UTC) across latitudes, polar
+// day and night, locator conversion and the memo cache.
+#include "solarCalc.hpp"
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cmath>
+#include <cstdlib>
+
+using wspr::SolarCalc;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+  std::cout << "  " << what << (ok ? " (OK)" : " (FAIL)") << std::endl;
+  if (!ok) failures++;
+}
+
+// Days since 1970-01-01 of a civil date
+static int32_t dayNumber(int y, int m, int d) {
+  y -= m <= 2;
+  int era = (y >= 0 ? y : y - 399) / 400;
+  int yoe = y - era * 400;
+  int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+// Minutes apart on the 24 h circle
+static int circularDiff(int a, int b) {
+  int d = abs(a - b) % 1440;
+  return d > 720 ? 1440 - d : d;
+}
+
+struct Reference {
+  const char* place;
+  double lat, lon;
+  int y, m, d;
+  int riseUtc, setUtc;	// hhmm
+};
+
+static const Reference table[] = {
+  {"Greenwich",   51.4779,   -0.0015, 2024,  6, 21,  343, 2021},
+  {"Greenwich",   51.4779,   -0.0015, 2024, 12, 21,  804, 1554},
+  {"Equator",      0.0,       0.0,    2024,  3, 20,  604, 1810},
+  {"New York",    40.7128,  -74.0060, 2024, 12, 21, 1216, 2132},
+  {"Denver",      39.7392, -104.9903, 2024,  3, 10, 1318,  102},
+  {"Sydney",     -33.8688,  151.2093, 2024, 12, 21, 1841,  905},
+  {"Cape Town",  -33.9249,   18.4241, 2024,  6, 21,  551, 1545},
+  {"Reykjavik",   64.1466,  -21.9426, 2024,  6, 21,  255,    4},
+};
+
+int main() {
+  std::cout << "Published sunrise and sunset" << std::endl;
+  {
+    int worst = 0;
+    for (const auto& r : table) {
+      auto day = SolarCalc::compute(dayNumber(r.y, r.m, r.d), r.lat, r.lon);
+      int rise = r.riseUtc / 100 * 60 + r.riseUtc % 100;
+      int set = r.setUtc / 100 * 60 + r.setUtc % 100;
+      int err = std::max(circularDiff(day.sunriseMin, rise), circularDiff(day.sunsetMin, set));
+      worst = std::max(worst, err);
+      std::cout << "  " << std::setw(10) << r.place << "  " << r.y << "-" << r.m << "-" << r.d
+                << "  rise " << day.sunriseMin / 60 << ":" << std::setfill('0') << std::setw(2) << day.sunriseMin % 60
+                << "  set " << day.sunsetMin / 60 << ":" << std::setw(2) << day.sunsetMin % 60
+                << std::setfill(' ') << "  error " << err << " min" << std::endl;
+      if (day.sky != SolarCalc::Sky::Normal) worst = 99;
+    }
+    check(worst <= 2, "All within 2 minutes");
+  }
+
+  std::cout << "Polar day and night" << std::endl;
+  {
+    auto tromsoWinter = SolarCalc::compute(dayNumber(2024, 12, 21), 69.6492, 18.9553);
+    auto tromsoSummer = SolarCalc::compute(dayNumber(2024, 6, 21), 69.6492, 18.9553);
+    auto mcmurdoWinter = SolarCalc::compute(dayNumber(2024, 6, 21), -77.85, 166.67);
+    auto mcmurdoSummer = SolarCalc::compute(dayNumber(2024, 12, 21), -77.85, 166.67);
+    check(tromsoWinter.sky == SolarCalc::Sky::PolarNight && tromsoWinter.daylightMin == 0, "Tromso polar night");
+    check(tromsoSummer.sky == SolarCalc::Sky::PolarDay && tromsoSummer.daylightMin == 1440, "Tromso midnight sun");
+    check(mcmurdoWinter.sky == SolarCalc::Sky::PolarNight, "McMurdo polar night in June");
+    check(mcmurdoSummer.sky == SolarCalc::Sky::PolarDay, "McMurdo polar day in December");
+    // 12:00 less 76 min for the longitude and 2 min equation of time
+    check(circularDiff(tromsoWinter.noonMin, 720 - 76 - 2) <= 1, "Solar noon still given in polar night");
+
+    // Tromso midnight sun runs 20 May to 22 July
+    check(SolarCalc::compute(dayNumber(2024, 5, 15), 69.6492, 18.9553).sky == SolarCalc::Sky::Normal &&
+          SolarCalc::compute(dayNumber(2024, 5, 25), 69.6492, 18.9553).sky == SolarCalc::Sky::PolarDay &&
+          SolarCalc::compute(dayNumber(2024, 7, 27), 69.6492, 18.9553).sky == SolarCalc::Sky::Normal,
+          "Midnight sun season edges");
+    check(SolarCalc::compute(dayNumber(2024, 6, 21), 90.0, 0.0).sky == SolarCalc::Sky::PolarDay &&
+          SolarCalc::compute(dayNumber(2024, 12, 21), 90.0, 0.0).sky == SolarCalc::Sky::PolarNight,
+          "North pole");
+  }
+
+  std::cout << "Locators" << std::endl;
+  {
+    double lat, lon;
+    check(SolarCalc::gridToLatLon("JO62", lat, lon) && lat == 52.5 && lon == 13.0, "4-character centre");
+    check(SolarCalc::gridToLatLon("jo62qm", lat, lon) && fabs(lat - 52.52083) < 1e-4 && fabs(lon - 13.375) < 1e-4,
+          "6-character centre, lower case");
+    check(SolarCalc::gridToLatLon("FN20", lat, lon) && lat == 40.5 && lon == -75.0, "Western hemisphere");
+    check(!SolarCalc::gridToLatLon("ZZ00", lat, lon) && !SolarCalc::gridToLatLon("JO6", lat, lon) &&
+          !SolarCalc::gridToLatLon("JO62q", lat, lon) && !SolarCalc::gridToLatLon(nullptr, lat, lon),
+          "Malformed locators refused");
+  }
+
+  std::cout << "Memo cache" << std::endl;
+  {
+    SolarCalc calc;
+    const int64_t t = (int64_t)dayNumber(2024, 6, 21) * 86400;
+    auto a = calc.get(t + 3600, 51.4779, -0.0015);
+    auto b = calc.get(t + 80000, 51.4701, -0.0099);
+    check(calc.stats().misses == 1 && calc.stats().hits == 1, "Same day and cell computed once");
+    check(a.sunriseMin == b.sunriseMin && a.sunsetMin == b.sunsetMin, "Cell shares a result");
+    auto direct = SolarCalc::compute(dayNumber(2024, 6, 21), 51.4779, -0.0015);
+    check(circularDiff(a.sunriseMin, direct.sunriseMin) <= 1, "Cell centre within a minute of the position");
+
+    calc.get(t + 86400, 51.4779, -0.0015);
+    calc.get(t, 40.7128, -74.0060);
+    calc.get(t, -33.8688, 151.2093);
+    check(calc.stats().misses == 4, "New day and new cells computed");
+    calc.get(t + 3600, 51.4779, -0.0015);
+    check(calc.stats().misses == 4, "Four entries kept");
+    calc.get(t, 64.1466, -21.9426);		// Evicts the least recently used
+    calc.get(t + 3600, 51.4779, -0.0015);
+    calc.get(t + 86400, 51.4779, -0.0015);
+    check(calc.stats().misses == 6, "Least recently used entry evicted");
+  }
+
+  std::cout << (failures ? "SolarCalc (FAIL)" : "SolarCalc (OK)") << std::endl;
+  return failures ? 1 : 0;
+}
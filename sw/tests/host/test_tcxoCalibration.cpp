@@ -0,0 +1,68 @@
+// Host test for TcxoCalibration: save policy, aging fit and prediction
+#include "tcxoCalibration.hpp"
+#include <iostream>
+#include <cstdint>
+#include <cmath>
+
+using wspr::TcxoCalibration;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+  std::cout << "  " << what << (ok ? " (OK)" : " (FAIL)") << std::endl;
+  if (!ok) failures++;
+}
+
+int main() {
+  const int64_t t0 = 1760000000;	// Any GNSS time
+  const int64_t day = 86400;
+
+  std::cout << "Save policy" << std::endl;
+  {
+    TcxoCalibration cal;
+    check(!cal.valid() && cal.predict(t0) == 0.0, "Empty record predicts no error");
+    check(!cal.update(1.0, 0), "No save without GNSS time");
+    check(cal.update(1.0, t0) && cal.valid(), "First measurement saved");
+    check(!cal.update(1.01, t0 + 60), "Small move not saved");
+    check(cal.update(1.05, t0 + 120), "Move beyond savePpm saved");
+    check(cal.update(1.05, t0 + 120 + TcxoCalibration::saveIntervalSec), "Saved again after the interval");
+    check(cal.record().ratePpmPerDay == 0.0, "No aging from a few hours");
+  }
+
+  std::cout << "Aging 0.004 ppm/day over 30 days" << std::endl;
+  {
+    TcxoCalibration cal;
+    const double rate = 0.004;
+    for (int64_t t = 0; t <= 30 * day; t += 3600) {
+      // Half a day temperature wobble on top of the aging
+      double ppm = 0.8 + rate * t / day + 0.003 * sin(2 * M_PI * t / (day / 2.0));
+      cal.update(ppm, t0 + t);
+    }
+    double fit = cal.record().ratePpmPerDay;
+    std::cout << "  fitted " << fit << " ppm/day over " << cal.record().saves << " saves" << std::endl;
+    check(fabs(fit - rate) < 0.001, "Rate recovered");
+
+    double last = cal.record().ppm;
+    int64_t lastTime = cal.record().unixTime;
+    check(cal.predict(0) == last, "Unknown time predicts the stored error");
+    check(fabs(cal.predict(lastTime + 10 * day) - (last + 10 * fit)) < 1e-9, "Prediction ages linearly");
+    check(fabs(cal.predict(lastTime + 5000 * day) - (last + 365 * fit)) < 1e-9, "Prediction capped at a year");
+
+    TcxoCalibration copy;
+    TcxoCalibration::Record r = cal.record();
+    check(copy.load(r) && copy.predict(lastTime) == last, "Record reloads");
+    r.version = TcxoCalibration::recordVersion + 1;
+    check(!copy.load(r), "Other record versions refused");
+  }
+
+  std::cout << "Temperature step mistaken for aging" << std::endl;
+  {
+    TcxoCalibration cal;
+    cal.update(0.0, t0);
+    cal.update(1.0, t0 + 3 * day);
+    check(cal.record().ratePpmPerDay == TcxoCalibration::maxRatePpmPerDay, "Rate clamped");
+  }
+
+  std::cout << (failures ? "TcxoCalibration (FAIL)" : "TcxoCalibration (OK)") << std::endl;
+  return failures ? 1 : 0;
+}
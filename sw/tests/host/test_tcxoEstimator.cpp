@@ -0,0 +1,158 @@
+// Host test for TcxoEstimator: plays synthetic GNSS PPS edges with
+// jitter through a model of the FPGA PPS register and checks the
+// estimate, the Allan deviation and the missed edge and outlier paths.
+#include "tcxoEstimator.hpp"
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cmath>
+#include <random>
+
+using wspr::TcxoEstimator;
+
+static const double halfClocksPerSec = 180e6;	// FPGA PPS stamp, 2 x 90 MHz
+static const double jitterSec = 15e-9;		// GNSS PPS jitter, one sigma
+static const int pollMs = 250;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+  std::cout << "  " << what << (ok ? " (OK)" : " (FAIL)") << std::endl;
+  if (!ok) failures++;
+}
+
+// FPGA PPS register: a 28-bit half-clock stamp and a 4-bit edge count,
+// clocked by a reference that is errPpm off
+struct PPSModel {
+  double errPpm;
+  std::mt19937 rng{1234};
+  std::normal_distribution<double> jitter{0.0, jitterSec};
+  uint32_t stamp = 0;
+  uint8_t gen = 0;
+
+  void edgeAt(double t) {
+    double counts = floor(t * halfClocksPerSec * (1.0 + errPpm * 1e-6));
+    stamp = (uint32_t)fmod(counts, 268435456.0);
+    gen = (gen + 1) & 0xF;
+  }
+};
+
+struct Scenario {
+  double errPpm = 1.234;
+  int seconds = 2000;
+  double missProb = 0;		// Chance a poll stalls for 1.5 to 40 s
+  double glitchProb = 0;	// Chance of a spurious edge in a second
+};
+
+static void run(TcxoEstimator& est, const Scenario& sc, PPSModel& pps) {
+  std::mt19937 rng(99);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+
+  int64_t nowMs = 0;
+  int nextEdge = 1;
+  int64_t stallUntilMs = 0;
+  while (nowMs < sc.seconds * 1000LL) {
+    nowMs += pollMs;
+    double t = nowMs / 1000.0;
+    while (nextEdge <= t) {
+      pps.edgeAt(nextEdge + pps.jitter(pps.rng));
+      if (u(rng) < sc.glitchProb) pps.edgeAt(nextEdge + 0.1 + 0.8 * u(rng));
+      nextEdge++;
+    }
+    if (nowMs < stallUntilMs) continue;
+    if (u(rng) < sc.missProb) stallUntilMs = nowMs + 1500 + (int64_t)(38500 * u(rng));
+    est.addStamp(pps.stamp, pps.gen, nowMs);
+  }
+}
+
+int main() {
+  // Phase noise per edge: jitter plus the 5.6 ns stamp quantization
+  double sigmaX = sqrt(jitterSec * jitterSec + 1.0 / (12 * halfClocksPerSec * halfClocksPerSec));
+
+  std::cout << "Clean PPS, +1.234 ppm" << std::endl;
+  {
+    TcxoEstimator est(halfClocksPerSec, 28, 4);
+    Scenario sc;
+    PPSModel pps{sc.errPpm};
+    run(est, sc, pps);
+
+    auto e = est.estimate();
+    auto s = est.stats();
+    // White phase noise: one gate scatters by sqrt(2) sigmaX / tau
+    double expect = sqrt(2.0) * sigmaX / 100 * 1e6;
+    std::cout << std::setprecision(6) << "  estimate " << e.ppm << " +/- " << e.uncertaintyPpm
+              << " ppm over " << e.tauSec << " s" << std::endl;
+    check(e.valid && e.tauSec == 100, "Estimate over the 100 s gate");
+    check(fabs(e.ppm - sc.errPpm) < 4 * expect, "Estimate within 4 sigma");
+    check(e.uncertaintyPpm > expect / 2 && e.uncertaintyPpm < expect * 2, "Uncertainty matches the scatter");
+    check(s.missed == 0 && s.rejected == 0, "No missed or rejected edges");
+
+    // Non-overlapping ADEV of white phase noise is sqrt(3) sigmaX / tau
+    TcxoEstimator::AdevPoint table[TcxoEstimator::nTableGates];
+    int n = est.adevTable(table, TcxoEstimator::nTableGates);
+    bool shape = true;
+    for (int i = 0; i < n; i++) {
+      double model = sqrt(3.0) * sigmaX / table[i].tauSec * 1e6;
+      std::cout << "  tau " << std::setw(4) << table[i].tauSec << "  pairs " << std::setw(4) << table[i].pairs
+                << "  adev " << table[i].adevPpm << "  model " << model << std::endl;
+      // Tolerance from the chi-squared spread of the pair count
+      if (table[i].pairs >= 8) {
+        double tol = 3.0 / sqrt(table[i].pairs);
+        if (fabs(table[i].adevPpm / model - 1.0) > tol) shape = false;
+      }
+    }
+    check(n == TcxoEstimator::nTableGates, "Full ADEV table");
+    check(shape, "ADEV follows white phase noise");
+  }
+
+  std::cout << "Missed edges, -2.5 ppm" << std::endl;
+  {
+    TcxoEstimator est(halfClocksPerSec, 28, 4);
+    Scenario sc;
+    sc.errPpm = -2.5;
+    sc.seconds = 4000;
+    sc.missProb = 0.002;
+    PPSModel pps{sc.errPpm};
+    run(est, sc, pps);
+
+    auto e = est.estimate();
+    auto s = est.stats();
+    std::cout << "  estimate " << e.ppm << " ppm, " << s.missed << " missed" << std::endl;
+    check(s.missed > 0 && s.rejected == 0, "Stalls counted as missed edges, none rejected");
+    check(e.valid && fabs(e.ppm - sc.errPpm) < 0.002, "Estimate holds across stalls");
+  }
+
+  std::cout << "Glitches on the PPS line" << std::endl;
+  {
+    TcxoEstimator est(halfClocksPerSec, 28, 4);
+    Scenario sc;
+    sc.errPpm = 0.5;
+    sc.glitchProb = 0.002;
+    PPSModel pps{sc.errPpm};
+    run(est, sc, pps);
+
+    auto e = est.estimate();
+    auto s = est.stats();
+    std::cout << "  estimate " << e.ppm << " ppm, " << s.rejected << " rejected" << std::endl;
+    check(s.rejected > 0, "Glitches rejected");
+    check(e.valid && fabs(e.ppm - sc.errPpm) < 0.002, "Estimate unaffected");
+  }
+
+  std::cout << "Gate configuration" << std::endl;
+  {
+    TcxoEstimator est(halfClocksPerSec, 28, 4);
+    check(est.setGate(0) < 0 && est.setGate(1001) < 0, "Gates outside 1-1000 s refused");
+    check(est.setGate(1000) == 0 && est.gate() == 1000, "1000 s gate accepted");
+    Scenario sc;
+    sc.seconds = 300;
+    PPSModel pps{sc.errPpm};
+    run(est, sc, pps);
+    auto e = est.estimate();
+    check(e.valid && e.tauSec >= 298 && e.tauSec < 1000, "Part gate reported before the first completes");
+    est.reset();
+    check(!est.estimate().valid && est.stats().edges == 0, "Reset clears the estimate");
+  }
+
+  std::cout << (failures ? "TcxoEstimator (FAIL)" : "TcxoEstimator (OK)") << std::endl;
+  return failures ? 1 : 0;
+}
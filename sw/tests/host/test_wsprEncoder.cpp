@@ -0,0 +1,194 @@
+// Host test for WsprEncoder: the K1ABC FN42 37 example from WSJT-X's
+// wsprcode, and every message type decoded back (the code is inverted
+// bit by bit, then unpacked by the rules of the WSPR decoder).
+#include "wsprEncoder.hpp"
+#include <iostream>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+
+using wspr::WsprEncoder;
+using Message = wspr::BandPlanner::Message;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+  std::cout << "  " << what << (ok ? " (OK)" : " (FAIL)") << std::endl;
+  if (!ok) failures++;
+}
+
+static const uint8_t k1abcSymbols[WsprEncoder::symbolCount] = {
+  3, 3, 0, 0, 2, 0, 0, 0, 1, 0, 2, 0, 1, 3, 1, 2, 2, 2, 1, 0, 0, 3, 2, 3, 1, 3, 3, 2, 2, 0, 2, 0, 0, 0, 3, 2,
+  0, 1, 2, 3, 2, 2, 0, 0, 2, 2, 3, 2, 1, 1, 0, 2, 3, 3, 2, 1, 0, 2, 2, 1, 3, 2, 1, 2, 2, 2, 0, 3, 3, 0, 3, 0,
+  3, 0, 1, 2, 1, 0, 2, 1, 2, 0, 3, 2, 1, 3, 2, 0, 0, 3, 3, 2, 3, 0, 3, 2, 2, 0, 3, 0, 2, 0, 2, 0, 1, 0, 2, 3,
+  0, 2, 1, 1, 1, 2, 3, 3, 0, 2, 3, 1, 2, 1, 2, 2, 2, 1, 3, 3, 2, 0, 0, 0, 0, 1, 0, 3, 2, 0, 1, 3, 2, 2, 2, 2,
+  2, 0, 2, 3, 3, 2, 3, 2, 3, 3, 2, 0, 0, 3, 1, 2, 2, 2,
+};
+
+struct Decoded {
+  bool ok;
+  Message type;
+  std::string call;	// Type 3: the hash as "<nnnnn>"
+  std::string grid;
+  int power;
+};
+
+static char unpackChar(int c) {
+  return c < 10 ? (char)('0' + c) : c < 36 ? (char)('A' + c - 10) : ' ';
+}
+
+static std::string trim(const std::string& s) {
+  size_t a = s.find_first_not_of(' '), b = s.find_last_not_of(' ');
+  return a == std::string::npos ? "" : s.substr(a, b - a + 1);
+}
+
+static std::string unpackCall(uint32_t n) {
+  char c[7] = {};
+  for (int i = 5; i >= 3; i--) { c[i] = unpackChar((int)(n % 27) + 10); n /= 27; }
+  c[2] = unpackChar((int)(n % 10)); n /= 10;
+  c[1] = unpackChar((int)(n % 36)); n /= 36;
+  c[0] = unpackChar((int)n);
+  return trim(c);
+}
+
+static Decoded decode(const uint8_t* symbols) {
+  Decoded d = {};
+  // Sync on the low bit, data on the high bit, interleaved
+  uint8_t coded[WsprEncoder::symbolCount];
+  for (int i = 0, p = 0; p < WsprEncoder::symbolCount; i++) {
+    int j = 0;
+    for (int b = 0; b < 8; b++) j |= ((i >> b) & 1) << (7 - b);
+    if (j < WsprEncoder::symbolCount) coded[p++] = symbols[j] >> 1;
+  }
+
+  // Both polynomials tap the newest bit, so each is recovered from the
+  // first parity and checked against the second
+  uint32_t reg = 0;
+  uint64_t bits = 0;
+  for (int i = 0; i < 81; i++) {
+    uint32_t next = reg << 1;
+    if ((uint8_t)__builtin_parity(next & 0xf2d05351) != coded[2 * i]) next |= 1;
+    if ((uint8_t)__builtin_parity(next & 0xe4613c47) != coded[2 * i + 1]) return d;
+    reg = next;
+    if (i < 50) bits = (bits << 1) | (next & 1);
+    else if (next & 1) return d;
+  }
+
+  uint32_t n = (uint32_t)(bits >> 22);
+  uint32_t m = (uint32_t)(bits & 0x3fffff);
+  int ntype = (int)(m % 128) - 64;
+  uint32_t ng = m / 128;
+  d.ok = true;
+
+  if (ntype < 0) {
+    d.type = Message::Type3;
+    d.power = -(ntype + 1);
+    d.call = "<" + std::to_string(ng) + ">";
+    std::string r = unpackCall(n);
+    d.grid = r.size() == 6 ? r.substr(5) + r.substr(0, 5) : "?";
+    return d;
+  }
+
+  int nu = ntype % 10;
+  if (nu == 0 || nu == 3 || nu == 7) {
+    d.type = Message::Type1;
+    d.power = ntype;
+    d.call = unpackCall(n);
+    int lon = (int)(ng / 180), lat = (int)(ng % 180);
+    d.grid = { (char)('A' + (179 - lon) / 10), (char)('A' + lat / 10),
+	       (char)('0' + (179 - lon) % 10), (char)('0' + lat % 10) };
+    return d;
+  }
+
+  d.type = Message::Type2;
+  int nadd = (nu == 2 || nu == 5 || nu == 9) ? 1 : 0;
+  d.power = ntype - 1 - nadd;
+  uint32_t full = ng + 32768u * (uint32_t)nadd;
+  std::string base = unpackCall(n);
+  if (full < 60000) {
+    std::string pfx;
+    for (int i = 0; i < 3; i++) { pfx.insert(pfx.begin(), unpackChar((int)(full % 37))); full /= 37; }
+    d.call = trim(pfx) + "/" + base;
+  } else {
+    int nc = (int)(full - 60000);
+    if (nc < 36) d.call = base + "/" + unpackChar(nc);
+    else d.call = base + "/" + std::to_string(nc - 26);
+  }
+  return d;
+}
+
+static bool roundTrip(Message type, const char* call, const char* grid, int power,
+		      const std::string& wantCall, const std::string& wantGrid) {
+  uint8_t s[WsprEncoder::symbolCount];
+  if (!WsprEncoder::encode(type, call, grid, power, s)) return false;
+  Decoded d = decode(s);
+  return d.ok && d.type == type && d.call == wantCall && d.grid == wantGrid && d.power == power;
+}
+
+int main() {
+  std::cout << "Reference message" << std::endl;
+  {
+    uint8_t s[WsprEncoder::symbolCount];
+    bool ok = WsprEncoder::encode(Message::Type1, "K1ABC", "FN42", 37, s);
+    int same = 0;
+    for (int i = 0; i < WsprEncoder::symbolCount; i++) same += s[i] == k1abcSymbols[i];
+    check(ok && same == WsprEncoder::symbolCount, "K1ABC FN42 37 matches wsprcode");
+    uint8_t lower[WsprEncoder::symbolCount];
+    WsprEncoder::encode(Message::Type1, "k1abc", "fn42", 37, lower);
+    check(std::equal(s, s + WsprEncoder::symbolCount, lower), "Case does not matter");
+  }
+
+  std::cout << "Type 1" << std::endl;
+  {
+    check(roundTrip(Message::Type1, "K1ABC", "FN42", 37, "K1ABC", "FN42"), "K1ABC FN42 37");
+    check(roundTrip(Message::Type1, "G4JNT", "IO90", 30, "G4JNT", "IO90"), "G4JNT IO90 30");
+    check(roundTrip(Message::Type1, "DL1ABC", "JO62", 23, "DL1ABC", "JO62"), "Six characters");
+    check(roundTrip(Message::Type1, "2E0XYZ", "IO91", 0, "2E0XYZ", "IO91"), "Leading digit, 0 dBm");
+    check(roundTrip(Message::Type1, "VK2A", "QF56", 60, "VK2A", "QF56"), "Short callsign, 60 dBm");
+    check(roundTrip(Message::Type1, "K1ABC", "FN42ab", 33, "K1ABC", "FN42"), "Subsquare dropped");
+  }
+
+  std::cout << "Type 2" << std::endl;
+  {
+    check(roundTrip(Message::Type2, "PJ4/K1ABC", nullptr, 37, "PJ4/K1ABC", ""), "Three-character prefix");
+    check(roundTrip(Message::Type2, "F/G4JNT", nullptr, 30, "F/G4JNT", ""), "One-character prefix");
+    check(roundTrip(Message::Type2, "ZZ9/K1ABC", nullptr, 10, "ZZ9/K1ABC", ""), "Prefix past 32768");
+    check(roundTrip(Message::Type2, "K1ABC/P", nullptr, 23, "K1ABC/P", ""), "Letter suffix");
+    check(roundTrip(Message::Type2, "K1ABC/7", nullptr, 7, "K1ABC/7", ""), "Digit suffix");
+    check(roundTrip(Message::Type2, "K1ABC/47", nullptr, 40, "K1ABC/47", ""), "Two-digit suffix");
+  }
+
+  std::cout << "Type 3" << std::endl;
+  {
+    uint8_t s[WsprEncoder::symbolCount];
+    std::string hash = "<" + std::to_string(WsprEncoder::callHash("K1ABC")) + ">";
+    check(WsprEncoder::callHash("K1ABC") < 32768 && WsprEncoder::callHash("k1abc") == WsprEncoder::callHash("K1ABC"),
+	  "15-bit hash of the upper case call");
+    check(WsprEncoder::callHash("K1ABC") != WsprEncoder::callHash("K1ABD"), "Calls hash apart");
+    check(roundTrip(Message::Type3, "K1ABC", "FN42ax", 37, hash, "FN42AX"), "K1ABC FN42ax 37");
+    std::string compound = "<" + std::to_string(WsprEncoder::callHash("PJ4/K1ABC")) + ">";
+    check(roundTrip(Message::Type3, "PJ4/K1ABC", "FK52ua", 30, compound, "FK52UA"), "Compound call hashed whole");
+    check(!WsprEncoder::encode(Message::Type3, "K1ABC", "FN42", 37, s), "Needs six characters");
+  }
+
+  std::cout << "Power and refusals" << std::endl;
+  {
+    check(WsprEncoder::legalPower(37) == 37 && WsprEncoder::legalPower(36) == 37 &&
+	  WsprEncoder::legalPower(31) == 30 && WsprEncoder::legalPower(39) == 40 &&
+	  WsprEncoder::legalPower(-5) == 0 && WsprEncoder::legalPower(99) == 60, "Power rounds to 0/3/7");
+    uint8_t s[WsprEncoder::symbolCount];
+    check(roundTrip(Message::Type1, "K1ABC", "FN42", 30, "K1ABC", "FN42") &&
+	  WsprEncoder::encode(Message::Type1, "K1ABC", "FN42", 29, s) && decode(s).power == 30,
+	  "Illegal power sent rounded");
+    check(!WsprEncoder::encode(Message::Type1, "KABC", "FN42", 37, s), "No digit in callsign");
+    check(!WsprEncoder::encode(Message::Type1, "K1ABCDE", "FN42", 37, s), "Callsign too long");
+    check(!WsprEncoder::encode(Message::Type1, "K1A2C", "FN42", 37, s), "Digit in suffix");
+    check(!WsprEncoder::encode(Message::Type1, "K1ABC", "SN42", 37, s), "Field past R");
+    check(!WsprEncoder::encode(Message::Type1, "K1ABC/P", "FN42", 37, s), "Compound call needs type 2");
+    check(!WsprEncoder::encode(Message::Type2, "K1ABC", nullptr, 37, s), "Type 2 needs a compound call");
+    check(!WsprEncoder::encode(Message::Type2, "PJ4A/K1ABC", nullptr, 37, s), "Prefix too long");
+  }
+
+  std::cout << (failures ? "WsprEncoder (FAIL)" : "WsprEncoder (OK)") << std::endl;
+  return failures ? 1 : 0;
+}
@@ -69,6 +69,7 @@ fi
 echo "Creating LittleFS image..."
 
 $PYTHON << EOF
+import gzip
 import os
 from littlefs import LittleFS
 
@@ -84,7 +85,10 @@ block_count = $LFS_SIZE // 4096
 # Create filesystem
 fs = LittleFS(block_size=block_size, block_count=block_count)
 
-# 1. Add web UI files
+# 1. Add web UI files, text ones also gzipped (name.gz) for clients
+#    that take Content-Encoding: gzip; the server falls back to the
+#    plain file for the rest
+compressible = ('.html', '.htm', '.js', '.css', '.svg', '.json', '.txt')
 if os.path.exists(webui_dir):
     print(f"Adding web UI files from {webui_dir}:")
     for filename in os.listdir(webui_dir):
@@ -95,6 +99,13 @@ if os.path.exists(webui_dir):
             with fs.open('/' + filename, 'wb') as f:
                 f.write(data)
             print(f"  Added: {filename} ({len(data)} bytes)")
+            if filename.endswith(compressible):
+                # mtime 0 keeps the image reproducible
+                gz = gzip.compress(data, compresslevel=9, mtime=0)
+                if len(gz) < len(data):
+                    with fs.open('/' + filename + '.gz', 'wb') as f:
+                        f.write(gz)
+                    print(f"  Added: {filename}.gz ({len(gz)} bytes)")
 else:
     print(f"Warning: web UI directory {webui_dir} not found")
 
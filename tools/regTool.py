@@ -11,6 +11,11 @@ class Field:
     self.offset = 0
     self.name = ""
 
+  # "reserved", "reserved2"...: Python needs distinct names for the
+  # padding fields of one register, the outputs name them by offset
+  def reserved(self):
+    return self.name.rstrip("0123456789") == "reserved"
+
 class UInt(Field):
   def __init__(self, default, bits, doc=""):
     super().__init__(bits, default, doc, signed=False)
@@ -135,7 +140,7 @@ class RegisterSet:
           typeStr = f"enum {self.namespace}{reg.name}{f.name[0].upper()}{f.name[1:]}"
         
         fName = f.name
-        if fName == "reserved":
+        if f.reserved():
           fName = f"reserved{f.offset}"
         
         lines.append(f"{indent}{typeStr} {fName} : {f.bits};")
@@ -172,7 +177,7 @@ class RegisterSet:
       align = "|"
       for f in reversed(reg.fields):
         width = max(len(f.name), len(str(f.offset + f.bits - 1)) + 2)
-        if f.name == "reserved":
+        if f.reserved():
           displayName = f"_reserved_[{f.bits}]"
         else:
           displayName = f"{f.name}[{f.bits}]"
@@ -205,7 +210,7 @@ class RegisterSet:
           fType = "Int"
         
         displayName = f.name
-        if displayName == "reserved":
+        if f.reserved():
           displayName = f"_reserved_[{f.bits}]"
         
         lines.append(f"| {bitRange} | {displayName} | {fType} | {f.default} | {f.doc} |")
@@ -2,10 +2,14 @@
 
 #include "fs_hal.hpp"
 #include "config_manager.hpp"
+#include "planner_config.hpp"
+#include "solarCalc.hpp"
 #include <string>
 #include <functional>
 #include <map>
 #include <memory>
+#include <ctime>
+#include <mutex>
 
 /**
  * @brief HTTP Request structure
@@ -137,6 +141,8 @@ public:
 private:
   HAL::IFilesystem* filesystem;
   ConfigManager* config;
+  wspr::SolarCalc solar;  // Shared by the server threads
+  std::mutex solarMutex;
   std::map<std::string, Handler> routes;
 
   bool matchRoute(const std::string& pattern, const std::string& path) {
@@ -247,15 +253,62 @@ private:
     json << "    \"source\": \"tcxo\",\n";
     json << "    \"accuracyPpb\": 500\n";
     json << "  },\n";
+    json << "  \"tcxo\": {\n";
+    json << "    \"valid\": true,\n";
+    json << "    \"ppm\": 1.23412,\n";
+    json << "    \"uncertaintyPpm\": 0.00025,\n";
+    json << "    \"tauSec\": 100,\n";
+    json << "    \"gateSec\": 100,\n";
+    json << "    \"correctionPpm\": 1.23412,\n";
+    json << "    \"source\": \"measured\",\n";
+    json << "    \"adev\": [{\"tau\":1,\"pairs\":1999,\"adev\":2.634e-02},"
+            "{\"tau\":10,\"pairs\":199,\"adev\":2.620e-03},"
+            "{\"tau\":100,\"pairs\":19,\"adev\":2.440e-04}]\n";
+    json << "  },\n";
     json << "  \"pa\": {\n";
     json << "    \"tempC\": 25,\n";
     json << "    \"voltageV\": 5.0\n";
     json << "  },\n";
+    // Upcoming slots from the real planner, on the host clock
+    int64_t now = (int64_t)time(nullptr);
+    const WSPRConfig& cfg = config->getConfig();
+    wspr::BandPlanner::SunTimes sun;
+    double lat, lon;
+    if (wspr::SolarCalc::gridToLatLon(cfg.gridSquare.c_str(), lat, lon)) {
+      std::lock_guard<std::mutex> lock(solarMutex);
+      const auto& d = solar.get(now, lat, lon);
+      sun.known = true;
+      sun.sunriseMin = d.sunriseMin;
+      sun.sunsetMin = d.sunsetMin;
+      sun.daylightMin = d.daylightMin;
+    }
+    wspr::BandPlanner planner;
+    planner.compile(plannerConfig(cfg), sun);
+    planner.refill(now);
+    wspr::BandPlanner::Slot slots[wspr::BandPlanner::maxPlan];
+    int nSlots = planner.upcoming(slots, wspr::BandPlanner::maxPlan);
+
     json << "  \"tx\": {\n";
     json << "    \"active\": false,\n";
     json << "    \"band\": \"\",\n";
-    json << "    \"nextTxSec\": 120\n";
-    json << "  }\n";
+    json << "    \"nextTxSec\": " << (nSlots ? slots[0].startUnix - now : -1) << "\n";
+    json << "  },\n";
+    json << "  \"sun\": {\n";
+    json << "    \"known\": " << (sun.known ? "true" : "false") << ",\n";
+    json << "    \"sunriseMin\": " << sun.sunriseMin << ",\n";
+    json << "    \"sunsetMin\": " << sun.sunsetMin << ",\n";
+    json << "    \"daylightMin\": " << sun.daylightMin << "\n";
+    json << "  },\n";
+    json << "  \"plan\": [";
+    for (int i = 0; i < nSlots; i++) {
+      json << (i ? "," : "") << "{\"start\":" << slots[i].startUnix
+           << ",\"band\":\"" << wspr::BandTable::get(slots[i].band).name << "\""
+           << ",\"freqHz\":" << slots[i].freqHz
+           << ",\"lpf\":" << (int)slots[i].lpf
+           << ",\"mode\":\"" << wspr::Modulation::get(slots[i].mode).name << "\""
+           << ",\"message\":\"" << wspr::BandPlanner::messageName(slots[i].message) << "\"}";
+    }
+    json << "]\n";
     json << "}";
     res.setJson(json.str());
   }
@@ -5,6 +5,8 @@
 #include <array>
 #include <vector>
 
+#include "bandTable.hpp"
+
 /**
  * @brief WSPR-ease configuration structure
  *
@@ -33,14 +35,14 @@ struct WSPRConfig {
     int16_t endOffsetMin = 1440;   // Minutes from base (1440 = 24h, i.e., end of day)
   };
 
-  // Band Configuration (80m, 60m, 40m, 30m, 20m, 17m, 15m, 12m, 10m)
+  // Band Configuration, in wspr::BandTable order (160m to 10m)
   struct BandConfig {
     bool enabled = false;
     uint32_t freqHz = 0;
     TimeWindow timeWindow;         // When this band is eligible
   };
 
-  static constexpr int NUM_BANDS = 9;
+  static constexpr int NUM_BANDS = wspr::BandTable::count;
   std::array<BandConfig, NUM_BANDS> bands;
 
   // Scheduling
@@ -54,6 +56,7 @@ struct WSPRConfig {
   Mode mode = Mode::ROUND_ROBIN;
   std::string bandList;            // For LIST mode: "20m,20m,40m,30m" (repeats for weighting)
   uint16_t slotIntervalMin = 10;   // Minutes between transmissions
+  std::string txMode = "wspr2";    // Modulation name; wspr2 only so far
   uint8_t dutyCycle = 1;           // 1 out of N slots (1 = every slot)
 
   // Time Sources
@@ -90,30 +93,13 @@ struct WSPRConfig {
   uint16_t cooldownSec = 120;      // Cooldown after transmission
   bool enableBeacon = true;        // Master enable/disable
 
-  // Default band frequencies (dial frequency for WSPR sub-band)
-  static constexpr uint32_t BAND_FREQS[NUM_BANDS] = {
-    3568600,   // 80m
-    5287200,   // 60m
-    7038600,   // 40m
-    10138700,  // 30m
-    14095600,  // 20m
-    18104600,  // 17m
-    21094600,  // 15m
-    24924600,  // 12m
-    28124600   // 10m
-  };
-
-  static constexpr const char* BAND_NAMES[NUM_BANDS] = {
-    "80m", "60m", "40m", "30m", "20m", "17m", "15m", "12m", "10m"
-  };
-
   /**
    * @brief Initialize with default band frequencies
    */
   void initDefaults() {
     for (int i = 0; i < NUM_BANDS; i++) {
-      bands[i].freqHz = BAND_FREQS[i];
-      bands[i].enabled = (i == 4);  // Default: 20m only
+      bands[i].freqHz = wspr::BandTable::get(i).dialHz;
+      bands[i].enabled = (i == wspr::BandTable::index(wspr::BandTable::Id::Band20m));  // Default: 20m only
       bands[i].timeWindow.enabled = false;  // No time restriction by default
     }
     bandList = "20m";  // Default band list
@@ -2,7 +2,10 @@
 
 #include "config.hpp"
 #include "fs_hal.hpp"
+#include "json_reader.hpp"
+#include "modulation.hpp"
 #include <string>
+#include <limits>
 #include <sstream>
 #include <iomanip>
 
@@ -105,7 +108,7 @@ public:
       const auto& band = config.bands[i];
       const auto& tw = band.timeWindow;
       json << "    {\n";
-      json << "      \"name\": \"" << WSPRConfig::BAND_NAMES[i] << "\",\n";
+      json << "      \"name\": \"" << wspr::BandTable::get(i).name << "\",\n";
       json << "      \"enabled\": " << (band.enabled ? "true" : "false") << ",\n";
       json << "      \"freqHz\": " << band.freqHz << ",\n";
       json << "      \"timeWindow\": {\n";
@@ -122,6 +125,15 @@ public:
     json << "  \"mode\": \"" << modeToString(config.mode) << "\",\n";
     json << "  \"bandList\": \"" << escapeJson(config.bandList) << "\",\n";
     json << "  \"slotIntervalMin\": " << config.slotIntervalMin << ",\n";
+    json << "  \"txMode\": \"" << escapeJson(config.txMode) << "\",\n";
+    // Read only, for the UI: the modes this build can send
+    json << "  \"txModes\": [";
+    const char* sep = "";
+    for (int i = 0; i < wspr::Modulation::modeCount; i++) {
+      json << sep << "\"" << wspr::Modulation::get((wspr::Modulation::Mode)i).name << "\"";
+      sep = ", ";
+    }
+    json << "],\n";
     json << "  \"dutyCycle\": " << (int)config.dutyCycle << ",\n";
 
     json << "  \"timeSource\": \"" << timeSourceToString(config.timeSource) << "\",\n";
@@ -155,12 +167,76 @@ public:
   /**
    * @brief Deserialize JSON string to configuration
    *
-   * Note: This is a simple parser. For production, use nlohmann/json or similar.
+   * Accepts the layout written by toJson(). Keys that are absent keep
+   * their current values, so a partial document updates only what it
+   * names. Bands are matched by name. Nothing changes unless the whole
+   * document is valid.
    */
   bool fromJson(const std::string& jsonStr) {
-    // TODO: Implement JSON parsing
-    // For now, return false - will add proper parsing next
-    return false;
+    JsonValue root;
+    if (!JsonValue::parse(jsonStr, root) || !root.isObject()) return false;
+
+    WSPRConfig c = config;
+    bool ok = true;
+    readString(root, "callsign", c.callsign, ok);
+    readString(root, "gridSquare", c.gridSquare, ok);
+    readInt(root, "powerDbm", c.powerDbm, ok);
+
+    if (const JsonValue* bands = root.get("bands")) {
+      if (!bands->isArray()) return false;
+      for (size_t i = 0; i < bands->items.size(); i++) {
+        const JsonValue& b = bands->items[i];
+        if (!b.isObject()) return false;
+        int idx = (int)i;
+        if (const JsonValue* name = b.get("name")) idx = bandIndex(name->str);
+        if (idx < 0 || idx >= WSPRConfig::NUM_BANDS) return false;
+
+        auto& band = c.bands[idx];
+        readBool(b, "enabled", band.enabled, ok);
+        readInt(b, "freqHz", band.freqHz, ok);
+        if (const JsonValue* tw = b.get("timeWindow")) {
+          if (!tw->isObject()) return false;
+          readBool(*tw, "enabled", band.timeWindow.enabled, ok);
+          readEnum(*tw, "startBase", band.timeWindow.startBase, timeBaseToString, ok);
+          readInt(*tw, "startOffsetMin", band.timeWindow.startOffsetMin, ok);
+          readEnum(*tw, "endBase", band.timeWindow.endBase, timeBaseToString, ok);
+          readInt(*tw, "endOffsetMin", band.timeWindow.endOffsetMin, ok);
+        }
+      }
+    }
+
+    readEnum(root, "mode", c.mode, modeToString, ok);
+    readString(root, "bandList", c.bandList, ok);
+    readInt(root, "slotIntervalMin", c.slotIntervalMin, ok);
+    readString(root, "txMode", c.txMode, ok);
+    wspr::Modulation::Mode txMode;
+    if (!wspr::Modulation::fromName(c.txMode.c_str(), txMode)) ok = false;
+    readInt(root, "dutyCycle", c.dutyCycle, ok);
+
+    readEnum(root, "timeSource", c.timeSource, timeSourceToString, ok);
+    readString(root, "ntpServer", c.ntpServer, ok);
+    readInt(root, "timezoneOffset", c.timezoneOffset, ok);
+    readEnum(root, "locationSource", c.locationSource, locationSourceToString, ok);
+
+    if (const JsonValue* wifi = root.get("wifi")) {
+      readString(*wifi, "ssid", c.wifiSsid, ok);
+      readString(*wifi, "password", c.wifiPassword, ok);
+      readString(*wifi, "hostname", c.hostname, ok);
+    }
+    if (const JsonValue* auth = root.get("webAuth")) {
+      readString(*auth, "username", c.webUsername, ok);
+      readString(*auth, "password", c.webPassword, ok);
+    }
+    if (const JsonValue* adv = root.get("advanced")) {
+      readBool(*adv, "randomOffset", c.randomOffset, ok);
+      readInt(*adv, "paTempLimitC", c.paTempLimitC, ok);
+      readInt(*adv, "cooldownSec", c.cooldownSec, ok);
+      readBool(*adv, "enableBeacon", c.enableBeacon, ok);
+    }
+
+    if (!ok) return false;
+    config = c;
+    return true;
   }
 
 private:
@@ -168,6 +244,55 @@ private:
   std::string path;
   WSPRConfig config;
 
+  static void readString(const JsonValue& obj, const char* key, std::string& out, bool& ok) {
+    const JsonValue* v = obj.get(key);
+    if (!v) return;
+    if (v->type != JsonValue::Type::String) ok = false;
+    else out = v->str;
+  }
+
+  static void readBool(const JsonValue& obj, const char* key, bool& out, bool& ok) {
+    const JsonValue* v = obj.get(key);
+    if (!v) return;
+    if (v->type != JsonValue::Type::Bool) ok = false;
+    else out = v->boolValue;
+  }
+
+  // Whole numbers within the range of the field
+  template <typename T>
+  static void readInt(const JsonValue& obj, const char* key, T& out, bool& ok) {
+    const JsonValue* v = obj.get(key);
+    if (!v) return;
+    double n = v->number;
+    if (v->type != JsonValue::Type::Number || n != (double)(long long)n ||
+        n < (double)std::numeric_limits<T>::min() || n > (double)std::numeric_limits<T>::max()) {
+      ok = false;
+      return;
+    }
+    out = (T)n;
+  }
+
+  // An enum from the name its toString function gives it. Out of range
+  // values fall back to a default name, so the first match is the real one.
+  template <typename E>
+  static void readEnum(const JsonValue& obj, const char* key, E& out, std::string (*toString)(E), bool& ok) {
+    const JsonValue* v = obj.get(key);
+    if (!v) return;
+    if (v->type == JsonValue::Type::String) {
+      for (int i = 0; i < 8; i++) {
+        if (toString((E)i) == v->str) {
+          out = (E)i;
+          return;
+        }
+      }
+    }
+    ok = false;
+  }
+
+  static int bandIndex(const std::string& name) {
+    return wspr::BandTable::fromName(name.c_str());
+  }
+
   static std::string escapeJson(const std::string& str) {
     std::ostringstream escaped;
     for (char c : str) {
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdlib>
+
+/**
+ * @brief Minimal JSON reader
+ *
+ * Parses a document into a small tree. Enough for config.json and API
+ * request bodies; no external dependencies, like the JSON writers.
+ */
+class JsonValue {
+public:
+  enum class Type { Null, Bool, Number, String, Array, Object };
+
+  Type type = Type::Null;
+  bool boolValue = false;
+  double number = 0;
+  std::string str;
+  std::vector<JsonValue> items;
+  std::map<std::string, JsonValue> members;
+
+  bool isObject() const { return type == Type::Object; }
+  bool isArray() const { return type == Type::Array; }
+
+  /**
+   * @brief Member of an object, or nullptr if absent
+   */
+  const JsonValue* get(const std::string& key) const {
+    if (type != Type::Object) return nullptr;
+    auto it = members.find(key);
+    return it == members.end() ? nullptr : &it->second;
+  }
+
+  /**
+   * @brief Parse a document
+   *
+   * @return false on a syntax error or trailing garbage
+   */
+  static bool parse(const std::string& text, JsonValue& out) {
+    size_t pos = 0;
+    if (!parseValue(text, pos, out, 0)) return false;
+    skipSpace(text, pos);
+    return pos == text.size();
+  }
+
+private:
+  static const int maxDepth = 32;
+
+  static void skipSpace(const std::string& s, size_t& pos) {
+    while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\t' || s[pos] == '\n' || s[pos] == '\r')) pos++;
+  }
+
+  static bool literal(const std::string& s, size_t& pos, const char* word) {
+    size_t n = std::char_traits<char>::length(word);
+    if (s.compare(pos, n, word) != 0) return false;
+    pos += n;
+    return true;
+  }
+
+  static bool parseString(const std::string& s, size_t& pos, std::string& out) {
+    if (pos >= s.size() || s[pos] != '"') return false;
+    pos++;
+    out.clear();
+    while (pos < s.size()) {
+      char c = s[pos++];
+      if (c == '"') return true;
+      if (c != '\\') {
+        out += c;
+        continue;
+      }
+      if (pos >= s.size()) return false;
+      char e = s[pos++];
+      switch (e) {
+        case '"': out += '"'; break;
+        case '\\': out += '\\'; break;
+        case '/': out += '/'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case 't': out += '\t'; break;
+        case 'u': {
+          if (pos + 4 > s.size()) return false;
+          unsigned cp = (unsigned)strtoul(s.substr(pos, 4).c_str(), nullptr, 16);
+          pos += 4;
+          // UTF-8, basic multilingual plane only
+          if (cp < 0x80) {
+            out += (char)cp;
+          } else if (cp < 0x800) {
+            out += (char)(0xC0 | (cp >> 6));
+            out += (char)(0x80 | (cp & 0x3F));
+          } else {
+            out += (char)(0xE0 | (cp >> 12));
+            out += (char)(0x80 | ((cp >> 6) & 0x3F));
+            out += (char)(0x80 | (cp & 0x3F));
+          }
+          break;
+        }
+        default: return false;
+      }
+    }
+    return false;
+  }
+
+  static bool parseValue(const std::string& s, size_t& pos, JsonValue& out, int depth) {
+    if (depth > maxDepth) return false;
+    skipSpace(s, pos);
+    if (pos >= s.size()) return false;
+
+    char c = s[pos];
+    if (c == '{') {
+      out.type = Type::Object;
+      pos++;
+      skipSpace(s, pos);
+      if (pos < s.size() && s[pos] == '}') { pos++; return true; }
+      while (true) {
+        std::string key;
+        skipSpace(s, pos);
+        if (!parseString(s, pos, key)) return false;
+        skipSpace(s, pos);
+        if (pos >= s.size() || s[pos] != ':') return false;
+        pos++;
+        if (!parseValue(s, pos, out.members[key], depth + 1)) return false;
+        skipSpace(s, pos);
+        if (pos < s.size() && s[pos] == ',') { pos++; continue; }
+        if (pos < s.size() && s[pos] == '}') { pos++; return true; }
+        return false;
+      }
+    }
+    if (c == '[') {
+      out.type = Type::Array;
+      pos++;
+      skipSpace(s, pos);
+      if (pos < s.size() && s[pos] == ']') { pos++; return true; }
+      while (true) {
+        out.items.emplace_back();
+        if (!parseValue(s, pos, out.items.back(), depth + 1)) return false;
+        skipSpace(s, pos);
+        if (pos < s.size() && s[pos] == ',') { pos++; continue; }
+        if (pos < s.size() && s[pos] == ']') { pos++; return true; }
+        return false;
+      }
+    }
+    if (c == '"') {
+      out.type = Type::String;
+      return parseString(s, pos, out.str);
+    }
+    if (literal(s, pos, "true")) { out.type = Type::Bool; out.boolValue = true; return true; }
+    if (literal(s, pos, "false")) { out.type = Type::Bool; out.boolValue = false; return true; }
+    if (literal(s, pos, "null")) { out.type = Type::Null; return true; }
+
+    const char* start = s.c_str() + pos;
+    char* end = nullptr;
+    out.number = strtod(start, &end);
+    if (end == start) return false;
+    out.type = Type::Number;
+    pos += end - start;
+    return true;
+  }
+};
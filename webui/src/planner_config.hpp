@@ -0,0 +1,61 @@
+#pragma once
+
+#include "config.hpp"
+#include "bandPlanner.hpp"
+#include <string>
+
+// Translation of the web UI configuration for the firmware's band
+// planner, shared by the mock server and the schedule simulator.
+
+inline wspr::BandPlanner::TimeBase plannerTimeBase(WSPRConfig::TimeWindow::TimeBase base) {
+  switch (base) {
+    case WSPRConfig::TimeWindow::TimeBase::UTC: return wspr::BandPlanner::TimeBase::Utc;
+    case WSPRConfig::TimeWindow::TimeBase::LOCAL: return wspr::BandPlanner::TimeBase::Local;
+    case WSPRConfig::TimeWindow::TimeBase::SUNRISE: return wspr::BandPlanner::TimeBase::Sunrise;
+    case WSPRConfig::TimeWindow::TimeBase::SUNSET: return wspr::BandPlanner::TimeBase::Sunset;
+  }
+  return wspr::BandPlanner::TimeBase::Utc;
+}
+
+/**
+ * @brief Translate the configuration for the band planner
+ */
+inline wspr::BandPlanner::Config plannerConfig(const WSPRConfig& cfg) {
+  wspr::BandPlanner::Config c;
+  switch (cfg.mode) {
+    case WSPRConfig::Mode::MANUAL: c.mode = wspr::BandPlanner::Mode::Manual; break;
+    case WSPRConfig::Mode::RANDOM: c.mode = wspr::BandPlanner::Mode::Random; break;
+    case WSPRConfig::Mode::ROUND_ROBIN: c.mode = wspr::BandPlanner::Mode::RoundRobin; break;
+    case WSPRConfig::Mode::LIST: c.mode = wspr::BandPlanner::Mode::List; break;
+  }
+  c.slotIntervalMin = cfg.slotIntervalMin;
+  wspr::Modulation::fromName(cfg.txMode.c_str(), c.txMode);
+  c.dutyCycle = cfg.dutyCycle;
+  c.timezoneOffsetMin = cfg.timezoneOffset;
+  c.compoundCall = cfg.callsign.find('/') != std::string::npos;
+  c.longLocator = cfg.gridSquare.length() == 6;
+  c.nBands = WSPRConfig::NUM_BANDS;
+  for (int i = 0; i < WSPRConfig::NUM_BANDS; i++) {
+    const auto& b = cfg.bands[i];
+    auto& w = c.bands[i].window;
+    c.bands[i].freqHz = b.freqHz;
+    c.bands[i].enabled = b.enabled && cfg.enableBeacon;
+    w.enabled = b.timeWindow.enabled;
+    w.startBase = plannerTimeBase(b.timeWindow.startBase);
+    w.startOffsetMin = b.timeWindow.startOffsetMin;
+    w.endBase = plannerTimeBase(b.timeWindow.endBase);
+    w.endOffsetMin = b.timeWindow.endOffsetMin;
+  }
+
+  // "20m,20m,40m": repeats weight a band
+  size_t pos = 0;
+  while (pos <= cfg.bandList.size() && c.listLen < wspr::BandPlanner::maxList) {
+    size_t end = cfg.bandList.find(',', pos);
+    if (end == std::string::npos) end = cfg.bandList.size();
+    std::string name = cfg.bandList.substr(pos, end - pos);
+    int i = wspr::BandTable::fromName(name.c_str());
+    if (i >= 0) c.list[c.listLen++] = (uint8_t)i;
+    pos = end + 1;
+  }
+  return c;
+}
@@ -0,0 +1,310 @@
+/**
+ * @brief Band schedule simulator
+ *
+ * Runs the firmware's band planner and solar calculator over a date
+ * range for a config.json, as the beacon would: one compile per UTC day
+ * with that day's sun times, then every planned slot taken in turn.
+ * Reports airtime per band, stretches with no eligible band and whether
+ * the transmissions keep to the duty cycle and PA cooldown.
+ *
+ * Usage: schedsim config.json [--from YYYY-MM-DD] [--days N]
+ *                             [--grid LOCATOR | --lat DEG --lon DEG] [--seed N]
+ */
+
+#include "config_manager.hpp"
+#include "planner_config.hpp"
+#include "solarCalc.hpp"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <ctime>
+
+// Days since 1970-01-01 of a civil date
+static int64_t daysFromCivil(int y, int m, int d) {
+  y -= m <= 2;
+  int64_t era = (y >= 0 ? y : y - 399) / 400;
+  int64_t yoe = y - era * 400;
+  int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+static bool parseDate(const char* s, int64_t& day) {
+  int y, m, d;
+  char tail;
+  if (sscanf(s, "%d-%d-%d%c", &y, &m, &d, &tail) != 3) return false;
+  if (m < 1 || m > 12 || d < 1 || d > 31) return false;
+  day = daysFromCivil(y, m, d);
+  return true;
+}
+
+static std::string formatTime(int64_t unixTime) {
+  time_t t = (time_t)unixTime;
+  struct tm tm;
+  gmtime_r(&t, &tm);
+  char buf[32];
+  strftime(buf, sizeof(buf), "%Y-%m-%d %H:%MZ", &tm);
+  return buf;
+}
+
+static std::string formatDuration(int64_t minutes) {
+  std::ostringstream s;
+  if (minutes >= 1440) s << minutes / 1440 << "d ";
+  s << std::setfill('0') << std::setw(2) << minutes % 1440 / 60 << ":" << std::setw(2) << minutes % 60;
+  return s.str();
+}
+
+static const char* modeName(WSPRConfig::Mode mode) {
+  switch (mode) {
+    case WSPRConfig::Mode::MANUAL: return "manual";
+    case WSPRConfig::Mode::RANDOM: return "random";
+    case WSPRConfig::Mode::ROUND_ROBIN: return "round-robin";
+    case WSPRConfig::Mode::LIST: return "list";
+  }
+  return "";
+}
+
+static void usage() {
+  std::cerr << "Usage: schedsim config.json [--from YYYY-MM-DD] [--days N]" << std::endl
+            << "                            [--grid LOCATOR | --lat DEG --lon DEG] [--seed N]" << std::endl
+            << "  --from  First UTC day (default: 1 January of this year)" << std::endl
+            << "  --days  Number of days (default: 365)" << std::endl
+            << "  --grid  Locator for the sun times (default: gridSquare)" << std::endl
+            << "  --seed  Random mode seed (default: 0)" << std::endl;
+}
+
+struct BandStats {
+  int64_t slots = 0;
+  int64_t lastStart = -1;
+  int64_t longestGapMin = 0;	// Between transmissions, or to the range ends
+  int64_t longestGapFrom = 0;
+};
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    usage();
+    return 1;
+  }
+
+  const char* configPath = argv[1];
+  time_t nowT = time(nullptr);
+  struct tm nowTm;
+  gmtime_r(&nowT, &nowTm);
+  int64_t fromDay = daysFromCivil(nowTm.tm_year + 1900, 1, 1);
+  int64_t nDays = 365;
+  const char* grid = nullptr;
+  double lat = 0, lon = 0;
+  bool haveLat = false, haveLon = false;
+  uint32_t seed = 0;
+
+  for (int i = 2; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* val = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (!val) {
+      usage();
+      return 1;
+    }
+    if (!strcmp(arg, "--from")) {
+      if (!parseDate(val, fromDay)) {
+        std::cerr << "Bad date: " << val << std::endl;
+        return 1;
+      }
+    } else if (!strcmp(arg, "--days")) {
+      nDays = atol(val);
+      if (nDays < 1) {
+        std::cerr << "Bad day count: " << val << std::endl;
+        return 1;
+      }
+    } else if (!strcmp(arg, "--grid")) {
+      grid = val;
+    } else if (!strcmp(arg, "--lat")) {
+      lat = atof(val);
+      haveLat = true;
+    } else if (!strcmp(arg, "--lon")) {
+      lon = atof(val);
+      haveLon = true;
+    } else if (!strcmp(arg, "--seed")) {
+      seed = (uint32_t)strtoul(val, nullptr, 0);
+    } else {
+      usage();
+      return 1;
+    }
+    i++;
+  }
+  if (haveLat != haveLon) {
+    std::cerr << "--lat and --lon go together" << std::endl;
+    return 1;
+  }
+
+  std::ifstream file(configPath);
+  if (!file) {
+    std::cerr << "Cannot open " << configPath << std::endl;
+    return 1;
+  }
+  std::stringstream text;
+  text << file.rdbuf();
+  ConfigManager configMgr(nullptr);
+  if (!configMgr.fromJson(text.str())) {
+    std::cerr << "Invalid configuration: " << configPath << std::endl;
+    return 1;
+  }
+  const WSPRConfig& cfg = configMgr.getConfig();
+
+  // Station position: explicit, else the locator
+  bool located = haveLat;
+  std::string where;
+  if (!located) {
+    if (!grid) grid = cfg.gridSquare.c_str();
+    located = wspr::SolarCalc::gridToLatLon(grid, lat, lon);
+    where = std::string(grid) + " ";
+  }
+  if (!located) std::cerr << "Warning: no position from '" << grid << "'; windows on sunrise or sunset never apply" << std::endl;
+
+  auto started = std::chrono::steady_clock::now();
+
+  wspr::BandPlanner::Config pc = plannerConfig(cfg);
+  pc.seed = seed;
+  const wspr::Modulation& modulation = wspr::Modulation::get(pc.txMode);
+  const double slotAirtimeSec = modulation.airtimeSec();
+  wspr::BandPlanner planner;
+  wspr::SolarCalc solar;
+
+  const int64_t rangeStart = fromDay * 86400;
+  const int64_t rangeEnd = (fromDay + nDays) * 86400;
+  BandStats bands[WSPRConfig::NUM_BANDS];
+  int64_t total = 0;
+  int64_t minSpacingSec = -1;
+  int64_t lastStart = -1;
+  int64_t deadMin = 0, deadRun = 0, longestDead = 0, longestDeadFrom = 0;
+  int64_t polarDays = 0;
+
+  for (int64_t day = fromDay; day < fromDay + nDays; day++) {
+    const int64_t dayStart = day * 86400;
+    const int64_t dayEnd = dayStart + 86400;
+
+    wspr::BandPlanner::SunTimes sun;
+    if (located) {
+      const auto& d = solar.get(dayStart, lat, lon);
+      sun.known = true;
+      sun.sunriseMin = d.sunriseMin;
+      sun.sunsetMin = d.sunsetMin;
+      sun.daylightMin = d.daylightMin;
+      if (d.sky != wspr::SolarCalc::Sky::Normal) polarDays++;
+    }
+    planner.compile(pc, sun);
+
+    // Minutes a slot could not start on any band
+    for (int m = 0; m < wspr::BandPlanner::minutesPerDay; m++) {
+      if (planner.eligible(m)) {
+        deadRun = 0;
+        continue;
+      }
+      deadMin++;
+      if (++deadRun > longestDead) {
+        longestDead = deadRun;
+        longestDeadFrom = dayStart + (int64_t)(m + 1 - deadRun) * 60;
+      }
+    }
+
+    int64_t t = dayStart;
+    while (t < dayEnd) {
+      planner.refill(t);
+      wspr::BandPlanner::Slot slots[wspr::BandPlanner::maxPlan];
+      int n = planner.upcoming(slots, wspr::BandPlanner::maxPlan);
+      if (n == 0) break;
+
+      for (int i = 0; i < n && slots[i].startUnix < dayEnd; i++) {
+        wspr::BandPlanner::Slot s;
+        planner.take(slots[i].startUnix, s);
+        BandStats& b = bands[s.band];
+        int64_t since = b.lastStart < 0 ? rangeStart : b.lastStart;
+        if ((s.startUnix - since) / 60 > b.longestGapMin) {
+          b.longestGapMin = (s.startUnix - since) / 60;
+          b.longestGapFrom = since;
+        }
+        b.lastStart = s.startUnix;
+        b.slots++;
+
+        if (lastStart >= 0 && (minSpacingSec < 0 || s.startUnix - lastStart < minSpacingSec)) {
+          minSpacingSec = s.startUnix - lastStart;
+        }
+        lastStart = s.startUnix;
+        total++;
+      }
+      t = slots[n - 1].startUnix + 60;
+    }
+  }
+  for (BandStats& b : bands) {
+    int64_t since = b.lastStart < 0 ? rangeStart : b.lastStart;
+    if ((rangeEnd - since) / 60 > b.longestGapMin) {
+      b.longestGapMin = (rangeEnd - since) / 60;
+      b.longestGapFrom = since;
+    }
+  }
+
+  double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+
+  // Report
+  const double rangeSec = (double)(rangeEnd - rangeStart);
+  std::cout << std::fixed;
+  std::cout << "Schedule for " << cfg.callsign << ", " << formatTime(rangeStart).substr(0, 10)
+            << " for " << nDays << " day" << (nDays == 1 ? "" : "s") << std::endl;
+  if (located) {
+    std::cout << "Position " << where << std::setprecision(3) << lat << ", " << lon
+              << (polarDays ? " (" + std::to_string(polarDays) + " polar days)" : "") << std::endl;
+  }
+  std::cout << "Mode " << modeName(cfg.mode) << ", " << modulation.name << ", every " << planner.interval()
+            << " min, 1 in " << (cfg.dutyCycle ? cfg.dutyCycle : 1) << " slots" << std::endl;
+  if (!cfg.enableBeacon) std::cout << "Beacon disabled: nothing is planned" << std::endl;
+  else if (cfg.mode == WSPRConfig::Mode::MANUAL) std::cout << "Manual mode: nothing is planned" << std::endl;
+  std::cout << std::endl;
+
+  std::cout << "Band   Slots   Airtime h  Share  Of time  Longest gap" << std::endl;
+  for (int i = 0; i < WSPRConfig::NUM_BANDS; i++) {
+    const BandStats& b = bands[i];
+    if (!cfg.bands[i].enabled && !b.slots) continue;
+    double airtime = b.slots * slotAirtimeSec;
+    std::cout << std::left << std::setw(5) << wspr::BandTable::get(i).name << std::right
+              << std::setw(7) << b.slots
+              << std::setw(12) << std::setprecision(1) << airtime / 3600
+              << std::setw(6) << std::setprecision(0) << (total ? 100.0 * b.slots / total : 0) << "%"
+              << std::setw(8) << std::setprecision(2) << 100.0 * airtime / rangeSec << "%"
+              << "  " << formatDuration(b.longestGapMin);
+    if (b.slots) std::cout << " from " << formatTime(b.longestGapFrom);
+    else std::cout << " (never)";
+    std::cout << std::endl;
+  }
+  std::cout << "Total" << std::setw(7) << total
+            << std::setw(12) << std::setprecision(1) << total * slotAirtimeSec / 3600
+            << std::setw(16) << std::setprecision(2) << 100.0 * total * slotAirtimeSec / rangeSec << "%" << std::endl;
+  std::cout << std::endl;
+
+  std::cout << "No eligible band: " << std::setprecision(1) << deadMin / 60.0 << " h ("
+            << std::setprecision(1) << 100.0 * deadMin * 60 / rangeSec << "%)";
+  if (longestDead) std::cout << ", longest " << formatDuration(longestDead) << " from " << formatTime(longestDeadFrom);
+  std::cout << std::endl;
+
+  // The planner transmits on 1 in dutyCycle slots; the PA wants its
+  // cooldown after each transmission
+  int dutyCycle = cfg.dutyCycle ? cfg.dutyCycle : 1;
+  int64_t minAllowedSec = (int64_t)planner.interval() * 60 * dutyCycle;
+  double limitPct = 100.0 * slotAirtimeSec / minAllowedSec;
+  double actualPct = 100.0 * total * slotAirtimeSec / rangeSec;
+  bool dutyOk = minSpacingSec < 0 || minSpacingSec >= minAllowedSec;
+  bool cooldownOk = minSpacingSec < 0 || minSpacingSec >= (int64_t)(slotAirtimeSec + 0.5) + cfg.cooldownSec;
+  std::cout << "Duty cycle: " << std::setprecision(2) << actualPct << "% of the time, limit "
+            << limitPct << "%; closest transmissions "
+            << (minSpacingSec < 0 ? std::string("n/a") : std::to_string(minSpacingSec / 60) + " min")
+            << " apart (" << (dutyOk ? "OK" : "VIOLATED") << ")" << std::endl;
+  std::cout << "PA cooldown " << cfg.cooldownSec << " s: " << (cooldownOk ? "OK" : "VIOLATED") << std::endl;
+  std::cout << std::endl;
+  std::cout << "Simulated " << nDays * wspr::BandPlanner::minutesPerDay / planner.interval()
+            << " slots in " << std::setprecision(1) << elapsedMs << " ms" << std::endl;
+
+  return dutyOk && cooldownOk ? 0 : 2;
+}
@@ -61,6 +61,11 @@ echo ""
 test_endpoint "GET" "/api/config" "200" "Get configuration"
 test_endpoint "GET" "/api/config/export" "200" "Export configuration"
 test_endpoint "POST" "/api/config/reset" "200" "Reset configuration"
+test_endpoint "PUT" "/api/config" "200" "Update configuration" '{"callsign": "DL1ABC", "slotIntervalMin": 4}'
+test_endpoint "PUT" "/api/config" "400" "Reject malformed configuration" '{"callsign": 42}'
+test_endpoint "PUT" "/api/config" "200" "Select WSPR-2" '{"txMode": "wspr2"}'
+test_endpoint "PUT" "/api/config" "400" "Reject an unknown mode" '{"txMode": "ft8"}'
+test_endpoint "POST" "/api/config/reset" "200" "Reset configuration again"
 
 # Status test
 test_endpoint "GET" "/api/status" "200" "Get system status"
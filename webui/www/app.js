@@ -86,6 +86,12 @@ function updateConfigUI(config) {
   document.getElementById('power').value = config.powerDbm;
   document.getElementById('mode').value = config.mode;
   document.getElementById('interval').value = config.slotIntervalMin;
+  // Only the modes the firmware can send
+  const txModes = config.txModes || ['wspr2'];
+  document.querySelectorAll('#tx-mode option').forEach(o => {
+    o.hidden = o.disabled = !txModes.includes(o.value);
+  });
+  document.getElementById('tx-mode').value = config.txMode || 'wspr2';
   document.getElementById('band-list-input').value = config.bandList || '';
 
   // Show/hide band list input based on mode
@@ -125,7 +131,7 @@ document.getElementById('mode').addEventListener('change', () => {
 });
 
 // Mark dirty on config field changes
-['callsign', 'grid', 'power', 'interval', 'band-list-input'].forEach(id => {
+['callsign', 'grid', 'power', 'tx-mode', 'interval', 'band-list-input'].forEach(id => {
   document.getElementById(id).addEventListener('change', markDirty);
   document.getElementById(id).addEventListener('input', markDirty);
 });
@@ -201,6 +207,7 @@ function gatherConfigFromUI() {
     mode: document.getElementById('mode').value,
     bandList: document.getElementById('band-list-input').value,
     slotIntervalMin: parseInt(document.getElementById('interval').value),
+    txMode: document.getElementById('tx-mode').value,
   };
 
   // Update band enables and time windows